@@ -7,13 +7,16 @@ if (WITH_CN_GPU AND CMAKE_SIZEOF_VOID_P EQUAL 8)
             set_source_files_properties(src/crypto/cn/gpu/cn_gpu_arm.cpp PROPERTIES COMPILE_FLAGS "-O3")
         endif()
     else()
-        set(CN_GPU_SOURCES src/crypto/cn/gpu/cn_gpu_avx.cpp src/crypto/cn/gpu/cn_gpu_ssse3.cpp)
+        set(CN_GPU_SOURCES src/crypto/cn/gpu/cn_gpu_avx.cpp src/crypto/cn/gpu/cn_gpu_avx512.cpp src/crypto/cn/gpu/cn_gpu_ssse3.cpp)
 
         if (CMAKE_CXX_COMPILER_ID MATCHES GNU OR CMAKE_CXX_COMPILER_ID MATCHES Clang)
             set_source_files_properties(src/crypto/cn/gpu/cn_gpu_avx.cpp PROPERTIES COMPILE_FLAGS "-O3 -mavx2")
+            # GCC 12 avx512fintrin.h seeds unmasked intrinsics with _mm512_undefined_*() and warns about it
+            set_source_files_properties(src/crypto/cn/gpu/cn_gpu_avx512.cpp PROPERTIES COMPILE_FLAGS "-O3 -mavx512f -Wno-uninitialized")
             set_source_files_properties(src/crypto/cn/gpu/cn_gpu_ssse3.cpp PROPERTIES COMPILE_FLAGS "-O3")
         elseif (CMAKE_CXX_COMPILER_ID MATCHES MSVC)
             set_source_files_properties(src/crypto/cn/gpu/cn_gpu_avx.cpp PROPERTIES COMPILE_FLAGS "/arch:AVX")
+            set_source_files_properties(src/crypto/cn/gpu/cn_gpu_avx512.cpp PROPERTIES COMPILE_FLAGS "/arch:AVX512")
         endif()
     endif()
 
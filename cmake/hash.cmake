@@ -0,0 +1,26 @@
+if (WITH_HASH_LIB)
+    set(HASH_SOURCES
+        src/hash/xlarig_hash.h
+        src/hash/xlarig_hash.cpp
+        src/base/io/log/Log.cpp
+        src/common/cpu/CpuTopology.cpp
+        src/common/crypto/keccak.cpp
+        src/Mem.cpp
+        )
+
+    if (WIN32)
+        set(HASH_SOURCES ${HASH_SOURCES} src/Mem_win.cpp src/crypto/common/VirtualMemory_win.cpp)
+    else()
+        set(HASH_SOURCES ${HASH_SOURCES} src/Mem_unix.cpp src/crypto/common/VirtualMemory_unix.cpp)
+    endif()
+
+    if (XMRIG_ASM_LIBRARY)
+        set(HASH_SOURCES ${HASH_SOURCES} src/crypto/cn/Asm.cpp src/crypto/cn/r/CnrCodeCache.cpp src/crypto/cn/r/CryptonightR_gen.cpp)
+    endif()
+
+    add_library(xlarig-hash STATIC ${HASH_SOURCES} ${SOURCES_CPUID} ${SOURCES_CRYPTO} ${CN_GPU_SOURCES} ${KECCAK_SOURCES})
+    target_link_libraries(xlarig-hash ${XMRIG_ASM_LIBRARY} ${RANDOMX_LIBRARIES} ${UV_LIBRARIES} ${CPUID_LIB} ${EXTRA_LIBS})
+
+    add_executable(xlarig-hash-bench src/hash/bench.cpp)
+    target_link_libraries(xlarig-hash-bench xlarig-hash)
+endif()
@@ -0,0 +1,15 @@
+if (NOT XMRIG_ARM)
+    set(KECCAK_SOURCES src/common/crypto/keccak_lanes.h src/common/crypto/keccak_avx2.cpp src/common/crypto/keccak_avx512.cpp)
+
+    if (CMAKE_CXX_COMPILER_ID MATCHES GNU OR CMAKE_CXX_COMPILER_ID MATCHES Clang)
+        set_source_files_properties(src/common/crypto/keccak_avx2.cpp   PROPERTIES COMPILE_FLAGS "-mavx2")
+        set_source_files_properties(src/common/crypto/keccak_avx512.cpp PROPERTIES COMPILE_FLAGS "-mavx512f")
+    elseif (CMAKE_CXX_COMPILER_ID MATCHES MSVC)
+        set_source_files_properties(src/common/crypto/keccak_avx2.cpp   PROPERTIES COMPILE_FLAGS "/arch:AVX2")
+        set_source_files_properties(src/common/crypto/keccak_avx512.cpp PROPERTIES COMPILE_FLAGS "/arch:AVX512")
+    endif()
+
+    add_definitions(/DXMRIG_FEATURE_KECCAK_LANES)
+else()
+    set(KECCAK_SOURCES "")
+endif()
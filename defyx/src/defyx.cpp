@@ -158,6 +158,10 @@ extern "C" {
 	}
 
 	defyx_vm *defyx_create_vm(defyx_flags flags, defyx_cache *cache, defyx_dataset *dataset) {
+		return defyx_create_vm_scratchpad(flags, cache, dataset, nullptr);
+	}
+
+	defyx_vm *defyx_create_vm_scratchpad(defyx_flags flags, defyx_cache *cache, defyx_dataset *dataset, void *scratchpad) {
 		assert(cache != nullptr || (flags & RANDOMX_FLAG_FULL_MEM));
 		assert(cache == nullptr || cache->isInitialized());
 		assert(dataset != nullptr || !(flags & RANDOMX_FLAG_FULL_MEM));
@@ -240,7 +244,7 @@ extern "C" {
 			if(dataset != nullptr)
 				vm->setDataset(dataset);
 
-			vm->allocate();
+			vm->allocate(scratchpad);
 		}
 		catch (std::exception &ex) {
 			delete vm;
@@ -268,9 +272,14 @@ extern "C" {
 	}
 
 	void defyx_calculate_hash(defyx_vm *machine, const void *input, size_t inputSize, void *output) {
+		defyx_calculate_hash_cancellable(machine, input, inputSize, output, [](void *) { return 0; }, nullptr);
+	}
+
+	int defyx_calculate_hash_cancellable(defyx_vm *machine, const void *input, size_t inputSize, void *output, defyx_cancel_fn *cancel, void *arg) {
 		assert(machine != nullptr);
 		assert(inputSize == 0 || input != nullptr);
 		assert(output != nullptr);
+		assert(cancel != nullptr);
 		alignas(16) uint64_t tempHash[8];
 		int blakeResult = blake2b(tempHash, sizeof(tempHash), input, inputSize, nullptr, 0);
 		int yescryptRH = sipesh(tempHash, sizeof(tempHash), input, inputSize, input, inputSize, 0, 0);
@@ -282,9 +291,13 @@ extern "C" {
 			machine->run(&tempHash);
 			blakeResult = blake2b(tempHash, sizeof(tempHash), machine->getRegisterFile(), sizeof(defyx::RegisterFile), nullptr, 0);
 			assert(blakeResult == 0);
+			if (cancel(arg)) {
+				return 0;
+			}
 		}
 		machine->run(&tempHash);
 		machine->getFinalResult(output, RANDOMX_HASH_SIZE);
+		return 1;
 	}
 
 }
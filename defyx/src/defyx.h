@@ -49,6 +49,7 @@ typedef enum {
 typedef struct defyx_dataset defyx_dataset;
 typedef struct defyx_cache defyx_cache;
 typedef struct defyx_vm defyx_vm;
+typedef int defyx_cancel_fn(void *arg);
 
 #if defined(__cplusplus)
 extern "C" {
@@ -157,6 +158,15 @@ RANDOMX_EXPORT void defyx_release_dataset(defyx_dataset *dataset);
 */
 RANDOMX_EXPORT defyx_vm *defyx_create_vm(defyx_flags flags, defyx_cache *cache, defyx_dataset *dataset);
 
+/**
+ * Same as defyx_create_vm, but the virtual machine uses caller owned scratchpad memory
+ * instead of allocating its own. RANDOMX_FLAG_LARGE_PAGES has no effect on the scratchpad then.
+ *
+ * @param scratchpad is a pointer to at least RANDOMX_SCRATCHPAD_L3 bytes aligned to 64 bytes,
+ *        it must stay valid until the virtual machine is destroyed. NULL allocates as defyx_create_vm does.
+*/
+RANDOMX_EXPORT defyx_vm *defyx_create_vm_scratchpad(defyx_flags flags, defyx_cache *cache, defyx_dataset *dataset, void *scratchpad);
+
 /**
  * Reinitializes a virtual machine with a new Cache. This function should be called anytime
  * the Cache is reinitialized with a new key.
@@ -194,6 +204,22 @@ RANDOMX_EXPORT void defyx_destroy_vm(defyx_vm *machine);
 */
 RANDOMX_EXPORT void defyx_calculate_hash(defyx_vm *machine, const void *input, size_t inputSize, void *output);
 
+/**
+ * Calculates a DefyX hash value, giving up early if the work is no longer needed.
+ *
+ * @param machine is a pointer to a defyx_vm structure. Must not be NULL.
+ * @param input is a pointer to memory to be hashed. Must not be NULL.
+ * @param inputSize is the number of bytes to be hashed.
+ * @param output is a pointer to memory where the hash will be stored. Must not
+ *        be NULL and at least RANDOMX_HASH_SIZE bytes must be available for writing.
+ * @param cancel is called with arg before each chained program after the first one,
+ *        a non-zero return value stops the calculation. Must not be NULL.
+ * @param arg is passed to cancel unchanged.
+ *
+ * @return 1 if the hash was calculated, 0 if it was cancelled and output was not written.
+*/
+RANDOMX_EXPORT int defyx_calculate_hash_cancellable(defyx_vm *machine, const void *input, size_t inputSize, void *output, defyx_cancel_fn *cancel, void *arg);
+
 #if defined(__cplusplus)
 }
 #endif
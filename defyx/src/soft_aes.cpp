@@ -327,7 +327,7 @@ alignas(16) const uint32_t lutDec3[256] = {
 	0x397101a8, 0x08deb30c, 0xd89ce4b4, 0x6490c156, 0x7b6184cb, 0xd570b632, 0x48745c6c, 0xd04257b8,
 };
 
-rx_vec_i128 soft_aesenc(rx_vec_i128 in, rx_vec_i128 key) {
+static rx_vec_i128 soft_aesenc_table(rx_vec_i128 in, rx_vec_i128 key) {
 	uint32_t s0, s1, s2, s3;
 
 	s0 = rx_vec_i128_w(in);
@@ -345,7 +345,7 @@ rx_vec_i128 soft_aesenc(rx_vec_i128 in, rx_vec_i128 key) {
 	return rx_xor_vec_i128(out, key);
 }
 
-rx_vec_i128 soft_aesdec(rx_vec_i128 in, rx_vec_i128 key) {
+static rx_vec_i128 soft_aesdec_table(rx_vec_i128 in, rx_vec_i128 key) {
 	uint32_t s0, s1, s2, s3;
 
 	s0 = rx_vec_i128_w(in);
@@ -362,3 +362,113 @@ rx_vec_i128 soft_aesdec(rx_vec_i128 in, rx_vec_i128 key) {
 
 	return rx_xor_vec_i128(out, key);
 }
+
+#if defined(__SSE2__)
+
+#if defined(__GNUC__)
+#define VPERM_TARGET __attribute__((target("ssse3")))
+#else
+#define VPERM_TARGET
+#endif
+
+/*
+	Table-free software AES using the vector permutation technique by M. Hamburg.
+	The S-box is evaluated as an inversion in GF(2^4)^2 where every step is a 16-entry
+	pshufb lookup, so no memory access depends on the data being hashed.
+	Only these functions are built for SSSE3, they are used when the CPU reports it.
+*/
+
+static VPERM_TARGET inline __m128i vperm_sub_bytes(__m128i x, __m128i inLo, __m128i inHi, __m128i outU, __m128i outT) {
+	const __m128i mask = _mm_set1_epi8(0x0F);
+	const __m128i inv = _mm_set_epi64x(0x040703090A0B0C02, 0x0E05060F0D080180);
+	const __m128i inva = _mm_set_epi64x(0x030D0E0C02050809, 0x01040A060F0B0780);
+
+	x = _mm_xor_si128(_mm_shuffle_epi8(inLo, _mm_and_si128(x, mask)), _mm_shuffle_epi8(inHi, _mm_and_si128(_mm_srli_epi32(x, 4), mask)));
+
+	const __m128i i = _mm_and_si128(_mm_srli_epi32(x, 4), mask);
+	const __m128i k = _mm_and_si128(x, mask);
+	const __m128i j = _mm_xor_si128(i, k);
+	const __m128i ak = _mm_shuffle_epi8(inva, k);
+	const __m128i iak = _mm_xor_si128(_mm_shuffle_epi8(inv, i), ak);
+	const __m128i jak = _mm_xor_si128(_mm_shuffle_epi8(inv, j), ak);
+	const __m128i io = _mm_xor_si128(_mm_shuffle_epi8(inv, iak), j);
+	const __m128i jo = _mm_xor_si128(_mm_shuffle_epi8(inv, jak), i);
+
+	return _mm_xor_si128(_mm_shuffle_epi8(outU, io), _mm_shuffle_epi8(outT, jo));
+}
+
+static VPERM_TARGET inline __m128i vperm_xtime(__m128i x) {
+	const __m128i carry = _mm_and_si128(_mm_cmplt_epi8(x, _mm_setzero_si128()), _mm_set1_epi8(0x1B));
+	return _mm_xor_si128(_mm_add_epi8(x, x), carry);
+}
+
+static VPERM_TARGET inline __m128i vperm_mix_columns(__m128i s) {
+	const __m128i r1 = _mm_shuffle_epi8(s, _mm_setr_epi8(1, 2, 3, 0, 5, 6, 7, 4, 9, 10, 11, 8, 13, 14, 15, 12));
+	const __m128i r2 = _mm_shuffle_epi8(s, _mm_setr_epi8(2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13));
+	const __m128i r3 = _mm_shuffle_epi8(s, _mm_setr_epi8(3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14));
+
+	//2*a0 ^ 3*a1 ^ a2 ^ a3 == xtime(a0 ^ a1) ^ a1 ^ a2 ^ a3
+	return _mm_xor_si128(_mm_xor_si128(vperm_xtime(_mm_xor_si128(s, r1)), r1), _mm_xor_si128(r2, r3));
+}
+
+static VPERM_TARGET rx_vec_i128 soft_aesenc_vperm(rx_vec_i128 in, rx_vec_i128 key) {
+	const __m128i iptLo = _mm_set_epi64x(0xCABAE09052227808, 0xC2B2E8985A2A7000);
+	const __m128i iptHi = _mm_set_epi64x(0xCD80B1FCB0FDCC81, 0x4C01307D317C4D00);
+	const __m128i sbou = _mm_set_epi64x(0x15AABF7AC502A878, 0xD0D26D176FBDC700);
+	const __m128i sbot = _mm_set_epi64x(0x8E1E90D1412B35FA, 0xCFE474A55FBB6A00);
+
+	//ShiftRows commutes with SubBytes, so it is applied first
+	__m128i s = _mm_shuffle_epi8(in, _mm_setr_epi8(0, 5, 10, 15, 4, 9, 14, 3, 8, 13, 2, 7, 12, 1, 6, 11));
+	s = _mm_xor_si128(vperm_sub_bytes(s, iptLo, iptHi, sbou, sbot), _mm_set1_epi8(0x63));
+
+	return _mm_xor_si128(vperm_mix_columns(s), key);
+}
+
+static VPERM_TARGET rx_vec_i128 soft_aesdec_vperm(rx_vec_i128 in, rx_vec_i128 key) {
+	//inverse affine transform folded into the change of basis
+	const __m128i diptLo = _mm_set_epi64x(0xFDA2A9F6F9A6ADF2, 0xE7B8B3ECE3BCB7E8);
+	const __m128i diptHi = _mm_set_epi64x(0x12771772F491F194, 0x86E383E660056500);
+	const __m128i dsbou = _mm_set_epi64x(0xC7AA6DB9D4943E2D, 0x1387EA537EF94000);
+	const __m128i dsbot = _mm_set_epi64x(0xCA4B8159D8C58E9C, 0x12D7560F93441D00);
+
+	__m128i s = _mm_shuffle_epi8(in, _mm_setr_epi8(0, 13, 10, 7, 4, 1, 14, 11, 8, 5, 2, 15, 12, 9, 6, 3));
+	s = vperm_sub_bytes(s, diptLo, diptHi, dsbou, dsbot);
+
+	//InvMixColumns == MixColumns after a0 ^= 4*(a0 ^ a2), a1 ^= 4*(a1 ^ a3)
+	const __m128i u = vperm_xtime(vperm_xtime(_mm_xor_si128(s, _mm_shuffle_epi8(s, _mm_setr_epi8(2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13)))));
+
+	return _mm_xor_si128(vperm_mix_columns(_mm_xor_si128(s, u)), key);
+}
+
+static bool hasSsse3() {
+#if defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 1);
+	return (info[2] & (1 << 9)) != 0;
+#else
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("ssse3");
+#endif
+}
+
+static const bool useVperm = hasSsse3();
+
+rx_vec_i128 soft_aesenc(rx_vec_i128 in, rx_vec_i128 key) {
+	return useVperm ? soft_aesenc_vperm(in, key) : soft_aesenc_table(in, key);
+}
+
+rx_vec_i128 soft_aesdec(rx_vec_i128 in, rx_vec_i128 key) {
+	return useVperm ? soft_aesdec_vperm(in, key) : soft_aesdec_table(in, key);
+}
+
+#else
+
+rx_vec_i128 soft_aesenc(rx_vec_i128 in, rx_vec_i128 key) {
+	return soft_aesenc_table(in, key);
+}
+
+rx_vec_i128 soft_aesdec(rx_vec_i128 in, rx_vec_i128 key) {
+	return soft_aesdec_table(in, key);
+}
+
+#endif
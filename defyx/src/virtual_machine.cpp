@@ -99,11 +99,12 @@ namespace defyx {
 
 	template<class Allocator, bool softAes>
 	VmBase<Allocator, softAes>::~VmBase() {
-		Allocator::freeMemory(scratchpad, ScratchpadSize);
+		if (ownScratchpad)
+			Allocator::freeMemory(scratchpad, ScratchpadSize);
 	}
 
 	template<class Allocator, bool softAes>
-	void VmBase<Allocator, softAes>::allocate() {
+	void VmBase<Allocator, softAes>::allocate(void* externalScratchpad) {
 		if (datasetPtr == nullptr)
 			throw std::invalid_argument("Cache/Dataset not set");
 		if (!softAes) { //if hardware AES is not supported, it's better to fail now than to return a ticking bomb
@@ -111,6 +112,11 @@ namespace defyx {
 			tmp = rx_aesenc_vec_i128(tmp, tmp);
 			rx_store_vec_i128((rx_vec_i128*)&aesDummy, tmp);
 		}
+		if (externalScratchpad != nullptr) {
+			scratchpad = (uint8_t*)externalScratchpad;
+			ownScratchpad = false;
+			return;
+		}
 		scratchpad = (uint8_t*)Allocator::allocMemory(ScratchpadSize);
 	}
 
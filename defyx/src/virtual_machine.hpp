@@ -36,7 +36,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 class defyx_vm {
 public:
 	virtual ~defyx_vm() = 0;
-	virtual void allocate() = 0;
+	virtual void allocate(void* externalScratchpad = nullptr) = 0;
 	virtual void getFinalResult(void* out, size_t outSize) = 0;
 	virtual void setDataset(defyx_dataset* dataset) { }
 	virtual void setCache(defyx_cache* cache) { }
@@ -60,6 +60,7 @@ protected:
 	alignas(16) defyx::ProgramConfiguration config;
 	defyx::MemoryRegisters mem;
 	uint8_t* scratchpad;
+	bool ownScratchpad = true;
 	union {
 		defyx_cache* cachePtr = nullptr;
 		defyx_dataset* datasetPtr;
@@ -73,7 +74,7 @@ namespace defyx {
 	class VmBase : public defyx_vm {
 	public:
 		~VmBase() override;
-		void allocate() override;
+		void allocate(void* externalScratchpad = nullptr) override;
 		void initScratchpad(void* seed) override;
 		void getFinalResult(void* out, size_t outSize) override;
 	protected:
@@ -89,6 +89,7 @@ int xlarig::App::exec()
 
     Workers::start(m_controller);
 
+    m_controller->addListener(this);
     m_controller->start();
 
     const int r = uv_run(uv_default_loop(), UV_RUN_DEFAULT);
@@ -98,6 +99,12 @@ int xlarig::App::exec()
 }
 
 
+void xlarig::App::onConfigChanged(Config *config, Config *previousConfig)
+{
+    Workers::reconfigure(config->threads(), previousConfig->releaseThreads());
+}
+
+
 void xlarig::App::onConsoleCommand(char command)
 {
     switch (command) {
@@ -27,6 +27,7 @@
 #define XMRIG_APP_H
 
 
+#include "base/kernel/interfaces/IBaseListener.h"
 #include "base/kernel/interfaces/IConsoleListener.h"
 #include "base/kernel/interfaces/ISignalListener.h"
 
@@ -41,7 +42,7 @@ class Process;
 class Signals;
 
 
-class App : public IConsoleListener, public ISignalListener
+class App : public IBaseListener, public IConsoleListener, public ISignalListener
 {
 public:
     App(Process *process);
@@ -50,6 +51,7 @@ public:
     int exec();
 
 protected:
+    void onConfigChanged(Config *config, Config *previousConfig) override;
     void onConsoleCommand(char command) override;
     void onSignal(int signum) override;
 
@@ -24,45 +24,81 @@
  */
 
 
+#include <algorithm>
 #include <limits>
 
 
 #include "crypto/cn/CryptoNight_constants.h"
 #include "crypto/cn/CryptoNight.h"
+#include "crypto/common/Algorithm.h"
 #include "crypto/common/portable/mm_malloc.h"
 #include "crypto/common/VirtualMemory.h"
 #include "Mem.h"
 
 
-bool Mem::m_enabled = true;
-int Mem::m_flags    = 0;
+#ifndef XMRIG_NO_ASM
+#   include "crypto/cn/r/CnrCodeCache.h"
+#endif
 
 
-MemInfo Mem::create(cryptonight_ctx **ctx, xlarig::Algo algorithm, size_t count)
-{
-    using namespace xlarig;
+bool Mem::m_enabled      = true;
+int Mem::m_flags         = 0;
+size_t Mem::m_scratchpad = xlarig::CRYPTONIGHT_PICO_MEMORY;
 
-    MemInfo info;
-    info.size = cn_select_memory(algorithm) * count;
 
-    constexpr const size_t align_size = 2 * 1024 * 1024;
-    info.size  = ((info.size + align_size - 1) / align_size) * align_size;
-    info.pages = info.size / align_size;
+/**
+ * Carves per lane scratchpads out of an existing arena, returns false if the arena is too small for them.
+ */
+bool Mem::carve(cryptonight_ctx **ctx, MemInfo &info, size_t scratchpad, size_t count)
+{
+    if (scratchpad == 0 || scratchpad * count > info.size) {
+        return false;
+    }
 
-    allocate(info, m_enabled);
+    if (info.scratchpad == scratchpad) {
+        return true;
+    }
 
     for (size_t i = 0; i < count; ++i) {
-        cryptonight_ctx *c = static_cast<cryptonight_ctx *>(_mm_malloc(sizeof(cryptonight_ctx), 4096));
-        c->memory          = info.memory + (i * cn_select_memory(algorithm));
+        ctx[i]->memory = info.memory + (i * scratchpad);
+    }
 
-        c->generated_code              = reinterpret_cast<cn_mainloop_fun_ms_abi>(xlarig::VirtualMemory::allocateExecutableMemory(0x4000));
-        c->generated_code_data.variant = xlarig::VARIANT_MAX;
-        c->generated_code_data.height  = std::numeric_limits<uint64_t>::max();
+    info.scratchpad = scratchpad;
 
-        ctx[i] = c;
+    return true;
+}
+
+
+/**
+ * Per thread arena big enough for every algorithm passed to reserve(), lanes are assigned later with carve().
+ */
+MemInfo Mem::create(cryptonight_ctx **ctx, size_t count)
+{
+    return createArena(ctx, m_scratchpad * count, m_scratchpad, count);
+}
+
+
+MemInfo Mem::create(cryptonight_ctx **ctx, xlarig::Algo algorithm, size_t count)
+{
+    const size_t scratchpad = xlarig::cn_select_memory(algorithm);
+
+    return createArena(ctx, scratchpad * count, scratchpad, count);
+}
+
+
+size_t Mem::scratchpad(const xlarig::Algorithm &algorithm)
+{
+    if (algorithm.algo() == xlarig::INVALID_ALGO) {
+        return 0;
     }
 
-    return info;
+    return xlarig::cn_select_memory(algorithm.algo(), algorithm.variant());
+}
+
+
+void Mem::reserve(const xlarig::Algorithm &algorithm)
+{
+    m_scratchpad = std::max(m_scratchpad, scratchpad(algorithm));
 }
 
 
@@ -75,7 +111,44 @@ void Mem::release(cryptonight_ctx **ctx, size_t count, MemInfo &info)
     release(info);
 
     for (size_t i = 0; i < count; ++i) {
+#       ifndef XMRIG_NO_ASM
+        xlarig::CnrCodeCache::release(ctx[i]);
+#       endif
+
+        if (ctx[i]->generated_code_buffer) {
+            xlarig::VirtualMemory::freeExecutableMemory(ctx[i]->generated_code_buffer, CN_GENERATED_CODE_SIZE);
+        }
+
         _mm_free(ctx[i]);
     }
 }
 
+
+MemInfo Mem::createArena(cryptonight_ctx **ctx, size_t size, size_t scratchpad, size_t count)
+{
+    using namespace xlarig;
+
+    MemInfo info;
+
+    constexpr const size_t align_size = 2 * 1024 * 1024;
+    info.size  = ((size + align_size - 1) / align_size) * align_size;
+    info.pages = info.size / align_size;
+
+    allocate(info, m_enabled);
+
+    for (size_t i = 0; i < count; ++i) {
+        cryptonight_ctx *c = static_cast<cryptonight_ctx *>(_mm_malloc(sizeof(cryptonight_ctx), 4096));
+        c->memory          = info.memory + (i * scratchpad);
+
+        c->generated_code              = nullptr;
+        c->generated_code_data.variant = xlarig::VARIANT_MAX;
+        c->generated_code_data.height  = std::numeric_limits<uint64_t>::max();
+        c->generated_code_buffer       = nullptr;
+
+        ctx[i] = c;
+    }
+
+    info.scratchpad = scratchpad;
+
+    return info;
+}
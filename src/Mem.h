@@ -34,6 +34,11 @@
 #include "common/xlarig.h"
 
 
+namespace xlarig {
+    class Algorithm;
+}
+
+
 struct cryptonight_ctx;
 
 
@@ -41,9 +46,10 @@ struct MemInfo
 {
     alignas(16) uint8_t *memory = nullptr;
 
-    size_t hugePages = 0;
-    size_t pages     = 0;
-    size_t size      = 0;
+    size_t hugePages  = 0;
+    size_t pages      = 0;
+    size_t scratchpad = 0;
+    size_t size       = 0;
 };
 
 
@@ -56,18 +62,24 @@ public:
         Lock               = 4
     };
 
+    static bool carve(cryptonight_ctx **ctx, MemInfo &info, size_t scratchpad, size_t count);
+    static MemInfo create(cryptonight_ctx **ctx, size_t count);
     static MemInfo create(cryptonight_ctx **ctx, xlarig::Algo algorithm, size_t count);
+    static size_t scratchpad(const xlarig::Algorithm &algorithm);
     static void init(bool enabled);
     static void release(cryptonight_ctx **ctx, size_t count, MemInfo &info);
+    static void reserve(const xlarig::Algorithm &algorithm);
 
     static inline bool isHugepagesAvailable() { return (m_flags & HugepagesAvailable) != 0; }
 
 private:
+    static MemInfo createArena(cryptonight_ctx **ctx, size_t size, size_t scratchpad, size_t count);
     static void allocate(MemInfo &info, bool enabled);
     static void release(MemInfo &info);
 
     static int m_flags;
     static bool m_enabled;
+    static size_t m_scratchpad;
 };
 
 
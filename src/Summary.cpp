@@ -31,6 +31,7 @@
 #include "base/io/log/Log.h"
 #include "base/net/stratum/Pool.h"
 #include "common/cpu/Cpu.h"
+#include "common/cpu/CpuTopology.h"
 #include "core/config/Config.h"
 #include "core/Controller.h"
 #include "crypto/cn/Asm.h"
@@ -68,13 +69,14 @@ static void print_cpu(xlarig::Config *)
 {
     using namespace xlarig;
 
-    Log::print(GREEN_BOLD(" * ") WHITE_BOLD("%-13s%s (%d)") " %sx64 %sAES %sAVX2",
+    Log::print(GREEN_BOLD(" * ") WHITE_BOLD("%-13s%s (%d)") " %sx64 %sAES %sAVX2 %sAVX-512",
                "CPU",
                Cpu::info()->brand(),
                Cpu::info()->sockets(),
-               Cpu::info()->isX64()   ? GREEN_BOLD_S : RED_BOLD_S "-",
-               Cpu::info()->hasAES()  ? GREEN_BOLD_S : RED_BOLD_S "-",
-               Cpu::info()->hasAVX2() ? GREEN_BOLD_S : RED_BOLD_S "-"
+               Cpu::info()->isX64()     ? GREEN_BOLD_S : RED_BOLD_S "-",
+               Cpu::info()->hasAES()    ? GREEN_BOLD_S : RED_BOLD_S "-",
+               Cpu::info()->hasAVX2()   ? GREEN_BOLD_S : RED_BOLD_S "-",
+               Cpu::info()->hasAVX512() ? GREEN_BOLD_S : RED_BOLD_S "-"
                );
 #   ifndef XMRIG_NO_LIBCPUID
     Log::print(GREEN_BOLD(" * ") WHITE_BOLD("%-13s%.1f MB/%.1f MB"), "CPU L2/L3", Cpu::info()->L2() / 1024.0, Cpu::info()->L3() / 1024.0);
@@ -110,6 +112,8 @@ static void print_threads(xlarig::Config *config)
                           );
     }
 
+    xlarig::Cpu::topology()->print(config->threads());
+
 #   ifndef XMRIG_NO_ASM
     if (config->assembly() == xlarig::ASM_AUTO) {
         const xlarig::Assembly assembly = xlarig::Cpu::info()->assembly();
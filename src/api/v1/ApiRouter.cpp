@@ -37,6 +37,7 @@
 #include "rapidjson/document.h"
 #include "version.h"
 #include "workers/Hashrate.h"
+#include "workers/PerfCounters.h"
 #include "workers/Workers.h"
 
 
@@ -52,6 +53,18 @@ static inline rapidjson::Value normalize(double d)
 }
 
 
+static inline rapidjson::Value perfValue(double d)
+{
+    using namespace rapidjson;
+
+    if (d < 0.0) {
+        return Value(kNullType);
+    }
+
+    return Value(floor(d * 100.0) / 100.0);
+}
+
+
 xlarig::ApiRouter::ApiRouter(Base *base) :
     m_base(base)
 {
@@ -157,7 +170,7 @@ void xlarig::ApiRouter::getThreads(rapidjson::Value &reply, rapidjson::Document
 
     Workers::threadsSummary(doc);
 
-    const std::vector<IThread *> &threads = m_base->config()->threads();
+    const std::vector<IThread *> threads = Workers::threadsList();
     Value list(kArrayType);
 
     size_t i = 0;
@@ -169,9 +182,21 @@ void xlarig::ApiRouter::getThreads(rapidjson::Value &reply, rapidjson::Document
         hashrate.PushBack(normalize(hr->calc(i, Hashrate::MediumInterval)), allocator);
         hashrate.PushBack(normalize(hr->calc(i, Hashrate::LargeInterval)),  allocator);
 
-        i++;
-
         value.AddMember("hashrate", hashrate, allocator);
+
+        if (PerfCounters::isEnabled()) {
+            const PerfCounters::Sample sample = Workers::perf(i);
+
+            Value perf(kObjectType);
+            perf.AddMember("ipc",         perfValue(sample.ipc),  allocator);
+            perf.AddMember("llc_misses",  perfValue(sample.llc),  allocator);
+            perf.AddMember("dtlb_misses", perfValue(sample.dtlb), allocator);
+            perf.AddMember("l2_misses",   perfValue(sample.l2),   allocator);
+
+            value.AddMember("perf", perf, allocator);
+        }
+
+        i++;
         list.PushBack(value, allocator);
     }
 
@@ -2,6 +2,8 @@ set(HEADERS_BASE
     src/base/io/Console.h
     src/base/io/json/Json.h
     src/base/io/json/JsonChain.h
+    src/base/io/json/JsonDocumentPool.h
+    src/base/io/json/JsonLineWriter.h
     src/base/io/json/JsonRequest.h
     src/base/io/log/backends/ConsoleLog.h
     src/base/io/log/backends/FileLog.h
@@ -24,6 +26,8 @@ set(HEADERS_BASE
     src/base/kernel/interfaces/ISignalListener.h
     src/base/kernel/interfaces/IStrategy.h
     src/base/kernel/interfaces/IStrategyListener.h
+    src/base/kernel/interfaces/ITcpConnectorListener.h
+    src/base/kernel/interfaces/ITcpServerListener.h
     src/base/kernel/interfaces/ITimerListener.h
     src/base/kernel/interfaces/IWatcherListener.h
     src/base/kernel/Process.h
@@ -37,15 +41,20 @@ set(HEADERS_BASE
     src/base/net/stratum/Pool.h
     src/base/net/stratum/Pools.h
     src/base/net/stratum/strategies/FailoverStrategy.h
+    src/base/net/stratum/strategies/HotStandbyStrategy.h
     src/base/net/stratum/strategies/SinglePoolStrategy.h
     src/base/net/stratum/SubmitResult.h
     src/base/net/tools/RecvBuf.h
+    src/base/net/tools/SendQueue.h
     src/base/net/tools/Storage.h
+    src/base/net/tools/TcpConnector.h
+    src/base/net/tools/TcpServer.h
     src/base/tools/Arguments.h
     src/base/tools/Baton.h
     src/base/tools/Buffer.h
     src/base/tools/Chrono.h
     src/base/tools/Handle.h
+    src/base/tools/Histogram.h
     src/base/tools/String.h
     src/base/tools/Timer.h
    )
@@ -74,9 +83,13 @@ set(SOURCES_BASE
     src/base/net/stratum/Pool.cpp
     src/base/net/stratum/Pools.cpp
     src/base/net/stratum/strategies/FailoverStrategy.cpp
+    src/base/net/stratum/strategies/HotStandbyStrategy.cpp
     src/base/net/stratum/strategies/SinglePoolStrategy.cpp
+    src/base/net/tools/TcpConnector.cpp
+    src/base/net/tools/TcpServer.cpp
     src/base/tools/Arguments.cpp
     src/base/tools/Buffer.cpp
+    src/base/tools/Histogram.cpp
     src/base/tools/String.cpp
     src/base/tools/Timer.cpp
    )
@@ -103,7 +116,7 @@ if (WITH_HTTP)
         src/3rdparty/http-parser/http_parser.h
         src/base/kernel/interfaces/IHttpListener.h
         src/base/kernel/interfaces/IJsonReader.h
-        src/base/kernel/interfaces/ITcpServerListener.h
+        src/base/kernel/interfaces/IZmqListener.h
         src/base/net/http/HttpApiResponse.h
         src/base/net/http/HttpClient.h
         src/base/net/http/HttpContext.h
@@ -111,7 +124,7 @@ if (WITH_HTTP)
         src/base/net/http/HttpResponse.h
         src/base/net/http/HttpServer.h
         src/base/net/stratum/DaemonClient.h
-        src/base/net/tools/TcpServer.h
+        src/base/net/zmq/ZmqSubscriber.h
         )
 
     set(SOURCES_BASE_HTTP
@@ -122,7 +135,7 @@ if (WITH_HTTP)
         src/base/net/http/HttpResponse.cpp
         src/base/net/http/HttpServer.cpp
         src/base/net/stratum/DaemonClient.cpp
-        src/base/net/tools/TcpServer.cpp
+        src/base/net/zmq/ZmqSubscriber.cpp
         )
 
     add_definitions(/DXMRIG_FEATURE_HTTP)
@@ -0,0 +1,76 @@
+/* XMRig and XLArig
+ * Copyright 2010      Jeff Garzik <jgarzik@pobox.com>
+ * Copyright 2012-2014 pooler      <pooler@litecoinpool.org>
+ * Copyright 2014      Lucas Jones <https://github.com/lucasjones>
+ * Copyright 2014-2016 Wolf9466    <https://github.com/OhGodAPet>
+ * Copyright 2016      Jay D Dee   <jayddee246@gmail.com>
+ * Copyright 2017-2018 XMR-Stak    <https://github.com/fireice-uk>, <https://github.com/psychocrypt>
+ * Copyright 2018-2019 SChernykh   <https://github.com/SChernykh>
+ * Copyright 2016-2019 XMRig       <https://github.com/xmrig>, <support@xmrig.com>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef XMRIG_JSONDOCUMENTPOOL_H
+#define XMRIG_JSONDOCUMENTPOOL_H
+
+
+#include "rapidjson/document.h"
+
+
+namespace xlarig {
+
+
+/**
+ * Memory for parsing one line at a time: values and the parser stack are carved from fixed
+ * buffers that are rewound with clear() before the next line, so typical stratum traffic never
+ * touches the heap. Anything larger spills over into heap chunks that clear() frees.
+ */
+template<size_t VALUES, size_t STACK>
+class JsonDocumentPool
+{
+public:
+    using Allocator = rapidjson::MemoryPoolAllocator<>;
+    using Document  = rapidjson::GenericDocument<rapidjson::UTF8<>, Allocator, Allocator>;
+
+    inline JsonDocumentPool() :
+        m_allocator(m_values, sizeof(m_values)),
+        m_stackAllocator(m_stack, sizeof(m_stack))
+    {
+    }
+
+    inline Allocator *allocator()      { return &m_allocator; }
+    inline Allocator *stackAllocator() { return &m_stackAllocator; }
+
+    inline void clear()
+    {
+        m_allocator.Clear();
+        m_stackAllocator.Clear();
+    }
+
+private:
+    JsonDocumentPool(const JsonDocumentPool &other) = delete;
+    JsonDocumentPool &operator=(const JsonDocumentPool &other) = delete;
+
+    alignas(16) char m_stack[STACK];
+    alignas(16) char m_values[VALUES];
+    Allocator m_allocator;
+    Allocator m_stackAllocator;
+};
+
+
+} /* namespace xlarig */
+
+
+#endif /* XMRIG_JSONDOCUMENTPOOL_H */
@@ -0,0 +1,158 @@
+/* XMRig and XLArig
+ * Copyright 2010      Jeff Garzik <jgarzik@pobox.com>
+ * Copyright 2012-2014 pooler      <pooler@litecoinpool.org>
+ * Copyright 2014      Lucas Jones <https://github.com/lucasjones>
+ * Copyright 2014-2016 Wolf9466    <https://github.com/OhGodAPet>
+ * Copyright 2016      Jay D Dee   <jayddee246@gmail.com>
+ * Copyright 2017-2018 XMR-Stak    <https://github.com/fireice-uk>, <https://github.com/psychocrypt>
+ * Copyright 2018-2019 SChernykh   <https://github.com/SChernykh>
+ * Copyright 2016-2019 XMRig       <https://github.com/xmrig>, <support@xmrig.com>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef XMRIG_JSONLINEWRITER_H
+#define XMRIG_JSONLINEWRITER_H
+
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+
+#include "base/tools/Buffer.h"
+
+
+namespace xlarig {
+
+
+/**
+ * Fixed format JSON-RPC request written straight into a send buffer of N bytes, for the requests
+ * sent often enough that building a rapidjson::Document for them shows up in share latency.
+ * Parameters are a flat object of strings, end() returns the line size or 0 if it didn't fit.
+ */
+template<size_t N>
+class JsonLineWriter
+{
+public:
+    inline JsonLineWriter(char *buf, int64_t id, const char *method) :
+        m_buf(buf),
+        m_first(true)
+    {
+        const int size = snprintf(m_buf, N, "{\"id\":%" PRId64 ",\"jsonrpc\":\"2.0\",\"method\":\"%s\",\"params\":{", id, method);
+        m_pos = (size > 0 && static_cast<size_t>(size) < N) ? static_cast<size_t>(size) : N;
+    }
+
+    inline void add(const char *key, const char *value)
+    {
+        if (!this->key(key)) {
+            return;
+        }
+
+        for (const char *c = value; *c; ++c) {
+            escape(static_cast<uint8_t>(*c));
+        }
+
+        put('"');
+    }
+
+    inline void addHex(const char *key, const void *data, size_t size)
+    {
+        if (!this->key(key) || m_pos + size * 2 + 1 > N) {
+            m_pos = N;
+            return;
+        }
+
+        Buffer::toHex(static_cast<const uint8_t *>(data), size, m_buf + m_pos);
+        m_pos += size * 2;
+
+        put('"');
+    }
+
+    inline size_t end()
+    {
+        put('}');
+        put('}');
+        put('\n');
+
+        if (m_pos >= N) {
+            return 0;
+        }
+
+        m_buf[m_pos] = '\0';
+
+        return m_pos;
+    }
+
+private:
+    inline bool key(const char *key)
+    {
+        if (!m_first) {
+            put(',');
+        }
+
+        m_first = false;
+        put('"');
+        write(key, strlen(key));
+        put('"');
+        put(':');
+        put('"');
+
+        return m_pos < N;
+    }
+
+    inline void escape(uint8_t c)
+    {
+        static const char hex[] = "0123456789abcdef";
+
+        if (c == '"' || c == '\\') {
+            put('\\');
+        }
+        else if (c < 0x20) {
+            const char seq[6] = { '\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xF] };
+
+            return write(seq, sizeof(seq));
+        }
+
+        put(static_cast<char>(c));
+    }
+
+    inline void put(char c)
+    {
+        if (m_pos < N) {
+            m_buf[m_pos++] = c;
+        }
+    }
+
+    inline void write(const char *data, size_t size)
+    {
+        if (m_pos + size > N) {
+            m_pos = N;
+            return;
+        }
+
+        memcpy(m_buf + m_pos, data, size);
+        m_pos += size;
+    }
+
+    char *m_buf;
+    bool m_first;
+    size_t m_pos;
+};
+
+
+} /* namespace xlarig */
+
+
+#endif /* XMRIG_JSONLINEWRITER_H */
@@ -167,6 +167,7 @@ bool xlarig::BaseConfig::read(const IJsonReader &reader, const char *fileName)
     m_pools.setProxyDonate(reader.getInt("donate-over-proxy", Pools::PROXY_DONATE_AUTO));
     m_pools.setRetries(reader.getInt("retries"));
     m_pools.setRetryPause(reader.getInt("retry-pause"));
+    m_pools.setStrategy(reader.getString("pool-strategy"));
 
     if (!m_algorithm.isValid()) {
         return false;
@@ -194,3 +195,31 @@ bool xlarig::BaseConfig::save()
 
     return false;
 }
+
+
+/**
+ * Path of a helper file (caches and such) placed next to the config file, null if config was not loaded from a file.
+ */
+xlarig::String xlarig::BaseConfig::siblingPath(const char *name) const
+{
+    if (m_fileName.isNull()) {
+        return String();
+    }
+
+    const char *fileName = m_fileName.data();
+    const char *sep      = strrchr(fileName, '/');
+
+#   ifdef _WIN32
+    const char *sep2 = strrchr(fileName, '\\');
+    if (sep2 > sep) {
+        sep = sep2;
+    }
+#   endif
+
+    const size_t dir = sep ? static_cast<size_t>(sep - fileName + 1) : 0;
+    char *path = new char[dir + strlen(name) + 1]();
+    memcpy(path, fileName, dir);
+    strcpy(path + dir, name);
+
+    return String(path);
+}
@@ -66,6 +66,7 @@ public:
     bool read(const IJsonReader &reader, const char *fileName) override;
     bool save() override;
 
+    String siblingPath(const char *name) const;
     void printVersions();
 
 protected:
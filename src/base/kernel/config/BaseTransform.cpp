@@ -156,12 +156,16 @@ void xlarig::BaseTransform::transform(rapidjson::Document &doc, int key, const c
     case IConfig::UserAgentKey: /* --user-agent */
         return set(doc, "user-agent", arg);
 
+    case IConfig::PoolStrategyKey: /* --pool-strategy */
+        return set(doc, "pool-strategy", arg);
+
     case IConfig::RetriesKey:     /* --retries */
     case IConfig::RetryPauseKey:  /* --retry-pause */
     case IConfig::PrintTimeKey:   /* --print-time */
     case IConfig::HttpPort:       /* --http-port */
     case IConfig::DonateLevelKey: /* --donate-level */
     case IConfig::DaemonPollKey:  /* --daemon-poll-interval */
+    case IConfig::DaemonZmqKey:   /* --daemon-zmq-port */
 #   ifdef XMRIG_DEPRECATED
     case IConfig::ApiPort:       /* --api-port */
 #   endif
@@ -171,7 +175,9 @@ void xlarig::BaseTransform::transform(rapidjson::Document &doc, int key, const c
     case IConfig::SyslogKey:      /* --syslog */
     case IConfig::KeepAliveKey:   /* --keepalive */
     case IConfig::NicehashKey:    /* --nicehash */
+    case IConfig::MultiAlgoKey:   /* --multi-algo */
     case IConfig::TlsKey:         /* --tls */
+    case IConfig::KtlsKey:        /* --ktls */
     case IConfig::DryRunKey:      /* --dry-run */
     case IConfig::HttpEnabledKey: /* --http-enabled */
     case IConfig::DaemonKey:      /* --daemon */
@@ -206,12 +212,18 @@ void xlarig::BaseTransform::transformBoolean(rapidjson::Document &doc, int key,
     case IConfig::TlsKey: /* --tls */
         return add(doc, kPools, "tls", enable);
 
+    case IConfig::KtlsKey: /* --ktls */
+        return add(doc, kPools, "ktls", enable);
+
     case IConfig::DaemonKey: /* --daemon */
         return add(doc, kPools, "daemon", enable);
 
 #   ifndef XMRIG_PROXY_PROJECT
     case IConfig::NicehashKey: /* --nicehash */
         return add<bool>(doc, kPools, "nicehash", enable);
+
+    case IConfig::MultiAlgoKey: /* --multi-algo */
+        return add<bool>(doc, kPools, "multi-algo", enable);
 #   endif
 
     case IConfig::ColorKey: /* --no-color */
@@ -273,6 +285,9 @@ void xlarig::BaseTransform::transformUint64(rapidjson::Document &doc, int key, u
     case IConfig::DaemonPollKey:  /* --daemon-poll-interval */
         return add(doc, kPools, "daemon-poll-interval", arg);
 
+    case IConfig::DaemonZmqKey:   /* --daemon-zmq-port */
+        return add(doc, kPools, "daemon-zmq-port", arg);
+
     default:
         break;
     }
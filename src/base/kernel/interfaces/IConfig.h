@@ -69,9 +69,13 @@ public:
         VerboseKey           = 1100,
         TlsKey               = 1013,
         FingerprintKey       = 1014,
+        KtlsKey              = 1024,
         ProxyDonateKey       = 1017,
         DaemonKey            = 1018,
         DaemonPollKey        = 1019,
+        DaemonZmqKey         = 1025,
+        MultiAlgoKey         = 1028,
+        PoolStrategyKey      = 1022,
 
 #       ifdef XMRIG_DEPRECATED
         ApiPort              = 4000,
@@ -95,6 +99,10 @@ public:
         ThreadsKey           = 't',
 //        HardwareAESKey       = 1011,
         AssemblyKey          = 1015,
+        AutotuneKey          = 1016,
+        PerfCountersKey      = 1023,
+        ProxyHostKey         = 1026,
+        ProxyPortKey         = 1027,
 
         // xlarig amd
         OclPlatformKey       = 1400,
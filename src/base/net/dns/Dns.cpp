@@ -23,24 +23,49 @@
  */
 
 
+#include <map>
+
+
 #include "base/kernel/interfaces/IDnsListener.h"
 #include "base/net/dns/Dns.h"
+#include "base/tools/Chrono.h"
 #include "base/tools/Handle.h"
+#include "base/tools/Timer.h"
 
 
 namespace xlarig {
-    Storage<Dns> Dns::m_storage;
-    static const DnsRecord defaultRecord;
-}
+
+
+/**
+ * Process-wide results of the last successful lookup per host, getaddrinfo does not expose record
+ * TTLs so entries live for Dns::kTTL and an expired entry is still used if the new lookup fails.
+ */
+class DnsCacheEntry
+{
+public:
+    std::vector<DnsRecord> ipv4;
+    std::vector<DnsRecord> ipv6;
+    uint64_t expire = 0;
+};
+
+
+Storage<Dns> Dns::m_storage;
+static const DnsRecord defaultRecord;
+static std::map<String, DnsCacheEntry> cache;
+
+
+} /* namespace xlarig */
 
 
 xlarig::Dns::Dns(IDnsListener *listener) :
     m_hints(),
     m_listener(listener),
     m_status(0),
+    m_timer(nullptr),
     m_resolver(nullptr)
 {
-    m_key = m_storage.add(this);
+    m_key   = m_storage.add(this);
+    m_timer = new Timer(this);
 
     m_resolver = new uv_getaddrinfo_t;
     m_resolver->data = m_storage.ptr(m_key);
@@ -55,6 +80,7 @@ xlarig::Dns::~Dns()
 {
     m_storage.release(m_key);
 
+    delete m_timer;
     delete m_resolver;
 }
 
@@ -67,6 +93,17 @@ bool xlarig::Dns::resolve(const String &host)
         clear();
     }
 
+    const auto it = cache.find(m_host);
+    if (it != cache.end() && it->second.expire > Chrono::steadyMSecs()) {
+        m_ipv4   = it->second.ipv4;
+        m_ipv6   = it->second.ipv6;
+        m_status = 0;
+
+        m_timer->start(0, 0);
+
+        return true;
+    }
+
     m_status = uv_getaddrinfo(uv_default_loop(), m_resolver, Dns::onResolved, m_host.data(), nullptr, &m_hints);
 
     return m_status == 0;
@@ -114,6 +151,21 @@ size_t xlarig::Dns::count(DnsRecord::Type type) const
 }
 
 
+void xlarig::Dns::expire(const String &host)
+{
+    const auto it = cache.find(host);
+    if (it != cache.end()) {
+        it->second.expire = 0;
+    }
+}
+
+
+void xlarig::Dns::onTimer(const Timer *)
+{
+    m_listener->onResolved(*this, m_status);
+}
+
+
 void xlarig::Dns::clear()
 {
     m_ipv4.clear();
@@ -126,6 +178,12 @@ void xlarig::Dns::onResolved(int status, addrinfo *res)
     m_status = status;
 
     if (m_status < 0) {
+        const auto it = cache.find(m_host);
+        if (it != cache.end()) {
+            m_ipv4 = it->second.ipv4;
+            m_ipv6 = it->second.ipv6;
+        }
+
         return m_listener->onResolved(*this, status);
     }
 
@@ -147,6 +205,12 @@ void xlarig::Dns::onResolved(int status, addrinfo *res)
     if (isEmpty()) {
         m_status = UV_EAI_NONAME;
     }
+    else {
+        DnsCacheEntry &entry = cache[m_host];
+        entry.ipv4   = m_ipv4;
+        entry.ipv6   = m_ipv6;
+        entry.expire = Chrono::steadyMSecs() + kTTL;
+    }
 
     m_listener->onResolved(*this, m_status);
 }
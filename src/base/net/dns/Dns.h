@@ -30,6 +30,7 @@
 #include <uv.h>
 
 
+#include "base/kernel/interfaces/ITimerListener.h"
 #include "base/net/dns/DnsRecord.h"
 #include "base/net/tools/Storage.h"
 #include "base/tools/String.h"
@@ -39,23 +40,33 @@ namespace xlarig {
 
 
 class IDnsListener;
+class Timer;
 
 
-class Dns
+class Dns : public ITimerListener
 {
 public:
+    constexpr static uint64_t kTTL = 60 * 1000;
+
     Dns(IDnsListener *listener);
-    ~Dns();
+    ~Dns() override;
 
-    inline bool isEmpty() const       { return m_ipv4.empty() && m_ipv6.empty(); }
-    inline const String &host() const { return m_host; }
-    inline int status() const         { return m_status; }
+    inline bool isEmpty() const                       { return m_ipv4.empty() && m_ipv6.empty(); }
+    inline const std::vector<DnsRecord> &ipv4() const { return m_ipv4; }
+    inline const std::vector<DnsRecord> &ipv6() const { return m_ipv6; }
+    inline const String &host() const                 { return m_host; }
+    inline int status() const                         { return m_status; }
 
     bool resolve(const String &host);
     const char *error() const;
     const DnsRecord &get(DnsRecord::Type prefered = DnsRecord::A) const;
     size_t count(DnsRecord::Type type = DnsRecord::Unknown) const;
 
+    static void expire(const String &host);
+
+protected:
+    void onTimer(const Timer *timer) override;
+
 private:
     void clear();
     void onResolved(int status, addrinfo *res);
@@ -68,6 +79,7 @@ private:
     std::vector<DnsRecord> m_ipv4;
     std::vector<DnsRecord> m_ipv6;
     String m_host;
+    Timer *m_timer;
     uintptr_t m_key;
     uv_getaddrinfo_t *m_resolver;
 
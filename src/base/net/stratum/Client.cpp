@@ -38,17 +38,18 @@
 
 
 #include "base/io/json/Json.h"
+#include "base/io/json/JsonLineWriter.h"
 #include "base/io/json/JsonRequest.h"
 #include "base/io/log/Log.h"
 #include "base/kernel/interfaces/IClientListener.h"
 #include "base/net/dns/Dns.h"
+#include "base/net/tools/TcpConnector.h"
 #include "base/net/stratum/Client.h"
-#include "base/tools/Buffer.h"
 #include "base/tools/Chrono.h"
+#include "base/tools/Handle.h"
 #include "net/JobResult.h"
 #include "rapidjson/document.h"
 #include "rapidjson/error/en.h"
-#include "rapidjson/stringbuffer.h"
 #include "rapidjson/writer.h"
 
 
@@ -61,6 +62,28 @@ namespace xlarig {
 
 Storage<Client> Client::m_storage;
 
+
+/**
+ * rapidjson output stream over the client send buffer, one byte is kept for the line feed.
+ */
+class SendBufStream
+{
+public:
+    using Ch = char;
+
+    inline SendBufStream(char *buf, size_t size) : m_buf(buf), m_size(size - 1) {}
+
+    inline bool isOverflow() const { return m_pos > m_size; }
+    inline size_t size() const     { return m_pos; }
+    inline void Flush()            {}
+    inline void Put(char c)        { if (m_pos < m_size) { m_buf[m_pos] = c; } m_pos++; }
+
+private:
+    char *m_buf;
+    size_t m_pos = 0;
+    size_t m_size;
+};
+
 } /* namespace xlarig */
 
 
@@ -78,23 +101,35 @@ static const char *states[] = {
 xlarig::Client::Client(int id, const char *agent, IClientListener *listener) :
     BaseClient(id, listener),
     m_agent(agent),
+    m_connector(nullptr),
     m_tls(nullptr),
     m_expire(0),
     m_jobs(0),
     m_keepAlive(0),
     m_key(0),
     m_stream(nullptr),
+    m_flush(nullptr),
     m_socket(nullptr)
 {
-    m_key = m_storage.add(this);
-    m_dns = new Dns(this);
+    m_key       = m_storage.add(this);
+    m_dns       = new Dns(this);
+    m_connector = new TcpConnector(this);
+
+    m_flush = new uv_idle_t;
+    m_flush->data = m_storage.ptr(m_key);
+    uv_idle_init(uv_default_loop(), m_flush);
+
+    m_writeReq.data = m_storage.ptr(m_key);
 }
 
 
 xlarig::Client::~Client()
 {
     delete m_dns;
+    delete m_connector;
     delete m_socket;
+
+    Handle::close(m_flush);
 }
 
 
@@ -150,36 +185,28 @@ int64_t xlarig::Client::submit(const JobResult &result)
     }
 #   endif
 
-    using namespace rapidjson;
+    JsonLineWriter<sizeof(m_sendBuf)> writer(m_sendBuf, m_sequence, "submit");
+    writer.add("id",     m_rpcId.data());
+    writer.add("job_id", result.jobId.data());
 
 #   ifdef XMRIG_PROXY_PROJECT
-    const char *nonce = result.nonce;
-    const char *data  = result.result;
+    writer.add("nonce",  result.nonce);
+    writer.add("result", result.result);
 #   else
-    char *nonce = m_sendBuf;
-    char *data  = m_sendBuf + 16;
-
-    Buffer::toHex(reinterpret_cast<const char*>(&result.nonce), 4, nonce);
-    nonce[8] = '\0';
-
-    Buffer::toHex(result.result, 32, data);
-    data[64] = '\0';
+    writer.addHex("nonce",  &result.nonce, 4);
+    writer.addHex("result", result.result, 32);
 #   endif
 
-    Document doc(kObjectType);
-    auto &allocator = doc.GetAllocator();
-
-    Value params(kObjectType);
-    params.AddMember("id",     StringRef(m_rpcId.data()), allocator);
-    params.AddMember("job_id", StringRef(result.jobId.data()), allocator);
-    params.AddMember("nonce",  StringRef(nonce), allocator);
-    params.AddMember("result", StringRef(data), allocator);
-
     if (has<EXT_ALGO>() && result.algorithm.isValid()) {
-        params.AddMember("algo", StringRef(result.algorithm.shortName()), allocator);
+        writer.add("algo", result.algorithm.shortName());
     }
 
-    JsonRequest::create(doc, m_sequence, "submit", params);
+    const size_t size = writer.end();
+    if (size == 0) {
+        LOG_ERR("[%s] send failed: \"send buffer overflow\"", url());
+        close();
+        return -1;
+    }
 
 #   ifdef XMRIG_PROXY_PROJECT
     m_results[m_sequence] = SubmitResult(m_sequence, result.diff, result.actualDiff(), result.id);
@@ -187,7 +214,7 @@ int64_t xlarig::Client::submit(const JobResult &result)
     m_results[m_sequence] = SubmitResult(m_sequence, result.diff, result.actualDiff());
 #   endif
 
-    return send(doc);
+    return send(size);
 }
 
 
@@ -257,25 +284,66 @@ void xlarig::Client::onResolved(const Dns &dns, int status)
         return reconnect();
     }
 
-    const DnsRecord &record = dns.get();
-    m_ip = record.ip();
+    setState(ConnectingState);
+
+    m_connector->connect(dns, m_pool.port());
+}
+
+
+void xlarig::Client::onConnect(uv_tcp_t *socket, const DnsRecord &record, int status)
+{
+    if (status < 0) {
+        if (status != UV_ECANCELED) {
+            if (!isQuiet()) {
+                LOG_ERR("[%s] connect error: \"%s\"", url(), uv_strerror(status));
+            }
+
+            Dns::expire(m_pool.host());
+        }
+
+        return onClose();
+    }
+
+    m_ip           = record.ip();
+    m_socket       = socket;
+    m_socket->data = m_storage.ptr(m_key);
+    m_stream       = reinterpret_cast<uv_stream_t*>(m_socket);
+
+    setState(ConnectedState);
+
+    uv_read_start(m_stream, onAllocBuffer, onRead);
 
-    connect(record.addr(m_pool.port()));
+    handshake();
 }
 
 
 bool xlarig::Client::close()
 {
     if (m_state == ClosingState) {
-        return m_socket != nullptr;
+        return m_socket != nullptr || m_connector->isActive();
     }
 
-    if (m_state == UnconnectedState || m_socket == nullptr) {
+    if (m_state == UnconnectedState) {
         return false;
     }
 
+    if (m_socket == nullptr) {
+        if (!m_connector->abort()) {
+            return false;
+        }
+
+        setState(ClosingState);
+        return true;
+    }
+
     setState(ClosingState);
 
+#   ifdef XMRIG_FEATURE_TLS
+    if (m_tls) {
+        m_tls->close();
+    }
+#   endif
+
     if (uv_is_closing(reinterpret_cast<uv_handle_t*>(m_socket)) == 0) {
         uv_close(reinterpret_cast<uv_handle_t*>(m_socket), Client::onClose);
     }
@@ -313,40 +381,78 @@ bool xlarig::Client::parseJob(const rapidjson::Value &params, int *code)
         return false;
     }
 
+    const rapidjson::Value *jobId    = nullptr;
+    const rapidjson::Value *blob     = nullptr;
+    const rapidjson::Value *target   = nullptr;
+    const rapidjson::Value *algo     = nullptr;
+    const rapidjson::Value *variant  = nullptr;
+    const rapidjson::Value *seedHash = nullptr;
+    const rapidjson::Value *height   = nullptr;
+
+    for (const auto &member : params.GetObject()) {
+        const rapidjson::Value &value = member.value;
+        const char *name              = member.name.GetString();
+
+        if (strcmp(name, "blob") == 0) {
+            blob = &value;
+        }
+        else if (strcmp(name, "job_id") == 0) {
+            jobId = &value;
+        }
+        else if (strcmp(name, "target") == 0) {
+            target = &value;
+        }
+        else if (strcmp(name, "seed_hash") == 0) {
+            seedHash = &value;
+        }
+        else if (strcmp(name, "height") == 0) {
+            height = &value;
+        }
+        else if (strcmp(name, "algo") == 0) {
+            algo = &value;
+        }
+        else if (strcmp(name, "variant") == 0) {
+            variant = &value;
+        }
+    }
+
     Job job(m_id, has<EXT_NICEHASH>(), m_pool.algorithm(), m_rpcId);
 
-    if (!job.setId(params["job_id"].GetString())) {
+    if (!jobId || !jobId->IsString() || !job.setId(jobId->GetString())) {
         *code = 3;
         return false;
     }
 
-    if (!job.setBlob(params["blob"].GetString())) {
+    if (!blob || !blob->IsString() || !job.setBlob(blob->GetString(), blob->GetStringLength())) {
         *code = 4;
         return false;
     }
 
-    if (!job.setTarget(params["target"].GetString())) {
+    if (!target || !target->IsString() || !job.setTarget(target->GetString(), target->GetStringLength())) {
         *code = 5;
         return false;
     }
 
-    if (params.HasMember("algo")) {
-        job.setAlgorithm(params["algo"].GetString());
+    if (algo && algo->IsString()) {
+        job.setAlgorithm(algo->GetString());
     }
 
-    if (params.HasMember("variant")) {
-        const rapidjson::Value &variant = params["variant"];
-
-        if (variant.IsInt()) {
-            job.setVariant(variant.GetInt());
+    if (variant) {
+        if (variant->IsInt()) {
+            job.setVariant(variant->GetInt());
         }
-        else if (variant.IsString()){
-            job.setVariant(variant.GetString());
+        else if (variant->IsString()){
+            job.setVariant(variant->GetString());
         }
     }
 
-    job.setSeedHash(Json::getString(params, "seed_hash"));
-    job.setHeight(Json::getUint64(params, "height"));
+    if (seedHash && seedHash->IsString()) {
+        job.setSeedHash(seedHash->GetString(), seedHash->GetStringLength());
+    }
+
+    if (height && height->IsUint64()) {
+        job.setHeight(height->GetUint64());
+    }
 
     if (!verifyAlgorithm(job.algorithm())) {
         *code = 6;
@@ -407,9 +513,13 @@ bool xlarig::Client::send(BIO *bio)
 
     bool result = false;
     if (state() == ConnectedState && uv_is_writable(m_stream)) {
-        result = uv_try_write(m_stream, &buf, 1) > 0;
+        result = m_sendQueue.append(buf.base, buf.len);
 
-        if (!result) {
+        if (result) {
+            scheduleFlush();
+        }
+        else {
+            LOG_ERR("[%s] send failed: \"send queue overflow\"", url());
             close();
         }
     }
@@ -480,18 +590,17 @@ int64_t xlarig::Client::send(const rapidjson::Document &doc)
 {
     using namespace rapidjson;
 
-    StringBuffer buffer(nullptr, 512);
-    Writer<StringBuffer> writer(buffer);
+    SendBufStream stream(m_sendBuf, sizeof(m_sendBuf) - 1);
+    Writer<SendBufStream> writer(stream);
     doc.Accept(writer);
 
-    const size_t size = buffer.GetSize();
-    if (size > (sizeof(m_sendBuf) - 2)) {
+    const size_t size = stream.size();
+    if (stream.isOverflow()) {
         LOG_ERR("[%s] send failed: \"send buffer overflow: %zu > %zu\"", url(), size, (sizeof(m_sendBuf) - 2));
         close();
         return -1;
     }
 
-    memcpy(m_sendBuf, buffer.GetString(), size);
     m_sendBuf[size]     = '\n';
     m_sendBuf[size + 1] = '\0';
 
@@ -517,12 +626,13 @@ int64_t xlarig::Client::send(size_t size)
             return -1;
         }
 
-        uv_buf_t buf = uv_buf_init(m_sendBuf, (unsigned int) size);
-
-        if (uv_try_write(m_stream, &buf, 1) < 0) {
+        if (!m_sendQueue.append(m_sendBuf, size)) {
+            LOG_ERR("[%s] send failed: \"send queue overflow\"", url());
             close();
             return -1;
         }
+
+        scheduleFlush();
     }
 
     m_expire = Chrono::steadyMSecs() + kResponseTimeout;
@@ -530,26 +640,49 @@ int64_t xlarig::Client::send(size_t size)
 }
 
 
-void xlarig::Client::connect(sockaddr *addr)
+/**
+ * Writes as much of the queue as the socket accepts right away, the rest goes to uv_write and
+ * anything queued meanwhile is sent as one write when it completes.
+ */
+void xlarig::Client::flush()
 {
-    setState(ConnectingState);
+    if (m_sendQueue.isWriting() || m_sendQueue.isEmpty() || state() != ConnectedState) {
+        return;
+    }
 
-    uv_connect_t *req = new uv_connect_t;
-    req->data = m_storage.ptr(m_key);
+#   ifdef XMRIG_FEATURE_TLS
+    if (isTLS() && m_tls->isDirect()) {
+        return m_tls->flush();
+    }
+#   endif
 
-    m_socket = new uv_tcp_t;
-    m_socket->data = m_storage.ptr(m_key);
+    uv_buf_t buf = m_sendQueue.take();
+    int rc       = uv_try_write(m_stream, &buf, 1);
 
-    uv_tcp_init(uv_default_loop(), m_socket);
-    uv_tcp_nodelay(m_socket, 1);
+    if (rc == UV_EAGAIN || rc == UV_ENOSYS) {
+        rc = 0;
+    }
 
-#   ifndef WIN32
-    uv_tcp_keepalive(m_socket, 1, 60);
-#   endif
+    if (rc < 0) {
+        LOG_DEBUG_ERR("[%s] write error: \"%s\"", url(), uv_strerror(rc));
+        close();
+        return;
+    }
+
+    if (m_sendQueue.consume(static_cast<size_t>(rc))) {
+        return;
+    }
 
-    uv_tcp_connect(req, m_socket, addr, onConnect);
+    buf = m_sendQueue.remaining();
+    rc  = uv_write(&m_writeReq, m_stream, &buf, 1, Client::onWrite);
+
+    if (rc < 0) {
+        LOG_DEBUG_ERR("[%s] write error: \"%s\"", url(), uv_strerror(rc));
+        close();
+        return;
+    }
 
-    delete addr;
+    m_sendQueue.setWriting(true);
 }
 
 
@@ -615,6 +748,9 @@ void xlarig::Client::onClose()
     m_socket = nullptr;
     setState(UnconnectedState);
 
+    uv_idle_stop(m_flush);
+    m_sendQueue.reset();
+
 #   ifdef XMRIG_FEATURE_TLS
     if (m_tls) {
         delete m_tls;
@@ -640,7 +776,9 @@ void xlarig::Client::parse(char *line, size_t len)
         return;
     }
 
-    rapidjson::Document doc;
+    m_docPool.clear();
+
+    DocumentPool::Document doc(m_docPool.allocator(), 1024, m_docPool.stackAllocator());
     if (doc.ParseInsitu(line).HasParseError()) {
         if (!isQuiet()) {
             LOG_ERR("[%s] JSON decode failed: \"%s\"", url(), rapidjson::GetParseError_En(doc.GetParseError()));
@@ -653,12 +791,38 @@ void xlarig::Client::parse(char *line, size_t len)
         return;
     }
 
-    const rapidjson::Value &id = doc["id"];
-    if (id.IsInt64()) {
-        parseResponse(id.GetInt64(), doc["result"], doc["error"]);
+    static const rapidjson::Value null;
+    const rapidjson::Value *id     = &null;
+    const rapidjson::Value *result = &null;
+    const rapidjson::Value *error  = &null;
+    const rapidjson::Value *params = &null;
+    const char *method             = nullptr;
+
+    for (const auto &member : doc.GetObject()) {
+        const char *name = member.name.GetString();
+
+        if (strcmp(name, "id") == 0) {
+            id = &member.value;
+        }
+        else if (strcmp(name, "result") == 0) {
+            result = &member.value;
+        }
+        else if (strcmp(name, "error") == 0) {
+            error = &member.value;
+        }
+        else if (strcmp(name, "params") == 0) {
+            params = &member.value;
+        }
+        else if (strcmp(name, "method") == 0 && member.value.IsString()) {
+            method = member.value.GetString();
+        }
+    }
+
+    if (id->IsInt64()) {
+        parseResponse(id->GetInt64(), *result, *error);
     }
     else {
-        parseNotification(doc["method"].GetString(), doc["params"], doc["error"]);
+        parseNotification(method, *params, *error);
     }
 }
 
@@ -773,7 +937,13 @@ void xlarig::Client::parseResponse(int64_t id, const rapidjson::Value &result, c
 
 void xlarig::Client::ping()
 {
-    send(snprintf(m_sendBuf, sizeof(m_sendBuf), "{\"id\":%" PRId64 ",\"jsonrpc\":\"2.0\",\"method\":\"keepalived\",\"params\":{\"id\":\"%s\"}}\n", m_sequence, m_rpcId.data()));
+    JsonLineWriter<sizeof(m_sendBuf)> writer(m_sendBuf, m_sequence, "keepalived");
+    writer.add("id", m_rpcId.data());
+
+    const size_t size = writer.end();
+    if (size) {
+        send(size);
+    }
 }
 
 
@@ -839,6 +1009,18 @@ void xlarig::Client::reconnect()
 }
 
 
+/**
+ * Defers the write to the idle phase so lines sent from the same loop iteration, like a burst of
+ * submits, leave in a single syscall.
+ */
+void xlarig::Client::scheduleFlush()
+{
+    if (!m_sendQueue.isWriting()) {
+        uv_idle_start(m_flush, Client::onFlush);
+    }
+}
+
+
 void xlarig::Client::setState(SocketState state)
 {
     LOG_DEBUG("[%s] state: \"%s\"", url(), states[state]);
@@ -891,32 +1073,14 @@ void xlarig::Client::onClose(uv_handle_t *handle)
 }
 
 
-void xlarig::Client::onConnect(uv_connect_t *req, int status)
+void xlarig::Client::onFlush(uv_idle_t *handle)
 {
-    auto client = getClient(req->data);
-    if (!client) {
-        delete req;
-        return;
-    }
+    uv_idle_stop(handle);
 
-    if (status < 0) {
-        if (!client->isQuiet()) {
-            LOG_ERR("[%s] connect error: \"%s\"", client->url(), uv_strerror(status));
-        }
-
-        delete req;
-        client->close();
-        return;
+    auto client = getClient(handle->data);
+    if (client) {
+        client->flush();
     }
-
-    client->m_stream = static_cast<uv_stream_t*>(req->handle);
-    client->m_stream->data = req->data;
-    client->setState(ConnectedState);
-
-    uv_read_start(client->m_stream, onAllocBuffer, onRead);
-    delete req;
-
-    client->handshake();
 }
 
 
@@ -927,3 +1091,26 @@ void xlarig::Client::onRead(uv_stream_t *stream, ssize_t nread, const uv_buf_t *
         client->read(nread);
     }
 }
+
+
+void xlarig::Client::onWrite(uv_write_t *req, int status)
+{
+    auto client = getClient(req->data);
+    if (!client) {
+        return;
+    }
+
+    client->m_sendQueue.setWriting(false);
+
+    if (status < 0) {
+        if (status != UV_ECANCELED) {
+            LOG_DEBUG_ERR("[%s] write error: \"%s\"", client->url(), uv_strerror(status));
+            client->close();
+        }
+
+        return;
+    }
+
+    client->m_sendQueue.consume(client->m_sendQueue.remaining().len);
+    client->flush();
+}
@@ -32,13 +32,16 @@
 #include <vector>
 
 
+#include "base/io/json/JsonDocumentPool.h"
 #include "base/kernel/interfaces/IDnsListener.h"
 #include "base/kernel/interfaces/ILineListener.h"
+#include "base/kernel/interfaces/ITcpConnectorListener.h"
 #include "base/net/stratum/BaseClient.h"
 #include "base/net/stratum/Job.h"
 #include "base/net/stratum/Pool.h"
 #include "base/net/stratum/SubmitResult.h"
 #include "base/net/tools/RecvBuf.h"
+#include "base/net/tools/SendQueue.h"
 #include "base/net/tools/Storage.h"
 #include "crypto/common/Algorithm.h"
 
@@ -51,12 +54,14 @@ namespace xlarig {
 
 class IClientListener;
 class JobResult;
+class TcpConnector;
 
 
-class Client : public BaseClient, public IDnsListener, public ILineListener
+class Client : public BaseClient, public IDnsListener, public ILineListener, public ITcpConnectorListener
 {
 public:
     constexpr static int kResponseTimeout = 20 * 1000;
+    constexpr static size_t kSendQueueSize = 1024 * 256;
 
 #   ifdef XMRIG_FEATURE_TLS
     constexpr static int kInputBufferSize = 1024 * 16;
@@ -78,6 +83,7 @@ protected:
     void deleteLater() override;
     void tick(uint64_t now) override;
 
+    void onConnect(uv_tcp_t *socket, const DnsRecord &record, int status) override;
     void onResolved(const Dns &dns, int status) override;
 
     inline bool hasExtension(Extension extension) const noexcept override { return m_extensions.test(extension); }
@@ -87,6 +93,8 @@ protected:
 private:
     class Tls;
 
+    using DocumentPool = JsonDocumentPool<1024 * 16, 1024 * 4>;
+
     bool close();
     bool isCriticalError(const char *message);
     bool parseJob(const rapidjson::Value &params, int *code);
@@ -96,7 +104,7 @@ private:
     int resolve(const String &host);
     int64_t send(const rapidjson::Document &doc);
     int64_t send(size_t size);
-    void connect(sockaddr *addr);
+    void flush();
     void handshake();
     void login();
     void onClose();
@@ -107,6 +115,7 @@ private:
     void ping();
     void read(ssize_t nread);
     void reconnect();
+    void scheduleFlush();
     void setState(SocketState state);
     void startTimeout();
 
@@ -117,24 +126,30 @@ private:
 
     static void onAllocBuffer(uv_handle_t *handle, size_t suggested_size, uv_buf_t *buf);
     static void onClose(uv_handle_t *handle);
-    static void onConnect(uv_connect_t *req, int status);
+    static void onFlush(uv_idle_t *handle);
     static void onRead(uv_stream_t *stream, ssize_t nread, const uv_buf_t *buf);
+    static void onWrite(uv_write_t *req, int status);
 
     static inline Client *getClient(void *data) { return m_storage.get(data); }
 
     char m_sendBuf[2048];
     const char *m_agent;
     Dns *m_dns;
+    DocumentPool m_docPool;
     RecvBuf<kInputBufferSize> m_recvBuf;
+    SendQueue<kSendQueueSize> m_sendQueue;
     std::bitset<EXT_MAX> m_extensions;
     String m_rpcId;
+    TcpConnector *m_connector;
     Tls *m_tls;
     uint64_t m_expire;
     uint64_t m_jobs;
     uint64_t m_keepAlive;
     uintptr_t m_key;
     uv_stream_t *m_stream;
+    uv_idle_t *m_flush;
     uv_tcp_t *m_socket;
+    uv_write_t m_writeReq;
 
     static Storage<Client> m_storage;
 };
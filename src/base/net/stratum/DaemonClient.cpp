@@ -26,6 +26,7 @@
 
 #include <algorithm>
 #include <assert.h>
+#include <string.h>
 
 
 #include "3rdparty/http-parser/http_parser.h"
@@ -36,6 +37,7 @@
 #include "base/net/http/HttpClient.h"
 #include "base/net/stratum/DaemonClient.h"
 #include "base/net/stratum/SubmitResult.h"
+#include "base/net/zmq/ZmqSubscriber.h"
 #include "base/tools/Buffer.h"
 #include "base/tools/Timer.h"
 #include "net/JobResult.h"
@@ -58,13 +60,16 @@ static const char *kGetInfo                 = "/getinfo";
 static const char *kHash                    = "hash";
 static const char *kHeight                  = "height";
 static const char *kJsonRPC                 = "/json_rpc";
+static const char *kZmqTopic                = "json-minimal-chain_main";
 
 }
 
 
 xlarig::DaemonClient::DaemonClient(int id, IClientListener *listener) :
     BaseClient(id, listener),
-    m_monero(true)
+    m_monero(true),
+    m_templateId(-1),
+    m_zmq(nullptr)
 {
     m_timer = new Timer(this);
 }
@@ -73,6 +78,7 @@ xlarig::DaemonClient::DaemonClient(int id, IClientListener *listener) :
 xlarig::DaemonClient::~DaemonClient()
 {
     delete m_timer;
+    delete m_zmq;
 }
 
 
@@ -204,6 +210,67 @@ void xlarig::DaemonClient::onTimer(const Timer *)
 }
 
 
+void xlarig::DaemonClient::onZmqClose(int status)
+{
+    if (!isQuiet()) {
+        LOG_WARN("[%s:%d] ZMQ notifications lost: \"%s\", polling instead", m_pool.host().data(), m_pool.port(), uv_strerror(status));
+    }
+
+    if (m_state == ConnectedState) {
+        startPolling();
+    }
+}
+
+
+/**
+ * Handles "json-minimal-chain_main" notifications, the template for the new tip is requested
+ * right away instead of waiting for the next /getheight poll.
+ */
+void xlarig::DaemonClient::onZmqMessage(const char *data, size_t size)
+{
+    const size_t topic = strlen(kZmqTopic);
+    if (m_state != ConnectedState || size <= topic || memcmp(data, kZmqTopic, topic) != 0) {
+        return;
+    }
+
+    data += topic;
+    size -= topic;
+
+    if (*data == ':') {
+        data++;
+        size--;
+    }
+
+    rapidjson::Document doc;
+    if (doc.Parse(data, size).HasParseError() || !doc.IsObject()) {
+        LOG_DEBUG_ERR("[%s:%d] ZMQ JSON decode failed", m_pool.host().data(), m_pool.port());
+
+        return;
+    }
+
+    const rapidjson::Value &ids = Json::getArray(doc, "ids");
+    if (!ids.IsArray() || ids.Empty() || !ids[ids.Size() - 1].IsString()) {
+        return;
+    }
+
+    if (isOutdated(Json::getUint64(doc, "first_height") + ids.Size(), ids[ids.Size() - 1].GetString())) {
+        getBlockTemplate();
+    }
+}
+
+
+void xlarig::DaemonClient::onZmqReady()
+{
+    if (m_state != ConnectedState) {
+        return;
+    }
+
+    // A block found before the subscription became active would be missed otherwise.
+    m_timer->stop();
+    send(HTTP_GET, m_monero ? kGetHeight : kGetInfo);
+}
+
+
 bool xlarig::DaemonClient::isOutdated(uint64_t height, const char *hash) const
 {
     return m_job.height() != height || m_prevHash != hash;
@@ -258,6 +325,11 @@ bool xlarig::DaemonClient::parseResponse(int64_t id, const rapidjson::Value &res
         return false;
     }
 
+    // Superseded by a newer request, a late answer must not replace a fresher template.
+    if (result.HasMember(kBlocktemplateBlob) && id != m_templateId) {
+        return true;
+    }
+
     int code = -1;
     if (result.HasMember(kBlocktemplateBlob) && parseJob(result, &code)) {
         return true;
@@ -287,6 +359,8 @@ int64_t xlarig::DaemonClient::getBlockTemplate()
 
     send(HTTP_POST, kJsonRPC, doc);
 
+    m_templateId = m_sequence;
+
     return m_sequence++;
 }
 
@@ -363,17 +437,33 @@ void xlarig::DaemonClient::setState(SocketState state)
             m_failures = 0;
             m_listener->onLoginSuccess(this);
 
-            const uint64_t interval = std::max<uint64_t>(20, m_pool.pollInterval());
-            m_timer->start(interval, interval);
+            if (m_pool.zmqPort() && !m_zmq) {
+                m_zmq = new ZmqSubscriber(m_pool.host(), m_pool.zmqPort(), kZmqTopic, this);
+                m_zmq->connect();
+            }
+
+            if (!m_zmq || !m_zmq->isReady()) {
+                startPolling();
+            }
         }
         break;
 
     case UnconnectedState:
         m_failures = -1;
         m_timer->stop();
+
+        delete m_zmq;
+        m_zmq = nullptr;
         break;
 
     default:
         break;
     }
 }
+
+
+void xlarig::DaemonClient::startPolling()
+{
+    const uint64_t interval = std::max<uint64_t>(20, m_pool.pollInterval());
+    m_timer->start(interval, interval);
+}
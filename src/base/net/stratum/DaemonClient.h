@@ -30,12 +30,16 @@
 #include "base/net/stratum/BaseClient.h"
 #include "base/kernel/interfaces/ITimerListener.h"
 #include "base/kernel/interfaces/IHttpListener.h"
+#include "base/kernel/interfaces/IZmqListener.h"
 
 
 namespace xlarig {
 
 
-class DaemonClient : public BaseClient, public ITimerListener, public IHttpListener
+class ZmqSubscriber;
+
+
+class DaemonClient : public BaseClient, public ITimerListener, public IHttpListener, public IZmqListener
 {
 public:
     DaemonClient(int id, IClientListener *listener);
@@ -50,6 +54,9 @@ protected:
 
     void onHttpData(const HttpData &data) override;
     void onTimer(const Timer *timer) override;
+    void onZmqClose(int status) override;
+    void onZmqMessage(const char *data, size_t size) override;
+    void onZmqReady() override;
 
     inline bool hasExtension(Extension) const noexcept override { return false; }
     inline const char *mode() const override                    { return "daemon"; }
@@ -67,13 +74,16 @@ private:
     void send(int method, const char *url, const char *data = nullptr, size_t size = 0);
     void send(int method, const char *url, const rapidjson::Document &doc);
     void setState(SocketState state);
+    void startPolling();
 
     bool m_monero;
+    int64_t m_templateId;
     String m_blocktemplate;
     String m_prevHash;
     String m_tlsFingerprint;
     String m_tlsVersion;
     Timer *m_timer;
+    ZmqSubscriber *m_zmq;
 };
 
 
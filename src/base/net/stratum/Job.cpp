@@ -76,18 +76,13 @@ bool xlarig::Job::isEqual(const Job &other) const
 }
 
 
-bool xlarig::Job::setBlob(const char *blob)
+bool xlarig::Job::setBlob(const char *blob, size_t size)
 {
-    if (!blob) {
+    if (size % 2 != 0) {
         return false;
     }
 
-    m_size = strlen(blob);
-    if (m_size % 2 != 0) {
-        return false;
-    }
-
-    m_size /= 2;
+    m_size = size / 2;
     if (m_size < 76 || m_size >= sizeof(m_blob)) {
         return false;
     }
@@ -113,28 +108,22 @@ bool xlarig::Job::setBlob(const char *blob)
 }
 
 
-bool xlarig::Job::setSeedHash(const char *hash)
+bool xlarig::Job::setSeedHash(const char *hash, size_t size)
 {
-    if (!hash || (strlen(hash) != sizeof(m_seedHash) * 2)) {
+    if (size != sizeof(m_seedHash) * 2) {
         return false;
     }
 
 #   ifdef XMRIG_PROXY_PROJECT
-    m_rawSeedHash = hash;
+    m_rawSeedHash = String(hash, size);
 #   endif
 
     return Buffer::fromHex(hash, sizeof(m_seedHash) * 2, m_seedHash);
 }
 
 
-bool xlarig::Job::setTarget(const char *target)
+bool xlarig::Job::setTarget(const char *target, size_t len)
 {
-    if (!target) {
-        return false;
-    }
-
-    const size_t len = strlen(target);
-
     if (len <= 8) {
         uint32_t tmp = 0;
         char str[8];
@@ -30,6 +30,7 @@
 
 #include <stddef.h>
 #include <stdint.h>
+#include <string.h>
 
 
 #include "base/tools/String.h"
@@ -51,13 +52,16 @@ public:
     ~Job();
 
     bool isEqual(const Job &other) const;
-    bool setBlob(const char *blob);
-    bool setSeedHash(const char *hash);
-    bool setTarget(const char *target);
+    bool setBlob(const char *blob, size_t size);
+    bool setSeedHash(const char *hash, size_t size);
+    bool setTarget(const char *target, size_t size);
     void setAlgorithm(const char *algo);
     void setDiff(uint64_t diff);
 
     inline bool isNicehash() const                    { return m_nicehash; }
+    inline bool setBlob(const char *blob)             { return blob && setBlob(blob, strlen(blob)); }
+    inline bool setSeedHash(const char *hash)         { return hash && setSeedHash(hash, strlen(hash)); }
+    inline bool setTarget(const char *target)         { return target && setTarget(target, strlen(target)); }
     inline bool isValid() const                       { return m_size > 0 && m_diff > 0; }
     inline bool setId(const char *id)                 { return m_id = id; }
     inline const Algorithm &algorithm() const         { return m_algorithm; }
@@ -76,6 +80,7 @@ public:
     inline uint8_t fixedByte() const                  { return *(m_blob + 42); }
     inline void reset()                               { m_size = 0; m_diff = 0; }
     inline void setClientId(const String &id)         { m_clientId = id; }
+    inline void setFixedByte(uint8_t value)           { *(m_blob + 42) = value; m_nicehash = true; }
     inline void setHeight(uint64_t height)            { m_height = height; }
     inline void setPoolId(int poolId)                 { m_poolId = poolId; }
     inline void setThreadId(int threadId)             { m_threadId = threadId; }
@@ -24,6 +24,7 @@
  */
 
 
+#include <algorithm>
 #include <assert.h>
 #include <string.h>
 #include <stdlib.h>
@@ -49,9 +50,12 @@ namespace xlarig {
 
 static const char *kDaemon                 = "daemon";
 static const char *kDaemonPollInterval     = "daemon-poll-interval";
+static const char *kDaemonZmqPort          = "daemon-zmq-port";
 static const char *kEnabled                = "enabled";
 static const char *kFingerprint            = "tls-fingerprint";
 static const char *kKeepalive              = "keepalive";
+static const char *kKtls                   = "ktls";
+static const char *kMultiAlgo              = "multi-algo";
 static const char *kNicehash               = "nicehash";
 static const char *kPass                   = "pass";
 static const char *kRigId                  = "rig-id";
@@ -78,6 +82,7 @@ xlarig::Pool::Pool() :
     m_keepAlive(0),
     m_flags(0),
     m_port(kDefaultPort),
+    m_zmqPort(0),
     m_pollInterval(kDefaultPollInterval)
 {
 }
@@ -98,6 +103,7 @@ xlarig::Pool::Pool(const char *url) :
     m_keepAlive(0),
     m_flags(1),
     m_port(kDefaultPort),
+    m_zmqPort(0),
     m_pollInterval(kDefaultPollInterval)
 {
     parse(url);
@@ -108,6 +114,7 @@ xlarig::Pool::Pool(const rapidjson::Value &object) :
     m_keepAlive(0),
     m_flags(1),
     m_port(kDefaultPort),
+    m_zmqPort(0),
     m_pollInterval(kDefaultPollInterval)
 {
     if (!parse(Json::getString(object, kUrl))) {
@@ -119,11 +126,14 @@ xlarig::Pool::Pool(const rapidjson::Value &object) :
     m_rigId        = Json::getString(object, kRigId);
     m_fingerprint  = Json::getString(object, kFingerprint);
     m_pollInterval = Json::getUint64(object, kDaemonPollInterval, kDefaultPollInterval);
+    m_zmqPort      = static_cast<uint16_t>(Json::getUint(object, kDaemonZmqPort));
 
-    m_flags.set(FLAG_ENABLED,  Json::getBool(object, kEnabled, true));
-    m_flags.set(FLAG_NICEHASH, Json::getBool(object, kNicehash));
-    m_flags.set(FLAG_TLS,      Json::getBool(object, kTls, m_flags.test(FLAG_TLS)));
-    m_flags.set(FLAG_DAEMON,   Json::getBool(object, kDaemon, m_flags.test(FLAG_DAEMON)));
+    m_flags.set(FLAG_ENABLED,    Json::getBool(object, kEnabled, true));
+    m_flags.set(FLAG_NICEHASH,   Json::getBool(object, kNicehash));
+    m_flags.set(FLAG_TLS,        Json::getBool(object, kTls, m_flags.test(FLAG_TLS)));
+    m_flags.set(FLAG_DAEMON,     Json::getBool(object, kDaemon, m_flags.test(FLAG_DAEMON)));
+    m_flags.set(FLAG_KTLS,       Json::getBool(object, kKtls));
+    m_flags.set(FLAG_MULTI_ALGO, Json::getBool(object, kMultiAlgo));
 
     const rapidjson::Value &keepalive = Json::getValue(object, kKeepalive);
     if (keepalive.IsInt()) {
@@ -151,6 +161,7 @@ xlarig::Pool::Pool(const char *host, uint16_t port, const char *user, const char
     m_password(password),
     m_user(user),
     m_port(port),
+    m_zmqPort(0),
     m_pollInterval(kDefaultPollInterval)
 {
     const size_t size = m_host.size() + 8;
@@ -218,7 +229,8 @@ bool xlarig::Pool::isEqual(const Pool &other) const
             && m_rigId        == other.m_rigId
             && m_url          == other.m_url
             && m_user         == other.m_user
-            && m_pollInterval == other.m_pollInterval);
+            && m_pollInterval == other.m_pollInterval
+            && m_zmqPort      == other.m_zmqPort);
 }
 
 
@@ -295,7 +307,8 @@ rapidjson::Value xlarig::Pool::toJSON(rapidjson::Document &doc) const
     obj.AddMember(StringRef(kRigId), m_rigId.toJSON(), allocator);
 
 #   ifndef XMRIG_PROXY_PROJECT
-    obj.AddMember(StringRef(kNicehash), isNicehash(), allocator);
+    obj.AddMember(StringRef(kNicehash),  isNicehash(), allocator);
+    obj.AddMember(StringRef(kMultiAlgo), isMultiAlgo(), allocator);
 #   endif
 
     if (m_keepAlive == 0 || m_keepAlive == kKeepAliveTimeout) {
@@ -324,8 +337,10 @@ rapidjson::Value xlarig::Pool::toJSON(rapidjson::Document &doc) const
     obj.AddMember(StringRef(kEnabled),            m_flags.test(FLAG_ENABLED), allocator);
     obj.AddMember(StringRef(kTls),                isTLS(), allocator);
     obj.AddMember(StringRef(kFingerprint),        m_fingerprint.toJSON(), allocator);
+    obj.AddMember(StringRef(kKtls),               isKTLS(), allocator);
     obj.AddMember(StringRef(kDaemon),             m_flags.test(FLAG_DAEMON), allocator);
     obj.AddMember(StringRef(kDaemonPollInterval), m_pollInterval, allocator);
+    obj.AddMember(StringRef(kDaemonZmqPort),      m_zmqPort, allocator);
 
     return obj;
 }
@@ -393,10 +408,10 @@ bool xlarig::Pool::parseIPv6(const char *addr)
 }
 
 
-void xlarig::Pool::addVariant(xlarig::Variant variant)
+void xlarig::Pool::addVariant(xlarig::Algo algo, xlarig::Variant variant)
 {
-    const xlarig::Algorithm algorithm(m_algorithm.algo(), variant);
-    if (!algorithm.isValid() || m_algorithm == algorithm) {
+    const xlarig::Algorithm algorithm(algo, variant);
+    if (!algorithm.isValid() || std::find(m_algorithms.begin(), m_algorithms.end(), algorithm) != m_algorithms.end()) {
         return;
     }
 
@@ -404,6 +419,25 @@ void xlarig::Pool::addVariant(xlarig::Variant variant)
 }
 
 
+void xlarig::Pool::addVariants(xlarig::Algo algo)
+{
+    using namespace xlarig;
+
+    static const Variant variants[] = {
+        VARIANT_4, VARIANT_WOW, VARIANT_2, VARIANT_1, VARIANT_0, VARIANT_HALF, VARIANT_XTL, VARIANT_TUBE, VARIANT_MSR,
+        VARIANT_XHV, VARIANT_XAO, VARIANT_RTO, VARIANT_GPU, VARIANT_RWZ, VARIANT_ZLS, VARIANT_DOUBLE, VARIANT_RX_DEFYX,
+#       ifdef XMRIG_ALGO_CN_PICO
+        VARIANT_TRTL,
+#       endif
+        VARIANT_AUTO
+    };
+
+    for (const Variant variant : variants) {
+        addVariant(algo, variant);
+    }
+}
+
+
 void xlarig::Pool::adjustVariant(const xlarig::Variant variantHint)
 {
 #   ifndef XMRIG_PROXY_PROJECT
@@ -501,24 +535,18 @@ void xlarig::Pool::rebuild()
     m_algorithms.push_back(m_algorithm);
 
 #   ifndef XMRIG_PROXY_PROJECT
-    addVariant(VARIANT_4);
-    addVariant(VARIANT_WOW);
-    addVariant(VARIANT_2);
-    addVariant(VARIANT_1);
-    addVariant(VARIANT_0);
-    addVariant(VARIANT_HALF);
-    addVariant(VARIANT_XTL);
-    addVariant(VARIANT_TUBE);
-    addVariant(VARIANT_MSR);
-    addVariant(VARIANT_XHV);
-    addVariant(VARIANT_XAO);
-    addVariant(VARIANT_RTO);
-    addVariant(VARIANT_GPU);
-    addVariant(VARIANT_RWZ);
-    addVariant(VARIANT_ZLS);
-    addVariant(VARIANT_DOUBLE);
-    addVariant(VARIANT_RX_DEFYX);
-    addVariant(VARIANT_RX_DEFYX);
-    addVariant(VARIANT_AUTO);
+    addVariants(m_algorithm.algo());
+
+    if (!isMultiAlgo()) {
+        return;
+    }
+
+    // workers re-dispatch on the job algorithm, so with "multi-algo" other families are accepted too,
+    // they go last to keep pools that negotiate by list order on the configured one
+    for (int algo = xlarig::CRYPTONIGHT; algo < xlarig::ALGO_MAX; ++algo) {
+        if (algo != m_algorithm.algo()) {
+            addVariants(static_cast<xlarig::Algo>(algo));
+        }
+    }
 #   endif
 }
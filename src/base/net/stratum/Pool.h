@@ -47,6 +47,8 @@ public:
         FLAG_NICEHASH,
         FLAG_TLS,
         FLAG_DAEMON,
+        FLAG_KTLS,
+        FLAG_MULTI_ALGO,
         FLAG_MAX
     };
 
@@ -71,6 +73,8 @@ public:
 
     inline Algorithm &algorithm()                       { return m_algorithm; }
     inline bool isDaemon() const                        { return m_flags.test(FLAG_DAEMON); }
+    inline bool isKTLS() const                          { return m_flags.test(FLAG_KTLS); }
+    inline bool isMultiAlgo() const                     { return m_flags.test(FLAG_MULTI_ALGO); }
     inline bool isNicehash() const                      { return m_flags.test(FLAG_NICEHASH); }
     inline bool isTLS() const                           { return m_flags.test(FLAG_TLS); }
     inline bool isValid() const                         { return !m_host.isNull() && m_port > 0; }
@@ -84,6 +88,7 @@ public:
     inline const String &user() const                   { return !m_user.isNull() ? m_user : kDefaultUser; }
     inline int keepAlive() const                        { return m_keepAlive; }
     inline uint16_t port() const                        { return m_port; }
+    inline uint16_t zmqPort() const                     { return m_zmqPort; }
     inline uint64_t pollInterval() const                { return m_pollInterval; }
     inline void setPassword(const String &password)     { m_password = password; }
     inline void setRigId(const String &rigId)           { m_rigId = rigId; }
@@ -109,7 +114,8 @@ private:
     inline void setKeepAlive(int keepAlive)             { m_keepAlive = keepAlive >= 0 ? keepAlive : 0; }
 
     bool parseIPv6(const char *addr);
-    void addVariant(Variant variant);
+    void addVariant(Algo algo, Variant variant);
+    void addVariants(Algo algo);
     void adjustVariant(const Variant variantHint);
     void rebuild();
 
@@ -124,6 +130,7 @@ private:
     String m_url;
     String m_user;
     uint16_t m_port;
+    uint16_t m_zmqPort;
     uint64_t m_pollInterval;
 };
 
@@ -23,19 +23,37 @@
  */
 
 
+#include <string.h>
+
+
 #include "base/io/log/Log.h"
 #include "base/net/stratum/Pools.h"
 #include "base/net/stratum/strategies/FailoverStrategy.h"
+#include "base/net/stratum/strategies/HotStandbyStrategy.h"
 #include "base/net/stratum/strategies/SinglePoolStrategy.h"
 #include "donate.h"
 #include "rapidjson/document.h"
 
 
+namespace xlarig {
+
+
+static const char *strategyNames[] = {
+    "failover",
+    "hot-standby",
+    "fastest"
+};
+
+
+} /* namespace xlarig */
+
+
 xlarig::Pools::Pools() :
     m_donateLevel(kDefaultDonateLevel),
     m_retries(5),
     m_retryPause(5),
-    m_proxyDonate(PROXY_DONATE_AUTO)
+    m_proxyDonate(PROXY_DONATE_AUTO),
+    m_strategy(STRATEGY_FAILOVER)
 {
 #   ifdef XMRIG_PROXY_PROJECT
     m_retries    = 2;
@@ -46,7 +64,7 @@ xlarig::Pools::Pools() :
 
 bool xlarig::Pools::isEqual(const Pools &other) const
 {
-    if (m_data.size() != other.m_data.size() || m_retries != other.m_retries || m_retryPause != other.m_retryPause) {
+    if (m_data.size() != other.m_data.size() || m_retries != other.m_retries || m_retryPause != other.m_retryPause || m_strategy != other.m_strategy) {
         return false;
     }
 
@@ -64,6 +82,17 @@ xlarig::IStrategy *xlarig::Pools::createStrategy(IStrategyListener *listener) co
         }
     }
 
+    if (m_strategy != STRATEGY_FAILOVER) {
+        HotStandbyStrategy *strategy = new HotStandbyStrategy(retryPause(), m_strategy == STRATEGY_FASTEST, listener);
+        for (const Pool &pool : m_data) {
+            if (pool.isEnabled()) {
+                strategy->add(pool);
+            }
+        }
+
+        return strategy;
+    }
+
     FailoverStrategy *strategy = new FailoverStrategy(retryPause(), retries(), listener);
     for (const Pool &pool : m_data) {
         if (pool.isEnabled()) {
@@ -156,6 +185,12 @@ void xlarig::Pools::print() const
 }
 
 
+const char *xlarig::Pools::strategyName() const
+{
+    return strategyNames[m_strategy];
+}
+
+
 void xlarig::Pools::setDonateLevel(int level)
 {
     if (level >= kMinimumDonateLevel && level <= 99) {
@@ -189,3 +224,18 @@ void xlarig::Pools::setRetryPause(int retryPause)
         m_retryPause = retryPause;
     }
 }
+
+
+void xlarig::Pools::setStrategy(const char *strategy)
+{
+    if (!strategy) {
+        return;
+    }
+
+    for (size_t i = 0; i < sizeof(strategyNames) / sizeof(strategyNames[0]); ++i) {
+        if (strcmp(strategy, strategyNames[i]) == 0) {
+            m_strategy = static_cast<Strategy>(i);
+            return;
+        }
+    }
+}
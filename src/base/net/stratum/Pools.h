@@ -48,6 +48,12 @@ public:
         PROXY_DONATE_ALWAYS
     };
 
+    enum Strategy {
+        STRATEGY_FAILOVER,
+        STRATEGY_HOT_STANDBY,
+        STRATEGY_FASTEST
+    };
+
     Pools();
 
     inline const std::vector<Pool> &data() const        { return m_data; }
@@ -55,11 +61,13 @@ public:
     inline int retries() const                          { return m_retries; }
     inline int retryPause() const                       { return m_retryPause; }
     inline ProxyDonate proxyDonate() const              { return m_proxyDonate; }
+    inline Strategy strategy() const                    { return m_strategy; }
 
     inline bool operator!=(const Pools &other) const    { return !isEqual(other); }
     inline bool operator==(const Pools &other) const    { return isEqual(other); }
 
     bool isEqual(const Pools &other) const;
+    const char *strategyName() const;
     IStrategy *createStrategy(IStrategyListener *listener) const;
     rapidjson::Value toJSON(rapidjson::Document &doc) const;
     size_t active() const;
@@ -70,12 +78,14 @@ public:
     void setProxyDonate(int value);
     void setRetries(int retries);
     void setRetryPause(int retryPause);
+    void setStrategy(const char *strategy);
 
 private:
     int m_donateLevel;
     int m_retries;
     int m_retryPause;
     ProxyDonate m_proxyDonate;
+    Strategy m_strategy;
     std::vector<Pool> m_data;
 };
 
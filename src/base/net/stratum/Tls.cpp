@@ -23,14 +23,17 @@
  *   along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
-
 #include <assert.h>
+#include <map>
+#include <openssl/err.h>
+#include <stdio.h>
 
 
 #include "base/io/log/Log.h"
 #include "base/net/stratum/Client.h"
 #include "base/net/stratum/Tls.h"
 #include "base/tools/Buffer.h"
+#include "base/tools/Handle.h"
 
 
 #ifdef _MSC_VER
@@ -38,33 +41,80 @@
 #endif
 
 
+namespace xlarig {
+
+
+static SSL_CTX *ctx = nullptr;
+static std::map<String, SSL_SESSION *> sessions;
+
+
+static inline const char *sslError()
+{
+    const char *reason = ERR_reason_error_string(ERR_get_error());
+
+    return reason ? reason : "unknown error";
+}
+
+
+static void removeSession(const String &key)
+{
+    const auto it = sessions.find(key);
+    if (it != sessions.end()) {
+        SSL_SESSION_free(it->second);
+        sessions.erase(it);
+    }
+}
+
+
+} /* namespace xlarig */
+
+
 xlarig::Client::Tls::Tls(Client *client) :
+    m_readBio(nullptr),
+    m_writeBio(nullptr),
+    m_direct(false),
     m_ready(false),
     m_buf(),
     m_fingerprint(),
     m_client(client),
-    m_ssl(nullptr)
+    m_events(0),
+    m_ssl(nullptr),
+    m_poll(nullptr)
 {
-    m_ctx = SSL_CTX_new(SSLv23_method());
-    assert(m_ctx != nullptr);
+    if (ctx) {
+        return;
+    }
+
+    ctx = SSL_CTX_new(SSLv23_method());
+    assert(ctx != nullptr);
 
-    if (!m_ctx) {
+    if (!ctx) {
         return;
     }
 
-    m_writeBio = BIO_new(BIO_s_mem());
-    m_readBio  = BIO_new(BIO_s_mem());
-    SSL_CTX_set_options(m_ctx, SSL_OP_NO_SSLv2 | SSL_OP_NO_SSLv3);
+    SSL_CTX_set_options(ctx, SSL_OP_NO_SSLv2 | SSL_OP_NO_SSLv3);
+
+#   ifdef SSL_OP_IGNORE_UNEXPECTED_EOF
+    // pools rarely send close_notify, a fatal EOF error would also invalidate the cached session
+    SSL_CTX_set_options(ctx, SSL_OP_IGNORE_UNEXPECTED_EOF);
+#   endif
+
+    SSL_CTX_set_mode(ctx, SSL_MODE_ENABLE_PARTIAL_WRITE | SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER);
+    SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+    SSL_CTX_sess_set_new_cb(ctx, Tls::onNewSession);
 }
 
 
 xlarig::Client::Tls::~Tls()
 {
-    if (m_ctx) {
-        SSL_CTX_free(m_ctx);
-    }
+    close();
 
     if (m_ssl) {
+        // connections are dropped without close_notify, this keeps OpenSSL from marking the cached session as not resumable
+        if (m_ready) {
+            SSL_set_shutdown(m_ssl, SSL_SENT_SHUTDOWN | SSL_RECEIVED_SHUTDOWN);
+        }
+
         SSL_free(m_ssl);
     }
 }
@@ -72,14 +122,59 @@ xlarig::Client::Tls::~Tls()
 
 bool xlarig::Client::Tls::handshake()
 {
-    m_ssl = SSL_new(m_ctx);
+    if (!ctx) {
+        return false;
+    }
+
+    m_ssl = SSL_new(ctx);
     assert(m_ssl != nullptr);
 
     if (!m_ssl) {
         return false;
     }
 
+    SSL_set_app_data(m_ssl, this);
     SSL_set_connect_state(m_ssl);
+
+    const auto it = sessions.find(sessionKey());
+    if (it != sessions.end()) {
+        SSL_set_session(m_ssl, it->second);
+    }
+
+#   ifdef XMRIG_FEATURE_KTLS
+    uv_os_fd_t fd;
+    if (m_client->m_pool.isKTLS() && uv_fileno(reinterpret_cast<uv_handle_t *>(m_client->m_stream), &fd) == 0) {
+        // the stream's watcher must be gone first, libuv refuses a poll handle for a descriptor that is still registered
+        uv_read_stop(m_client->m_stream);
+
+        m_poll = new uv_poll_t;
+
+        const int rc = uv_poll_init_socket(uv_default_loop(), m_poll, fd);
+        if (rc == 0) {
+            SSL_set_fd(m_ssl, fd);
+            SSL_set_options(m_ssl, SSL_OP_ENABLE_KTLS);
+
+            m_direct     = true;
+            m_poll->data = m_client->m_storage.ptr(m_client->m_key);
+
+            connect();
+
+            return true;
+        }
+
+        // the handle was never registered with the loop, so it is freed directly instead of through uv_close()
+        delete m_poll;
+        m_poll = nullptr;
+
+        uv_read_start(m_client->m_stream, Client::onAllocBuffer, Client::onRead);
+
+        LOG_WARN("[%s] kTLS disabled: \"%s\"", m_client->url(), uv_strerror(rc));
+    }
+#   endif
+
+    m_readBio  = BIO_new(BIO_s_mem());
+    m_writeBio = BIO_new(BIO_s_mem());
+
     SSL_set_bio(m_ssl, m_readBio, m_writeBio);
     SSL_do_handshake(m_ssl);
 
@@ -89,6 +184,23 @@ bool xlarig::Client::Tls::handshake()
 
 bool xlarig::Client::Tls::send(const char *data, size_t size)
 {
+    if (m_direct) {
+        if (m_client->state() != ConnectedState) {
+            return false;
+        }
+
+        if (!m_client->m_sendQueue.append(data, size)) {
+            LOG_ERR("[%s] send failed: \"send queue overflow\"", m_client->url());
+            m_client->close();
+
+            return false;
+        }
+
+        m_client->scheduleFlush();
+
+        return true;
+    }
+
     SSL_write(m_ssl, data, size);
 
     return send();
@@ -107,37 +219,65 @@ const char *xlarig::Client::Tls::version() const
 }
 
 
-void xlarig::Client::Tls::read(const char *data, size_t size)
+/**
+ * Stops polling the socket, must happen before the TCP handle is closed because both watch the same descriptor.
+ */
+void xlarig::Client::Tls::close()
 {
-    BIO_write(m_readBio, data, size);
+    Handle::close(m_poll);
+    m_poll = nullptr;
+}
 
-    if (!SSL_is_init_finished(m_ssl)) {
-        const int rc = SSL_connect(m_ssl);
 
-        if (rc < 0 && SSL_get_error(m_ssl, rc) == SSL_ERROR_WANT_READ) {
-            send();
-        } else if (rc == 1) {
-            X509 *cert = SSL_get_peer_certificate(m_ssl);
-            if (!verify(cert)) {
-                X509_free(cert);
-                m_client->close();
+/**
+ * Direct mode counterpart of Client::flush(), the queue holds plain text and SSL_write encrypts
+ * straight into the socket (or the kernel does when kTLS is active).
+ */
+void xlarig::Client::Tls::flush()
+{
+    auto &queue  = m_client->m_sendQueue;
+    uv_buf_t buf = queue.remaining();
+
+    if (buf.len == 0) {
+        buf = queue.take();
+    }
 
-                return;
-            }
+    while (buf.len > 0) {
+        const int rc = SSL_write(m_ssl, buf.base, static_cast<int>(buf.len));
 
-            X509_free(cert);
-            m_ready = true;
-            m_client->login();
-      }
+        if (rc > 0) {
+            buf = queue.consume(static_cast<size_t>(rc)) ? queue.take() : queue.remaining();
+            continue;
+        }
 
-      return;
+        const int error = SSL_get_error(m_ssl, rc);
+        if (error == SSL_ERROR_WANT_WRITE || error == SSL_ERROR_WANT_READ) {
+            queue.setWriting(true);
+
+#           ifdef XMRIG_FEATURE_KTLS
+            poll(UV_READABLE | UV_WRITABLE);
+#           endif
+
+            return;
+        }
+
+        LOG_DEBUG_ERR("[%s] write error: \"%s\"", m_client->url(), sslError());
+        m_client->close();
+
+        return;
     }
+}
 
-    int bytes_read = 0;
-    while ((bytes_read = SSL_read(m_ssl, m_buf, sizeof(m_buf))) > 0) {
-        m_buf[bytes_read - 1] = '\0';
-        m_client->parse(m_buf, static_cast<size_t>(bytes_read));
+
+void xlarig::Client::Tls::read(const char *data, size_t size)
+{
+    BIO_write(m_readBio, data, size);
+
+    if (!SSL_is_init_finished(m_ssl)) {
+        return connect();
     }
+
+    read();
 }
 
 
@@ -190,3 +330,163 @@ bool xlarig::Client::Tls::verifyFingerprint(X509 *cert)
 
     return fingerprint == nullptr || strncasecmp(m_fingerprint, fingerprint, 64) == 0;
 }
+
+
+xlarig::String xlarig::Client::Tls::sessionKey() const
+{
+    char key[300];
+    snprintf(key, sizeof(key), "%s:%u", m_client->m_pool.host().data(), m_client->m_pool.port());
+
+    return String(static_cast<const char *>(key));
+}
+
+
+void xlarig::Client::Tls::connect()
+{
+    const int rc = SSL_connect(m_ssl);
+
+    if (rc == 1) {
+        if (!m_direct) {
+            send();
+        }
+
+        X509 *cert = SSL_get_peer_certificate(m_ssl);
+        if (!verify(cert)) {
+            X509_free(cert);
+            removeSession(sessionKey());
+            m_client->close();
+
+            return;
+        }
+
+        X509_free(cert);
+        m_ready = true;
+
+        LOG_DEBUG("[%s] TLS session %s", m_client->url(), SSL_session_reused(m_ssl) ? "resumed" : "new");
+
+#       ifdef XMRIG_FEATURE_KTLS
+        if (m_direct) {
+            LOG_DEBUG("[%s] kTLS send: %d, recv: %d", m_client->url(), static_cast<int>(BIO_get_ktls_send(SSL_get_wbio(m_ssl))), static_cast<int>(BIO_get_ktls_recv(SSL_get_rbio(m_ssl))));
+
+            poll(UV_READABLE);
+        }
+#       endif
+
+        m_client->login();
+
+        return;
+    }
+
+    const int error = SSL_get_error(m_ssl, rc);
+    if (error == SSL_ERROR_WANT_READ || error == SSL_ERROR_WANT_WRITE) {
+#       ifdef XMRIG_FEATURE_KTLS
+        if (m_direct) {
+            return poll(error == SSL_ERROR_WANT_WRITE ? (UV_READABLE | UV_WRITABLE) : UV_READABLE);
+        }
+#       endif
+
+        send();
+        return;
+    }
+
+    if (!m_client->isQuiet()) {
+        LOG_ERR("[%s] TLS handshake failed: \"%s\"", m_client->url(), sslError());
+    }
+
+    removeSession(sessionKey());
+    m_client->close();
+}
+
+
+void xlarig::Client::Tls::read()
+{
+    int bytes_read = 0;
+    while (m_client->state() == ConnectedState && (bytes_read = SSL_read(m_ssl, m_buf, sizeof(m_buf))) > 0) {
+        m_buf[bytes_read - 1] = '\0';
+        m_client->parse(m_buf, static_cast<size_t>(bytes_read));
+    }
+
+    if (!m_direct || m_client->state() != ConnectedState) {
+        return;
+    }
+
+    const int error = SSL_get_error(m_ssl, bytes_read);
+    if (error == SSL_ERROR_WANT_READ || error == SSL_ERROR_WANT_WRITE) {
+        return;
+    }
+
+    if (!m_client->isQuiet()) {
+        LOG_ERR("[%s] read error: \"%s\"", m_client->url(), error == SSL_ERROR_ZERO_RETURN || error == SSL_ERROR_SYSCALL ? "end of file" : sslError());
+    }
+
+    m_client->close();
+}
+
+
+#ifdef XMRIG_FEATURE_KTLS
+void xlarig::Client::Tls::poll(int events)
+{
+    if (m_poll && events != m_events) {
+        m_events = events;
+        uv_poll_start(m_poll, events, Tls::onPoll);
+    }
+}
+
+
+void xlarig::Client::Tls::onPoll(uv_poll_t *handle, int status, int events)
+{
+    Client *client = getClient(handle->data);
+    if (!client || !client->m_tls || client->state() != ConnectedState) {
+        return;
+    }
+
+    Tls *tls = client->m_tls;
+
+    if (status < 0) {
+        if (!client->isQuiet()) {
+            LOG_ERR("[%s] read error: \"%s\"", client->url(), uv_strerror(status));
+        }
+
+        client->close();
+        return;
+    }
+
+    if (!SSL_is_init_finished(tls->m_ssl)) {
+        return tls->connect();
+    }
+
+    if ((events & UV_WRITABLE) && client->m_sendQueue.isWriting()) {
+        client->m_sendQueue.setWriting(false);
+        tls->flush();
+
+        if (!client->m_sendQueue.isWriting()) {
+            tls->poll(UV_READABLE);
+        }
+    }
+
+    if ((events & UV_READABLE) && client->state() == ConnectedState) {
+        tls->read();
+    }
+}
+#endif
+
+
+/**
+ * Keeps the latest session (TLS 1.3 ticket) per pool so the next connect can resume it.
+ */
+int xlarig::Client::Tls::onNewSession(SSL *ssl, SSL_SESSION *session)
+{
+    const Tls *tls = static_cast<const Tls *>(SSL_get_app_data(ssl));
+    if (!tls) {
+        return 0;
+    }
+
+    SSL_SESSION *&slot = sessions[tls->sessionKey()];
+    if (slot) {
+        SSL_SESSION_free(slot);
+    }
+
+    slot = session;
+
+    return 1;
+}
@@ -32,6 +32,11 @@
 #include "base/net/stratum/Client.h"
 
 
+#if defined(__linux__) && defined(SSL_OP_ENABLE_KTLS)
+#   define XMRIG_FEATURE_KTLS
+#endif
+
+
 namespace xlarig {
 
 
@@ -41,25 +46,42 @@ public:
     Tls(Client *client);
     ~Tls();
 
+    inline bool isDirect() const { return m_direct; }
+
     bool handshake();
     bool send(const char *data, size_t size);
     const char *fingerprint() const;
     const char *version() const;
+    void close();
+    void flush();
     void read(const char *data, size_t size);
 
 private:
     bool send();
     bool verify(X509 *cert);
     bool verifyFingerprint(X509 *cert);
+    String sessionKey() const;
+    void connect();
+    void read();
+
+#   ifdef XMRIG_FEATURE_KTLS
+    void poll(int events);
+
+    static void onPoll(uv_poll_t *handle, int status, int events);
+#   endif
+
+    static int onNewSession(SSL *ssl, SSL_SESSION *session);
 
     BIO *m_readBio;
     BIO *m_writeBio;
+    bool m_direct;
     bool m_ready;
     char m_buf[1024 * 2];
     char m_fingerprint[32 * 2 + 8];
     Client *m_client;
+    int m_events;
     SSL *m_ssl;
-    SSL_CTX *m_ctx;
+    uv_poll_t *m_poll;
 };
 
 
@@ -0,0 +1,288 @@
+/* XMRig and XLArig
+ * Copyright 2010      Jeff Garzik <jgarzik@pobox.com>
+ * Copyright 2012-2014 pooler      <pooler@litecoinpool.org>
+ * Copyright 2014      Lucas Jones <https://github.com/lucasjones>
+ * Copyright 2014-2016 Wolf9466    <https://github.com/OhGodAPet>
+ * Copyright 2016      Jay D Dee   <jayddee246@gmail.com>
+ * Copyright 2017-2018 XMR-Stak    <https://github.com/fireice-uk>, <https://github.com/psychocrypt>
+ * Copyright 2018-2019 SChernykh   <https://github.com/SChernykh>
+ * Copyright 2016-2019 XMRig       <https://github.com/xmrig>, <support@xmrig.com>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "base/io/log/Log.h"
+#include "base/kernel/interfaces/IStrategyListener.h"
+#include "base/net/stratum/Client.h"
+#include "base/net/stratum/strategies/HotStandbyStrategy.h"
+#include "base/net/stratum/SubmitResult.h"
+#include "base/tools/Chrono.h"
+#include "common/Platform.h"
+
+
+#ifdef XMRIG_FEATURE_HTTP
+#   include "base/net/stratum/DaemonClient.h"
+#endif
+
+
+namespace xlarig {
+
+
+static const double kSwitchMargin = 20.0;
+
+
+static inline void average(double &value, double sample)
+{
+    value += (sample - value) / 8.0;
+}
+
+
+} /* namespace xlarig */
+
+
+xlarig::HotStandbyStrategy::HotStandbyStrategy(int retryPause, bool fastest, IStrategyListener *listener, bool quiet) :
+    m_fastest(fastest),
+    m_quiet(quiet),
+    m_retryPause(retryPause),
+    m_active(-1),
+    m_listener(listener),
+    m_height(0),
+    m_heightTime(0)
+{
+}
+
+
+xlarig::HotStandbyStrategy::~HotStandbyStrategy()
+{
+    for (Upstream &upstream : m_pools) {
+        upstream.client->deleteLater();
+    }
+}
+
+
+void xlarig::HotStandbyStrategy::add(const Pool &pool)
+{
+    const int id = static_cast<int>(m_pools.size());
+
+#   ifdef XMRIG_FEATURE_HTTP
+    IClient *client = !pool.isDaemon() ? static_cast<IClient *>(new Client(id, Platform::userAgent(), this))
+                                       : static_cast<IClient *>(new DaemonClient(id, this));
+#   else
+    IClient *client = new Client(id, Platform::userAgent(), this);
+#   endif
+
+    client->setPool(pool);
+    client->setRetryPause(m_retryPause * 1000);
+    client->setQuiet(m_quiet);
+
+    m_pools.emplace_back(client);
+}
+
+
+int64_t xlarig::HotStandbyStrategy::submit(const JobResult &result)
+{
+    if (!isActive()) {
+        return -1;
+    }
+
+    return active()->submit(result);
+}
+
+
+void xlarig::HotStandbyStrategy::connect()
+{
+    for (Upstream &upstream : m_pools) {
+        upstream.client->connect();
+    }
+}
+
+
+void xlarig::HotStandbyStrategy::resume()
+{
+    if (!isActive()) {
+        return;
+    }
+
+    m_listener->onJob(this, active(), active()->job());
+}
+
+
+void xlarig::HotStandbyStrategy::setAlgo(const xlarig::Algorithm &algo)
+{
+    for (Upstream &upstream : m_pools) {
+        upstream.client->setAlgo(algo);
+    }
+}
+
+
+void xlarig::HotStandbyStrategy::stop()
+{
+    for (Upstream &upstream : m_pools) {
+        upstream.client->disconnect();
+        upstream.ready = false;
+    }
+
+    m_active = -1;
+
+    m_listener->onPause(this);
+}
+
+
+void xlarig::HotStandbyStrategy::tick(uint64_t now)
+{
+    for (Upstream &upstream : m_pools) {
+        upstream.client->tick(now);
+    }
+}
+
+
+void xlarig::HotStandbyStrategy::onClose(IClient *client, int failures)
+{
+    if (failures == -1) {
+        return;
+    }
+
+    m_pools[static_cast<size_t>(client->id())].ready = false;
+
+    if (m_active != client->id()) {
+        return;
+    }
+
+    const int index = select();
+    if (index >= 0) {
+        return setActive(index, true);
+    }
+
+    m_active = -1;
+    m_listener->onPause(this);
+}
+
+
+void xlarig::HotStandbyStrategy::onJobReceived(IClient *client, const Job &job, const rapidjson::Value &)
+{
+    update(m_pools[static_cast<size_t>(client->id())], job);
+
+    const int index = select();
+    if (index != m_active && index == client->id()) {
+        return setActive(index, true);
+    }
+
+    if (m_active == client->id()) {
+        m_listener->onJob(this, client, job);
+    }
+}
+
+
+void xlarig::HotStandbyStrategy::onLoginSuccess(IClient *client)
+{
+    m_pools[static_cast<size_t>(client->id())].ready = true;
+
+    if (m_fastest && isActive()) {
+        return;
+    }
+
+    const int index = select();
+    if (index >= 0 && index != m_active) {
+        setActive(index, index != client->id());
+    }
+}
+
+
+void xlarig::HotStandbyStrategy::onResultAccepted(IClient *client, const SubmitResult &result, const char *error)
+{
+    average(m_pools[static_cast<size_t>(client->id())].rtt, static_cast<double>(result.elapsed));
+
+    m_listener->onResultAccepted(this, client, result, error);
+}
+
+
+/**
+ * Best ready pool: the first one in config order, or in fastest mode the one with the lowest
+ * average job delay, the active pool is kept unless another one is ahead by a clear margin.
+ */
+int xlarig::HotStandbyStrategy::select() const
+{
+    int best = -1;
+
+    for (size_t i = 0; i < m_pools.size(); ++i) {
+        const Upstream &upstream = m_pools[i];
+        if (!upstream.ready) {
+            continue;
+        }
+
+        if (!m_fastest) {
+            return static_cast<int>(i);
+        }
+
+        if (best < 0 || upstream.delay < m_pools[static_cast<size_t>(best)].delay) {
+            best = static_cast<int>(i);
+        }
+    }
+
+    if (m_fastest && best >= 0 && isActive() && m_pools[static_cast<size_t>(m_active)].ready) {
+        if (m_pools[static_cast<size_t>(best)].delay + kSwitchMargin > m_pools[static_cast<size_t>(m_active)].delay) {
+            return m_active;
+        }
+    }
+
+    return best;
+}
+
+
+void xlarig::HotStandbyStrategy::setActive(int index, bool job)
+{
+    const Upstream &upstream = m_pools[static_cast<size_t>(index)];
+
+    if (isActive() && !m_quiet) {
+        LOG_INFO("switch to pool " WHITE_BOLD("%s:%d") " job delay " WHITE_BOLD("%.0f ms") " share rtt " WHITE_BOLD("%.0f ms"),
+                 upstream.client->pool().host().data(), upstream.client->pool().port(), upstream.delay, upstream.rtt);
+    }
+
+    m_active = index;
+    m_listener->onActive(this, upstream.client);
+
+    if (job && upstream.client->job().isValid()) {
+        m_listener->onJob(this, upstream.client, upstream.client->job());
+    }
+}
+
+
+/**
+ * Job delay is measured against the first pool that announced the same height, pools that
+ * never delivered the previous height are charged the whole time it was current.
+ */
+void xlarig::HotStandbyStrategy::update(Upstream &upstream, const Job &job)
+{
+    const uint64_t height = job.height();
+    if (height == 0 || height <= upstream.height) {
+        return;
+    }
+
+    const uint64_t now = Chrono::steadyMSecs();
+
+    if (height > m_height) {
+        for (Upstream &other : m_pools) {
+            if (other.ready && &other != &upstream && other.height < m_height) {
+                average(other.delay, static_cast<double>(now - m_heightTime));
+            }
+        }
+
+        m_height     = height;
+        m_heightTime = now;
+    }
+
+    average(upstream.delay, static_cast<double>(now - m_heightTime));
+    upstream.height = height;
+}
@@ -0,0 +1,104 @@
+/* XMRig and XLArig
+ * Copyright 2010      Jeff Garzik <jgarzik@pobox.com>
+ * Copyright 2012-2014 pooler      <pooler@litecoinpool.org>
+ * Copyright 2014      Lucas Jones <https://github.com/lucasjones>
+ * Copyright 2014-2016 Wolf9466    <https://github.com/OhGodAPet>
+ * Copyright 2016      Jay D Dee   <jayddee246@gmail.com>
+ * Copyright 2017-2018 XMR-Stak    <https://github.com/fireice-uk>, <https://github.com/psychocrypt>
+ * Copyright 2018-2019 SChernykh   <https://github.com/SChernykh>
+ * Copyright 2016-2019 XMRig       <https://github.com/xmrig>, <support@xmrig.com>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef XMRIG_HOTSTANDBYSTRATEGY_H
+#define XMRIG_HOTSTANDBYSTRATEGY_H
+
+
+#include <vector>
+
+
+#include "base/kernel/interfaces/IClientListener.h"
+#include "base/kernel/interfaces/IStrategy.h"
+#include "base/net/stratum/Pool.h"
+
+
+namespace xlarig {
+
+
+class IStrategyListener;
+
+
+/**
+ * Keeps every pool connected and logged in, so losing the active pool costs no retry pause.
+ * In the default mode the first ready pool in config order is used, with fastest enabled the
+ * pool that delivers jobs for a new height first wins.
+ */
+class HotStandbyStrategy : public IStrategy, public IClientListener
+{
+public:
+    HotStandbyStrategy(int retryPause, bool fastest, IStrategyListener *listener, bool quiet = false);
+    ~HotStandbyStrategy() override;
+
+    void add(const Pool &pool);
+
+protected:
+    inline bool isActive() const override                                              { return m_active >= 0; }
+    inline IClient *client() const override                                            { return isActive() ? active() : m_pools[0].client; }
+    inline void onLogin(IClient *, rapidjson::Document &, rapidjson::Value &) override {}
+
+    int64_t submit(const JobResult &result) override;
+    void connect() override;
+    void resume() override;
+    void setAlgo(const Algorithm &algo) override;
+    void stop() override;
+    void tick(uint64_t now) override;
+
+    void onClose(IClient *client, int failures) override;
+    void onJobReceived(IClient *client, const Job &job, const rapidjson::Value &params) override;
+    void onLoginSuccess(IClient *client) override;
+    void onResultAccepted(IClient *client, const SubmitResult &result, const char *error) override;
+
+private:
+    struct Upstream
+    {
+        inline Upstream(IClient *client) : client(client) {}
+
+        IClient *client;
+        bool ready      = false;
+        double delay    = 0.0;
+        double rtt      = 0.0;
+        uint64_t height = 0;
+    };
+
+    inline IClient *active() const { return m_pools[static_cast<size_t>(m_active)].client; }
+
+    int select() const;
+    void setActive(int index, bool job);
+    void update(Upstream &upstream, const Job &job);
+
+    const bool m_fastest;
+    const bool m_quiet;
+    const int m_retryPause;
+    int m_active;
+    IStrategyListener *m_listener;
+    std::vector<Upstream> m_pools;
+    uint64_t m_height;
+    uint64_t m_heightTime;
+};
+
+
+} /* namespace xlarig */
+
+#endif /* XMRIG_HOTSTANDBYSTRATEGY_H */
@@ -29,6 +29,15 @@
 #include <string.h>
 
 
+#ifndef XMRIG_ARM
+#   include <emmintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#   include <intrin.h>
+#endif
+
+
 #include "base/kernel/interfaces/ILineListener.h"
 
 
@@ -41,7 +50,8 @@ class RecvBuf
 public:
     inline RecvBuf() :
         m_buf(),
-        m_pos(0)
+        m_pos(0),
+        m_start(0)
     {
     }
 
@@ -52,17 +62,21 @@ public:
     inline size_t available() const    { return N - m_pos; }
     inline size_t pos() const          { return m_pos; }
     inline void nread(size_t size)     { m_pos += size; }
-    inline void reset()                { m_pos = 0; }
+    inline void reset()                { m_pos = 0; m_start = 0; }
 
     constexpr inline size_t size() const { return N; }
 
+    /**
+     * Lines are handed to the listener in place. A trailing partial line stays where it is and
+     * is only moved to the front once less than half of the buffer is left for the next read.
+     */
     inline void getline(ILineListener *listener)
     {
         char *end;
-        char *start = m_buf;
-        size_t remaining = m_pos;
+        char *start = m_buf + m_start;
+        size_t remaining = m_pos - m_start;
 
-        while ((end = static_cast<char*>(memchr(start, '\n', remaining))) != nullptr) {
+        while ((end = find(start, remaining)) != nullptr) {
             *end = '\0';
 
             end++;
@@ -75,21 +89,50 @@ public:
         }
 
         if (remaining == 0) {
-            m_pos = 0;
+            reset();
             return;
         }
 
-        if (start == m_buf) {
+        m_start = static_cast<size_t>(start - m_buf);
+
+        if (m_start == 0 || available() >= N / 2) {
             return;
         }
 
-        memcpy(m_buf, start, remaining);
-        m_pos = remaining;
+        memmove(m_buf, start, remaining);
+        m_pos   = remaining;
+        m_start = 0;
     }
 
 private:
+    static inline char *find(char *start, size_t size)
+    {
+        size_t i = 0;
+
+#       ifndef XMRIG_ARM
+        const __m128i lf = _mm_set1_epi8('\n');
+
+        for (; i + 16 <= size; i += 16) {
+            const int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(start + i)), lf));
+            if (mask != 0) {
+#               ifdef _MSC_VER
+                unsigned long offset;
+                _BitScanForward(&offset, static_cast<unsigned long>(mask));
+#               else
+                const int offset = __builtin_ctz(static_cast<unsigned int>(mask));
+#               endif
+
+                return start + i + offset;
+            }
+        }
+#       endif
+
+        return static_cast<char *>(memchr(start + i, '\n', size - i));
+    }
+
     char m_buf[N];
     size_t m_pos;
+    size_t m_start;
 };
 
 
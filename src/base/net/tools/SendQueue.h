@@ -0,0 +1,113 @@
+/* XMRig and XLArig
+ * Copyright 2010      Jeff Garzik <jgarzik@pobox.com>
+ * Copyright 2012-2014 pooler      <pooler@litecoinpool.org>
+ * Copyright 2014      Lucas Jones <https://github.com/lucasjones>
+ * Copyright 2014-2016 Wolf9466    <https://github.com/OhGodAPet>
+ * Copyright 2016      Jay D Dee   <jayddee246@gmail.com>
+ * Copyright 2017-2018 XMR-Stak    <https://github.com/fireice-uk>, <https://github.com/psychocrypt>
+ * Copyright 2018-2019 SChernykh   <https://github.com/SChernykh>
+ * Copyright 2016-2019 XMRig       <https://github.com/xmrig>, <support@xmrig.com>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef XMRIG_SENDQUEUE_H
+#define XMRIG_SENDQUEUE_H
+
+
+#include <uv.h>
+#include <vector>
+
+
+namespace xlarig {
+
+
+/**
+ * Outgoing bytes of one connection: lines appended while a write is in progress are coalesced
+ * into the next one, the two buffers keep their capacity so steady state sending doesn't allocate.
+ */
+template<size_t N>
+class SendQueue
+{
+public:
+    inline SendQueue() :
+        m_offset(0),
+        m_writing(false)
+    {
+    }
+
+    inline bool isEmpty() const   { return m_pending.empty(); }
+    inline bool isWriting() const { return m_writing; }
+    inline size_t size() const    { return m_pending.size() + m_active.size() - m_offset; }
+
+    inline bool append(const char *data, size_t size)
+    {
+        if (this->size() + size > N) {
+            return false;
+        }
+
+        m_pending.insert(m_pending.end(), data, data + size);
+
+        return true;
+    }
+
+    inline uv_buf_t take()
+    {
+        m_active.swap(m_pending);
+        m_pending.clear();
+        m_offset = 0;
+
+        return remaining();
+    }
+
+    inline uv_buf_t remaining()
+    {
+        return uv_buf_init(m_active.data() + m_offset, static_cast<unsigned int>(m_active.size() - m_offset));
+    }
+
+    inline bool consume(size_t size)
+    {
+        m_offset += size;
+        if (m_offset < m_active.size()) {
+            return false;
+        }
+
+        m_active.clear();
+        m_offset = 0;
+
+        return true;
+    }
+
+    inline void setWriting(bool writing) { m_writing = writing; }
+
+    inline void reset()
+    {
+        m_active.clear();
+        m_pending.clear();
+        m_offset  = 0;
+        m_writing = false;
+    }
+
+private:
+    size_t m_offset;
+    bool m_writing;
+    std::vector<char> m_active;
+    std::vector<char> m_pending;
+};
+
+
+} /* namespace xlarig */
+
+
+#endif /* XMRIG_SENDQUEUE_H */
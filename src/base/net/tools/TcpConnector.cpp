@@ -0,0 +1,246 @@
+/* XMRig and XLArig
+ * Copyright 2010      Jeff Garzik <jgarzik@pobox.com>
+ * Copyright 2012-2014 pooler      <pooler@litecoinpool.org>
+ * Copyright 2014      Lucas Jones <https://github.com/lucasjones>
+ * Copyright 2014-2016 Wolf9466    <https://github.com/OhGodAPet>
+ * Copyright 2016      Jay D Dee   <jayddee246@gmail.com>
+ * Copyright 2017-2018 XMR-Stak    <https://github.com/fireice-uk>, <https://github.com/psychocrypt>
+ * Copyright 2018-2019 SChernykh   <https://github.com/SChernykh>
+ * Copyright 2016-2019 XMRig       <https://github.com/xmrig>, <support@xmrig.com>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <algorithm>
+#include <stdio.h>
+#include <stdlib.h>
+
+
+#include "base/kernel/interfaces/ITcpConnectorListener.h"
+#include "base/net/dns/Dns.h"
+#include "base/net/tools/TcpConnector.h"
+#include "base/tools/Handle.h"
+#include "base/tools/Timer.h"
+
+
+namespace xlarig {
+
+
+std::map<String, String> TcpConnector::m_winners;
+Storage<TcpConnector> TcpConnector::m_storage;
+static const DnsRecord defaultRecord;
+
+
+static inline void shuffle(std::vector<DnsRecord> &records)
+{
+    if (records.size() > 1) {
+        std::rotate(records.begin(), records.begin() + static_cast<size_t>(rand()) % records.size(), records.end());
+    }
+}
+
+
+} /* namespace xlarig */
+
+
+xlarig::TcpConnector::TcpConnector(ITcpConnectorListener *listener) :
+    m_status(0),
+    m_listener(listener),
+    m_next(0),
+    m_timer(nullptr),
+    m_port(0)
+{
+    m_id    = m_storage.add(this);
+    m_timer = new Timer(this);
+}
+
+
+xlarig::TcpConnector::~TcpConnector()
+{
+    m_storage.release(m_id);
+
+    for (const Attempt &attempt : m_attempts) {
+        Handle::close(attempt.socket);
+    }
+
+    delete m_timer;
+}
+
+
+/**
+ * Cancels all pending attempts, the listener receives UV_ECANCELED once the last one is closed.
+ */
+bool xlarig::TcpConnector::abort()
+{
+    if (!isActive()) {
+        return false;
+    }
+
+    m_timer->stop();
+    m_next   = m_records.size();
+    m_status = UV_ECANCELED;
+
+    for (const Attempt &attempt : m_attempts) {
+        Handle::close(attempt.socket);
+    }
+
+    return true;
+}
+
+
+bool xlarig::TcpConnector::connect(const Dns &dns, uint16_t port)
+{
+    if (isActive() || dns.isEmpty()) {
+        return false;
+    }
+
+    char key[300];
+    snprintf(key, sizeof(key), "%s:%u", dns.host().data(), port);
+
+    m_key    = static_cast<const char *>(key);
+    m_port   = port;
+    m_next   = 0;
+    m_status = UV_EAI_NONAME;
+
+    std::vector<DnsRecord> ipv6 = dns.ipv6();
+    std::vector<DnsRecord> ipv4 = dns.ipv4();
+    shuffle(ipv6);
+    shuffle(ipv4);
+
+    m_records.clear();
+    m_records.reserve(ipv6.size() + ipv4.size());
+
+    for (size_t i = 0; i < std::max(ipv6.size(), ipv4.size()); ++i) {
+        if (i < ipv6.size()) {
+            m_records.push_back(ipv6[i]);
+        }
+
+        if (i < ipv4.size()) {
+            m_records.push_back(ipv4[i]);
+        }
+    }
+
+    const auto winner = m_winners.find(m_key);
+    if (winner != m_winners.end()) {
+        const auto it = std::find_if(m_records.begin(), m_records.end(), [&winner](const DnsRecord &record) { return record.ip() == winner->second; });
+        if (it != m_records.end()) {
+            std::rotate(m_records.begin(), it, it + 1);
+        }
+    }
+
+    next();
+
+    return true;
+}
+
+
+void xlarig::TcpConnector::onTimer(const Timer *)
+{
+    next();
+}
+
+
+void xlarig::TcpConnector::next()
+{
+    while (m_next < m_records.size()) {
+        const size_t index = m_next++;
+
+        uv_tcp_t *socket = new uv_tcp_t;
+        socket->data = m_storage.ptr(m_id);
+
+        uv_tcp_init(uv_default_loop(), socket);
+        uv_tcp_nodelay(socket, 1);
+
+#       ifndef WIN32
+        uv_tcp_keepalive(socket, 1, 60);
+#       endif
+
+        uv_connect_t *req = new uv_connect_t;
+        req->data = m_storage.ptr(m_id);
+
+        sockaddr *addr = m_records[index].addr(m_port);
+        const int rc   = uv_tcp_connect(req, socket, addr, onConnect);
+        delete addr;
+
+        if (rc == 0) {
+            m_attempts.push_back({ index, socket });
+
+            if (m_next < m_records.size()) {
+                m_timer->start(kAttemptDelay, 0);
+            }
+
+            return;
+        }
+
+        m_status = rc;
+
+        delete req;
+        Handle::close(socket);
+    }
+
+    if (m_attempts.empty()) {
+        m_listener->onConnect(nullptr, defaultRecord, m_status);
+    }
+}
+
+
+void xlarig::TcpConnector::onConnect(uv_tcp_t *socket, int status)
+{
+    const auto it = std::find_if(m_attempts.begin(), m_attempts.end(), [socket](const Attempt &attempt) { return attempt.socket == socket; });
+    if (it == m_attempts.end()) {
+        return;
+    }
+
+    const size_t index = it->index;
+    m_attempts.erase(it);
+
+    if (status < 0) {
+        if (m_status != UV_ECANCELED) {
+            m_status = status;
+        }
+
+        Handle::close(socket);
+
+        if (m_next < m_records.size()) {
+            m_timer->stop();
+        }
+
+        return next();
+    }
+
+    m_timer->stop();
+    m_next = m_records.size();
+
+    for (const Attempt &attempt : m_attempts) {
+        Handle::close(attempt.socket);
+    }
+
+    m_attempts.clear();
+    m_winners[m_key] = m_records[index].ip();
+
+    m_listener->onConnect(socket, m_records[index], 0);
+}
+
+
+void xlarig::TcpConnector::onConnect(uv_connect_t *req, int status)
+{
+    TcpConnector *connector = m_storage.get(req->data);
+    uv_tcp_t *socket        = reinterpret_cast<uv_tcp_t *>(req->handle);
+
+    delete req;
+
+    if (connector) {
+        connector->onConnect(socket, status);
+    }
+}
@@ -0,0 +1,100 @@
+/* XMRig and XLArig
+ * Copyright 2010      Jeff Garzik <jgarzik@pobox.com>
+ * Copyright 2012-2014 pooler      <pooler@litecoinpool.org>
+ * Copyright 2014      Lucas Jones <https://github.com/lucasjones>
+ * Copyright 2014-2016 Wolf9466    <https://github.com/OhGodAPet>
+ * Copyright 2016      Jay D Dee   <jayddee246@gmail.com>
+ * Copyright 2017-2018 XMR-Stak    <https://github.com/fireice-uk>, <https://github.com/psychocrypt>
+ * Copyright 2018-2019 SChernykh   <https://github.com/SChernykh>
+ * Copyright 2016-2019 XMRig       <https://github.com/xmrig>, <support@xmrig.com>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef XMRIG_TCPCONNECTOR_H
+#define XMRIG_TCPCONNECTOR_H
+
+
+#include <map>
+#include <uv.h>
+#include <vector>
+
+
+#include "base/kernel/interfaces/ITimerListener.h"
+#include "base/net/dns/DnsRecord.h"
+#include "base/net/tools/Storage.h"
+#include "base/tools/String.h"
+
+
+namespace xlarig {
+
+
+class Dns;
+class ITcpConnectorListener;
+class Timer;
+
+
+/**
+ * Races TCP connects across all resolved addresses (RFC 8305): families are interleaved starting
+ * with IPv6, a new attempt starts every kAttemptDelay ms or as soon as the previous one fails, and
+ * the first established connection wins. The winning address is remembered per host:port and
+ * tried first next time.
+ */
+class TcpConnector : public ITimerListener
+{
+public:
+    constexpr static uint64_t kAttemptDelay = 250;
+
+    TcpConnector(ITcpConnectorListener *listener);
+    ~TcpConnector() override;
+
+    inline bool isActive() const { return !m_attempts.empty(); }
+
+    bool abort();
+    bool connect(const Dns &dns, uint16_t port);
+
+protected:
+    void onTimer(const Timer *timer) override;
+
+private:
+    struct Attempt
+    {
+        size_t index;
+        uv_tcp_t *socket;
+    };
+
+    void next();
+    void onConnect(uv_tcp_t *socket, int status);
+
+    static void onConnect(uv_connect_t *req, int status);
+
+    int m_status;
+    ITcpConnectorListener *m_listener;
+    size_t m_next;
+    std::vector<Attempt> m_attempts;
+    std::vector<DnsRecord> m_records;
+    String m_key;
+    Timer *m_timer;
+    uint16_t m_port;
+    uintptr_t m_id;
+
+    static std::map<String, String> m_winners;
+    static Storage<TcpConnector> m_storage;
+};
+
+
+} /* namespace xlarig */
+
+
+#endif /* XMRIG_TCPCONNECTOR_H */
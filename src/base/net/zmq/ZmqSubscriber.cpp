@@ -0,0 +1,402 @@
+/* XMRig and XLArig
+ * Copyright 2010      Jeff Garzik <jgarzik@pobox.com>
+ * Copyright 2012-2014 pooler      <pooler@litecoinpool.org>
+ * Copyright 2014      Lucas Jones <https://github.com/lucasjones>
+ * Copyright 2014-2016 Wolf9466    <https://github.com/OhGodAPet>
+ * Copyright 2016      Jay D Dee   <jayddee246@gmail.com>
+ * Copyright 2017-2018 XMR-Stak    <https://github.com/fireice-uk>, <https://github.com/psychocrypt>
+ * Copyright 2018-2019 SChernykh   <https://github.com/SChernykh>
+ * Copyright 2016-2019 XMRig       <https://github.com/xmrig>, <support@xmrig.com>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include <algorithm>
+#include <string.h>
+
+
+#include "base/io/log/Log.h"
+#include "base/kernel/interfaces/IZmqListener.h"
+#include "base/net/dns/Dns.h"
+#include "base/net/tools/TcpConnector.h"
+#include "base/net/zmq/ZmqSubscriber.h"
+#include "base/tools/Baton.h"
+#include "base/tools/Handle.h"
+#include "base/tools/Timer.h"
+
+
+namespace xlarig {
+
+
+Storage<ZmqSubscriber> ZmqSubscriber::m_storage;
+
+
+static constexpr size_t kGreetingSize   = 64;
+static constexpr size_t kReadChunk      = 16 * 1024;
+static constexpr uint8_t kFlagMore      = 0x01;
+static constexpr uint8_t kFlagLong      = 0x02;
+static constexpr uint8_t kFlagCommand   = 0x04;
+
+
+class ZmqWriteBaton : public Baton<uv_write_t>
+{
+public:
+    inline ZmqWriteBaton(const std::vector<char> &data) :
+        m_data(data)
+    {
+        buf = uv_buf_init(m_data.data(), static_cast<unsigned int>(m_data.size()));
+    }
+
+    inline static void onWrite(uv_write_t *req, int) { delete reinterpret_cast<ZmqWriteBaton *>(req->data); }
+
+    uv_buf_t buf;
+
+private:
+    std::vector<char> m_data;
+};
+
+
+static void addFrame(std::vector<char> &out, uint8_t flags, const char *data, size_t size)
+{
+    if (size > 255) {
+        out.push_back(static_cast<char>(flags | kFlagLong));
+
+        for (int i = 7; i >= 0; --i) {
+            out.push_back(static_cast<char>((static_cast<uint64_t>(size) >> (i * 8)) & 0xFF));
+        }
+    }
+    else {
+        out.push_back(static_cast<char>(flags));
+        out.push_back(static_cast<char>(size));
+    }
+
+    out.insert(out.end(), data, data + size);
+}
+
+
+} /* namespace xlarig */
+
+
+xlarig::ZmqSubscriber::ZmqSubscriber(const String &host, uint16_t port, const char *topic, IZmqListener *listener) :
+    m_greeting(false),
+    m_ready(false),
+    m_status(0),
+    m_listener(listener),
+    m_size(0),
+    m_host(host),
+    m_topic(topic),
+    m_port(port),
+    m_socket(nullptr)
+{
+    m_key       = m_storage.add(this);
+    m_dns       = new Dns(this);
+    m_connector = new TcpConnector(this);
+    m_timer     = new Timer(this);
+}
+
+
+xlarig::ZmqSubscriber::~ZmqSubscriber()
+{
+    m_storage.release(m_key);
+
+    delete m_timer;
+    delete m_connector;
+    delete m_dns;
+
+    Handle::close(m_socket);
+}
+
+
+void xlarig::ZmqSubscriber::connect()
+{
+    if (m_socket || m_connector->isActive()) {
+        return;
+    }
+
+    if (!m_dns->resolve(m_host)) {
+        LOG_DEBUG_ERR("[%s:%u] ZMQ getaddrinfo error: \"%s\"", m_host.data(), m_port, uv_strerror(m_dns->status()));
+
+        m_timer->start(kRetryPause, 0);
+    }
+}
+
+
+void xlarig::ZmqSubscriber::onConnect(uv_tcp_t *socket, const DnsRecord &, int status)
+{
+    if (status < 0) {
+        if (status != UV_ECANCELED) {
+            LOG_DEBUG_ERR("[%s:%u] ZMQ connect error: \"%s\"", m_host.data(), m_port, uv_strerror(status));
+
+            m_timer->start(kRetryPause, 0);
+        }
+
+        return;
+    }
+
+    m_socket       = socket;
+    m_socket->data = m_storage.ptr(m_key);
+
+    uv_read_start(reinterpret_cast<uv_stream_t *>(m_socket), onAllocBuffer, onRead);
+
+    // Greeting, READY command and subscription are sent at once, ZMTP 3.0 allows not waiting for the peer greeting.
+    std::vector<char> data(kGreetingSize, 0);
+    data[0]  = static_cast<char>(0xFF);
+    data[9]  = 0x7F;
+    data[10] = 3;
+    memcpy(data.data() + 12, "NULL", 4);
+
+    static const char ready[] = "\x05READY\x0BSocket-Type\x00\x00\x00\x03SUB";
+    addFrame(data, kFlagCommand, ready, sizeof(ready) - 1);
+
+    std::vector<char> subscribe(1, 1);
+    subscribe.insert(subscribe.end(), m_topic.data(), m_topic.data() + m_topic.size());
+    addFrame(data, 0, subscribe.data(), subscribe.size());
+
+    write(data);
+}
+
+
+void xlarig::ZmqSubscriber::onResolved(const Dns &dns, int status)
+{
+    if (status < 0 && dns.isEmpty()) {
+        LOG_DEBUG_ERR("[%s:%u] ZMQ DNS error: \"%s\"", m_host.data(), m_port, uv_strerror(status));
+
+        m_timer->start(kRetryPause, 0);
+        return;
+    }
+
+    m_connector->connect(dns, m_port);
+}
+
+
+void xlarig::ZmqSubscriber::onTimer(const Timer *)
+{
+    connect();
+}
+
+
+bool xlarig::ZmqSubscriber::parse()
+{
+    const uint8_t *data = reinterpret_cast<const uint8_t *>(m_recvBuf.data());
+    size_t pos          = 0;
+
+    if (!m_greeting) {
+        if (m_size < kGreetingSize) {
+            return true;
+        }
+
+        if (data[0] != 0xFF || data[9] != 0x7F || data[10] < 3 || memcmp(data + 12, "NULL", 5) != 0) {
+            LOG_DEBUG_ERR("[%s:%u] ZMQ unsupported peer greeting", m_host.data(), m_port);
+
+            return false;
+        }
+
+        m_greeting = true;
+        pos        = kGreetingSize;
+    }
+
+    while (m_size - pos >= 2) {
+        const uint8_t flags = data[pos];
+        size_t header       = 2;
+        uint64_t size       = data[pos + 1];
+
+        if (flags & kFlagLong) {
+            if (m_size - pos < 9) {
+                break;
+            }
+
+            header = 9;
+            size   = 0;
+
+            for (size_t i = 1; i < header; ++i) {
+                size = (size << 8) | data[pos + i];
+            }
+        }
+
+        if (size > kMaxMessageSize) {
+            return false;
+        }
+
+        if (m_size - pos - header < size) {
+            break;
+        }
+
+        const char *body = reinterpret_cast<const char *>(data + pos + header);
+        pos += header + size;
+
+        if (flags & kFlagCommand) {
+            if (!parseCommand(body, size)) {
+                return false;
+            }
+
+            continue;
+        }
+
+        if (m_message.size() + size > kMaxMessageSize) {
+            return false;
+        }
+
+        m_message.insert(m_message.end(), body, body + size);
+
+        if (!(flags & kFlagMore)) {
+            m_listener->onZmqMessage(m_message.data(), m_message.size());
+            m_message.clear();
+        }
+    }
+
+    if (pos) {
+        m_size -= pos;
+        memmove(m_recvBuf.data(), m_recvBuf.data() + pos, m_size);
+    }
+
+    return true;
+}
+
+
+bool xlarig::ZmqSubscriber::parseCommand(const char *data, size_t size)
+{
+    const size_t len = size ? static_cast<uint8_t>(data[0]) : 0;
+    if (!len || len >= size) {
+        return false;
+    }
+
+    if (len == 5 && memcmp(data + 1, "READY", 5) == 0) {
+        LOG_DEBUG("[%s:%u] ZMQ subscribed to \"%s\"", m_host.data(), m_port, m_topic.data());
+
+        m_ready = true;
+        m_listener->onZmqReady();
+
+        return true;
+    }
+
+    if (len == 5 && memcmp(data + 1, "ERROR", 5) == 0) {
+        LOG_DEBUG_ERR("[%s:%u] ZMQ error: \"%.*s\"", m_host.data(), m_port, size > 6 ? static_cast<int>(std::min<size_t>(static_cast<uint8_t>(data[6]), size - 7)) : 0, data + 7);
+
+        return false;
+    }
+
+    return true;
+}
+
+
+void xlarig::ZmqSubscriber::close(int status)
+{
+    if (!m_socket) {
+        return;
+    }
+
+    m_status = status;
+
+    if (uv_is_closing(reinterpret_cast<uv_handle_t *>(m_socket)) == 0) {
+        uv_close(reinterpret_cast<uv_handle_t *>(m_socket), ZmqSubscriber::onClose);
+    }
+}
+
+
+void xlarig::ZmqSubscriber::onClose()
+{
+    delete m_socket;
+    m_socket = nullptr;
+
+    const bool ready = m_ready;
+
+    m_greeting = false;
+    m_ready    = false;
+    m_size     = 0;
+    m_message.clear();
+
+    m_timer->start(kRetryPause, 0);
+
+    if (ready) {
+        m_listener->onZmqClose(m_status);
+    }
+}
+
+
+void xlarig::ZmqSubscriber::read(ssize_t nread)
+{
+    if (nread < 0) {
+        LOG_DEBUG_ERR("[%s:%u] ZMQ read error: \"%s\"", m_host.data(), m_port, uv_strerror(static_cast<int>(nread)));
+
+        return close(static_cast<int>(nread));
+    }
+
+    m_size += static_cast<size_t>(nread);
+
+    if (!parse()) {
+        close(UV_EPROTO);
+    }
+}
+
+
+void xlarig::ZmqSubscriber::write(const std::vector<char> &data)
+{
+    auto baton = new ZmqWriteBaton(data);
+
+    const int rc = uv_write(&baton->req, reinterpret_cast<uv_stream_t *>(m_socket), &baton->buf, 1, ZmqWriteBaton::onWrite);
+
+    if (rc < 0) {
+        delete baton;
+        close(rc);
+    }
+}
+
+
+void xlarig::ZmqSubscriber::onAllocBuffer(uv_handle_t *handle, size_t, uv_buf_t *buf)
+{
+    auto subscriber = m_storage.get(handle->data);
+    if (!subscriber) {
+        buf->base = nullptr;
+        buf->len  = 0;
+
+        return;
+    }
+
+    auto &recvBuf = subscriber->m_recvBuf;
+    if (recvBuf.size() < subscriber->m_size + kReadChunk) {
+        recvBuf.resize(subscriber->m_size + kReadChunk);
+    }
+
+    buf->base = recvBuf.data() + subscriber->m_size;
+
+#   ifdef _WIN32
+    buf->len = static_cast<ULONG>(recvBuf.size() - subscriber->m_size);
+#   else
+    buf->len = recvBuf.size() - subscriber->m_size;
+#   endif
+}
+
+
+void xlarig::ZmqSubscriber::onClose(uv_handle_t *handle)
+{
+    auto subscriber = m_storage.get(handle->data);
+    if (!subscriber) {
+        delete reinterpret_cast<uv_tcp_t *>(handle);
+
+        return;
+    }
+
+    subscriber->onClose();
+}
+
+
+void xlarig::ZmqSubscriber::onRead(uv_stream_t *stream, ssize_t nread, const uv_buf_t *)
+{
+    auto subscriber = m_storage.get(stream->data);
+    if (subscriber && nread != 0) {
+        subscriber->read(nread);
+    }
+}
@@ -0,0 +1,107 @@
+/* XMRig and XLArig
+ * Copyright 2010      Jeff Garzik <jgarzik@pobox.com>
+ * Copyright 2012-2014 pooler      <pooler@litecoinpool.org>
+ * Copyright 2014      Lucas Jones <https://github.com/lucasjones>
+ * Copyright 2014-2016 Wolf9466    <https://github.com/OhGodAPet>
+ * Copyright 2016      Jay D Dee   <jayddee246@gmail.com>
+ * Copyright 2017-2018 XMR-Stak    <https://github.com/fireice-uk>, <https://github.com/psychocrypt>
+ * Copyright 2018-2019 SChernykh   <https://github.com/SChernykh>
+ * Copyright 2016-2019 XMRig       <https://github.com/xmrig>, <support@xmrig.com>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef XMRIG_ZMQSUBSCRIBER_H
+#define XMRIG_ZMQSUBSCRIBER_H
+
+
+#include <uv.h>
+#include <vector>
+
+
+#include "base/kernel/interfaces/IDnsListener.h"
+#include "base/kernel/interfaces/ITcpConnectorListener.h"
+#include "base/kernel/interfaces/ITimerListener.h"
+#include "base/net/tools/Storage.h"
+#include "base/tools/String.h"
+
+
+namespace xlarig {
+
+
+class Dns;
+class IZmqListener;
+class TcpConnector;
+class Timer;
+
+
+/**
+ * Minimal ZMTP 3.0 SUB socket (NULL security mechanism) for daemon notifications like monerod's
+ * "json-minimal-chain_main", reconnects every kRetryPause ms until deleted.
+ */
+class ZmqSubscriber : public IDnsListener, public ITcpConnectorListener, public ITimerListener
+{
+public:
+    constexpr static size_t kMaxMessageSize = 1024 * 1024;
+    constexpr static uint64_t kRetryPause   = 5000;
+
+    ZmqSubscriber(const String &host, uint16_t port, const char *topic, IZmqListener *listener);
+    ~ZmqSubscriber() override;
+
+    inline bool isReady() const { return m_ready; }
+
+    void connect();
+
+protected:
+    void onConnect(uv_tcp_t *socket, const DnsRecord &record, int status) override;
+    void onResolved(const Dns &dns, int status) override;
+    void onTimer(const Timer *timer) override;
+
+private:
+    bool parse();
+    bool parseCommand(const char *data, size_t size);
+    void close(int status);
+    void onClose();
+    void read(ssize_t nread);
+    void write(const std::vector<char> &data);
+
+    static void onAllocBuffer(uv_handle_t *handle, size_t suggested_size, uv_buf_t *buf);
+    static void onClose(uv_handle_t *handle);
+    static void onRead(uv_stream_t *stream, ssize_t nread, const uv_buf_t *buf);
+
+    bool m_greeting;
+    bool m_ready;
+    Dns *m_dns;
+    int m_status;
+    IZmqListener *m_listener;
+    size_t m_size;
+    std::vector<char> m_message;
+    std::vector<char> m_recvBuf;
+    String m_host;
+    String m_topic;
+    TcpConnector *m_connector;
+    Timer *m_timer;
+    uint16_t m_port;
+    uintptr_t m_key;
+    uv_tcp_t *m_socket;
+
+    static Storage<ZmqSubscriber> m_storage;
+};
+
+
+} /* namespace xlarig */
+
+
+#endif /* XMRIG_ZMQSUBSCRIBER_H */
@@ -23,6 +23,11 @@
  */
 
 
+#ifndef XMRIG_ARM
+#   include <emmintrin.h>
+#endif
+
+
 #include "base/tools/Buffer.h"
 
 
@@ -53,6 +58,54 @@ static inline uint8_t hf_bin2hex(uint8_t c)
 }
 
 
+#ifndef XMRIG_ARM
+static inline __m128i hf_bin2hex(__m128i nibbles)
+{
+    const __m128i letters = _mm_and_si128(_mm_cmpgt_epi8(nibbles, _mm_set1_epi8(9)), _mm_set1_epi8('a' - 0xA - '0'));
+
+    return _mm_add_epi8(_mm_add_epi8(nibbles, _mm_set1_epi8('0')), letters);
+}
+
+
+/**
+ * 16 input bytes to 32 hex digits: split the nibbles, interleave high before low, map to ASCII.
+ */
+static inline void hf_bin2hex16(const uint8_t *in, uint8_t *out)
+{
+    const __m128i mask = _mm_set1_epi8(0x0F);
+    const __m128i x    = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in));
+    const __m128i hi   = _mm_and_si128(_mm_srli_epi16(x, 4), mask);
+    const __m128i lo   = _mm_and_si128(x, mask);
+
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out),      hf_bin2hex(_mm_unpacklo_epi8(hi, lo)));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 16), hf_bin2hex(_mm_unpackhi_epi8(hi, lo)));
+}
+
+
+/**
+ * 16 hex digits to 8 bytes, returns false if any of them is not a hex digit.
+ */
+static inline bool hf_hex2bin16(const uint8_t *in, uint8_t *out)
+{
+    const __m128i x     = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in));
+    const __m128i lower = _mm_or_si128(x, _mm_set1_epi8(0x20));
+    const __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(x, _mm_set1_epi8('0' - 1)), _mm_cmplt_epi8(x, _mm_set1_epi8('9' + 1)));
+    const __m128i alpha = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)), _mm_cmplt_epi8(lower, _mm_set1_epi8('f' + 1)));
+
+    if (_mm_movemask_epi8(_mm_or_si128(digit, alpha)) != 0xFFFF) {
+        return false;
+    }
+
+    const __m128i v = _mm_or_si128(_mm_and_si128(digit, _mm_sub_epi8(x, _mm_set1_epi8('0'))), _mm_and_si128(alpha, _mm_sub_epi8(lower, _mm_set1_epi8('a' - 0xA))));
+    const __m128i b = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(v, _mm_set1_epi16(0xFF)), 4), _mm_srli_epi16(v, 8));
+
+    _mm_storel_epi64(reinterpret_cast<__m128i *>(out), _mm_packus_epi16(b, b));
+
+    return true;
+}
+#endif
+
+
 xlarig::Buffer::Buffer() :
     m_data(nullptr),
     m_size(0)
@@ -122,8 +175,18 @@ xlarig::Buffer xlarig::Buffer::allocUnsafe(size_t size)
 
 bool xlarig::Buffer::fromHex(const uint8_t *in, size_t size, uint8_t *out)
 {
+    size_t i = 0;
+
+#   ifndef XMRIG_ARM
+    for (; i + 16 <= size; i += 16) {
+        if (!hf_hex2bin16(in + i, out + i / 2)) {
+            return false;
+        }
+    }
+#   endif
+
     bool error = false;
-    for (size_t i = 0; i < size; i += 2) {
+    for (; i < size; i += 2) {
         out[i / 2] = static_cast<uint8_t>((hf_hex2bin(in[i], error) << 4) | hf_hex2bin(in[i + 1], error));
 
         if (error) {
@@ -150,7 +213,15 @@ xlarig::Buffer xlarig::Buffer::fromHex(const char *data, size_t size)
 
 void xlarig::Buffer::toHex(const uint8_t *in, size_t size, uint8_t *out)
 {
-    for (size_t i = 0; i < size; i++) {
+    size_t i = 0;
+
+#   ifndef XMRIG_ARM
+    for (; i + 16 <= size; i += 16) {
+        hf_bin2hex16(in + i, out + i * 2);
+    }
+#   endif
+
+    for (; i < size; i++) {
         out[i * 2]     = hf_bin2hex((in[i] & 0xF0) >> 4);
         out[i * 2 + 1] = hf_bin2hex(in[i] & 0x0F);
     }
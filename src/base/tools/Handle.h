@@ -66,6 +66,16 @@ inline void Handle::close(uv_timer_t *handle)
 }
 
 
+template<>
+inline void Handle::close(uv_idle_t *handle)
+{
+    if (handle) {
+        uv_idle_stop(handle);
+        deleteLater(handle);
+    }
+}
+
+
 template<>
 inline void Handle::close(uv_signal_t *handle)
 {
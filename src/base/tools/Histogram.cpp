@@ -0,0 +1,116 @@
+/* XMRig and XLArig
+ * Copyright 2010      Jeff Garzik <jgarzik@pobox.com>
+ * Copyright 2012-2014 pooler      <pooler@litecoinpool.org>
+ * Copyright 2014      Lucas Jones <https://github.com/lucasjones>
+ * Copyright 2014-2016 Wolf9466    <https://github.com/OhGodAPet>
+ * Copyright 2016      Jay D Dee   <jayddee246@gmail.com>
+ * Copyright 2017-2018 XMR-Stak    <https://github.com/fireice-uk>, <https://github.com/psychocrypt>
+ * Copyright 2018-2019 SChernykh   <https://github.com/SChernykh>
+ * Copyright 2016-2019 XMRig       <https://github.com/xmrig>, <support@xmrig.com>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include <math.h>
+#include <string.h>
+
+
+#include "base/tools/Histogram.h"
+
+
+xlarig::Histogram::Histogram()
+{
+    reset();
+}
+
+
+uint32_t xlarig::Histogram::quantile(double q) const
+{
+    if (m_count == 0) {
+        return 0;
+    }
+
+    const uint64_t rank = q >= 1.0 ? m_count : static_cast<uint64_t>(ceil(q * static_cast<double>(m_count)));
+    uint64_t seen       = 0;
+
+    for (size_t i = 0; i < kBuckets; ++i) {
+        seen += m_buckets[i];
+
+        if (seen >= rank && seen > 0) {
+            const uint32_t v = value(i);
+
+            return v < m_max ? v : m_max;
+        }
+    }
+
+    return m_max;
+}
+
+
+void xlarig::Histogram::add(uint64_t value)
+{
+    const uint32_t v = value > 0xFFFFFFFFULL ? 0xFFFFFFFFU : static_cast<uint32_t>(value);
+
+    m_buckets[index(v)]++;
+    m_count++;
+
+    if (v > m_max) {
+        m_max = v;
+    }
+}
+
+
+void xlarig::Histogram::reset()
+{
+    memset(m_buckets, 0, sizeof(m_buckets));
+
+    m_max   = 0;
+    m_count = 0;
+}
+
+
+size_t xlarig::Histogram::index(uint32_t value)
+{
+    if (value < kLinear) {
+        return value;
+    }
+
+    uint32_t exp = kLinearBits;
+    while (exp < 31 && (value >> (exp + 1)) != 0) {
+        exp++;
+    }
+
+    const uint32_t sub = (value >> (exp - kSubBits)) & ((1U << kSubBits) - 1);
+
+    return kLinear + (exp - kLinearBits) * (1U << kSubBits) + sub;
+}
+
+
+/**
+ * Midpoint of the bucket, the representative value reported for quantiles.
+ */
+uint32_t xlarig::Histogram::value(size_t index)
+{
+    if (index < kLinear) {
+        return static_cast<uint32_t>(index);
+    }
+
+    const uint32_t exp   = static_cast<uint32_t>((index - kLinear) >> kSubBits) + kLinearBits;
+    const uint32_t sub   = static_cast<uint32_t>((index - kLinear) & ((1U << kSubBits) - 1));
+    const uint64_t width = 1ULL << (exp - kSubBits);
+
+    return static_cast<uint32_t>((1ULL << exp) + sub * width + width / 2);
+}
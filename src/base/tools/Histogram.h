@@ -0,0 +1,72 @@
+/* XMRig and XLArig
+ * Copyright 2010      Jeff Garzik <jgarzik@pobox.com>
+ * Copyright 2012-2014 pooler      <pooler@litecoinpool.org>
+ * Copyright 2014      Lucas Jones <https://github.com/lucasjones>
+ * Copyright 2014-2016 Wolf9466    <https://github.com/OhGodAPet>
+ * Copyright 2016      Jay D Dee   <jayddee246@gmail.com>
+ * Copyright 2017-2018 XMR-Stak    <https://github.com/fireice-uk>, <https://github.com/psychocrypt>
+ * Copyright 2018-2019 SChernykh   <https://github.com/SChernykh>
+ * Copyright 2016-2019 XMRig       <https://github.com/xmrig>, <support@xmrig.com>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef XMRIG_HISTOGRAM_H
+#define XMRIG_HISTOGRAM_H
+
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+namespace xlarig {
+
+
+/**
+ * Fixed size log-linear histogram (HDR style) for millisecond timings: values below 64 are exact,
+ * above that every power of two is split into 32 buckets, so quantiles are within ~3% of the
+ * true value while memory and query cost stay constant however many samples are added.
+ */
+class Histogram
+{
+public:
+    Histogram();
+
+    inline uint32_t max() const   { return m_max; }
+    inline uint64_t count() const { return m_count; }
+
+    uint32_t quantile(double q) const;
+    void add(uint64_t value);
+    void reset();
+
+private:
+    constexpr static uint32_t kLinear     = 64;
+    constexpr static uint32_t kLinearBits = 6;
+    constexpr static uint32_t kSubBits    = 5;
+    constexpr static size_t kBuckets      = kLinear + (32 - kLinearBits) * (1U << kSubBits);
+
+    static size_t index(uint32_t value);
+    static uint32_t value(size_t index);
+
+    uint32_t m_buckets[kBuckets];
+    uint32_t m_max;
+    uint64_t m_count;
+};
+
+
+} /* namespace xlarig */
+
+
+#endif /* XMRIG_HISTOGRAM_H */
@@ -44,8 +44,17 @@
 #   define bit_AVX2 (1 << 5)
 #endif
 
+#ifndef bit_SSSE3
+#   define bit_SSSE3 (1 << 9)
+#endif
+
+#ifndef bit_AVX512F
+#   define bit_AVX512F (1 << 16)
+#endif
+
 
 #include "common/cpu/BasicCpuInfo.h"
+#include "common/cpu/Xgetbv.h"
 
 
 #define VENDOR_ID                  (0)
@@ -111,6 +120,15 @@ static inline bool has_avx2()
 }
 
 
+static inline bool has_ssse3()
+{
+    int32_t cpu_info[4] = { 0 };
+    cpuid(PROCESSOR_INFO, cpu_info);
+
+    return (cpu_info[ECX_Reg] & bit_SSSE3) != 0;
+}
+
+
 static inline bool has_ossave()
 {
     int32_t cpu_info[4] = { 0 };
@@ -120,10 +138,22 @@ static inline bool has_ossave()
 }
 
 
+// AVX-512F and the OS saves opmask and ZMM registers (XCR0 bits 1, 2, 5, 6 and 7)
+static inline bool has_avx512()
+{
+    int32_t cpu_info[4] = { 0 };
+    cpuid(EXTENDED_FEATURES, cpu_info);
+
+    return (cpu_info[EBX_Reg] & bit_AVX512F) != 0 && has_ossave() && (xlarig::xgetbv() & 0xe6) == 0xe6;
+}
+
+
 xlarig::BasicCpuInfo::BasicCpuInfo() :
     m_assembly(ASM_NONE),
     m_aes(has_aes_ni()),
     m_avx2(has_avx2() && has_ossave()),
+    m_avx512(has_avx512()),
+    m_ssse3(has_ssse3()),
     m_brand(),
     m_threads(std::thread::hardware_concurrency())
 {
@@ -38,6 +38,8 @@
 xlarig::BasicCpuInfo::BasicCpuInfo() :
     m_aes(false),
     m_avx2(false),
+    m_avx512(false),
+    m_ssse3(false),
     m_brand(),
     m_threads(std::thread::hardware_concurrency())
 {
@@ -27,11 +27,21 @@
 
 #include "common/cpu/BasicCpuInfo.h"
 #include "common/cpu/Cpu.h"
+#include "common/cpu/CpuTopology.h"
 
 
+static xlarig::CpuTopology *cpuTopology = nullptr;
 static xlarig::ICpuInfo *cpuInfo = nullptr;
 
 
+const xlarig::CpuTopology *xlarig::Cpu::topology()
+{
+    assert(cpuTopology != nullptr);
+
+    return cpuTopology;
+}
+
+
 xlarig::ICpuInfo *xlarig::Cpu::info()
 {
     assert(cpuInfo != nullptr);
@@ -45,6 +55,9 @@ void xlarig::Cpu::init()
     assert(cpuInfo == nullptr);
 
     cpuInfo = new BasicCpuInfo();
+
+    cpuTopology = new CpuTopology();
+    cpuTopology->read();
 }
 
 
@@ -54,4 +67,7 @@ void xlarig::Cpu::release()
 
     delete cpuInfo;
     cpuInfo = nullptr;
+
+    delete cpuTopology;
+    cpuTopology = nullptr;
 }
@@ -31,9 +31,13 @@
 namespace xlarig {
 
 
+class CpuTopology;
+
+
 class Cpu
 {
 public:
+    static const CpuTopology *topology();
     static ICpuInfo *info();
     static void init();
     static void release();
@@ -0,0 +1,477 @@
+/* XMRig and XLArig
+ * Copyright 2010      Jeff Garzik <jgarzik@pobox.com>
+ * Copyright 2012-2014 pooler      <pooler@litecoinpool.org>
+ * Copyright 2014      Lucas Jones <https://github.com/lucasjones>
+ * Copyright 2014-2016 Wolf9466    <https://github.com/OhGodAPet>
+ * Copyright 2016      Jay D Dee   <jayddee246@gmail.com>
+ * Copyright 2017-2018 XMR-Stak    <https://github.com/fireice-uk>, <https://github.com/psychocrypt>
+ * Copyright 2018-2019 SChernykh   <https://github.com/SChernykh>
+ * Copyright 2016-2019 XMRig       <https://github.com/xmrig>, <support@xmrig.com>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+#include "base/io/log/Log.h"
+#include "common/cpu/CpuTopology.h"
+#include "crypto/cn/CryptoNight_constants.h"
+#include "interfaces/IThread.h"
+
+
+namespace xlarig {
+
+
+static bool readLine(const char *fileName, char *buf, size_t size)
+{
+    FILE *fp = fopen(fileName, "r");
+    if (!fp) {
+        return false;
+    }
+
+    const bool rc = fgets(buf, static_cast<int>(size), fp) != nullptr;
+    fclose(fp);
+
+    if (rc) {
+        buf[strcspn(buf, "\r\n")] = '\0';
+    }
+
+    return rc;
+}
+
+
+static bool readInt(const char *fileName, int32_t &value)
+{
+    char buf[32];
+    if (!readLine(fileName, buf, sizeof buf)) {
+        return false;
+    }
+
+    value = static_cast<int32_t>(strtol(buf, nullptr, 10));
+    return true;
+}
+
+
+// Parses kernel cpu lists, for example "0-3,8,10-11".
+static std::vector<int32_t> parseList(const char *list)
+{
+    std::vector<int32_t> out;
+    const char *p = list;
+
+    while (*p) {
+        char *end = nullptr;
+        const long first = strtol(p, &end, 10);
+        if (end == p) {
+            break;
+        }
+
+        long last = first;
+        p = end;
+
+        if (*p == '-') {
+            last = strtol(p + 1, &end, 10);
+            p = end;
+        }
+
+        for (long i = first; i <= last; ++i) {
+            out.push_back(static_cast<int32_t>(i));
+        }
+
+        if (*p == ',') {
+            p++;
+        }
+    }
+
+    return out;
+}
+
+
+static size_t parseSize(const char *size)
+{
+    char *end = nullptr;
+    size_t value = strtoul(size, &end, 10);
+
+    if (*end == 'K') {
+        value *= 1024;
+    }
+    else if (*end == 'M') {
+        value *= 1024 * 1024;
+    }
+
+    return value;
+}
+
+
+static int32_t addCache(std::vector<CpuTopology::Cache> &caches, const std::vector<int32_t> &cpus, size_t size)
+{
+    for (size_t i = 0; i < caches.size(); ++i) {
+        if (caches[i].cpus == cpus) {
+            return static_cast<int32_t>(i);
+        }
+    }
+
+    CpuTopology::Cache cache;
+    cache.size = size;
+    cache.cpus = cpus;
+    caches.push_back(std::move(cache));
+
+    return static_cast<int32_t>(caches.size() - 1);
+}
+
+
+static inline bool isAllowed(int64_t mask, int32_t cpu)
+{
+    return mask == -1L || (cpu < 64 && (mask & (1ULL << cpu)));
+}
+
+
+static inline size_t l3cost(Algo algorithm)
+{
+    return algorithm == RANDOM_X ? DEFYX_SCRATCHPAD_L3 : cn_select_memory(algorithm);
+}
+
+
+static inline size_t l2cost(Algo algorithm)
+{
+    return algorithm == RANDOM_X ? DEFYX_SCRATCHPAD_L2 : 0;
+}
+
+
+} /* namespace xlarig */
+
+
+xlarig::CpuTopology::CpuTopology() :
+    m_hybrid(false)
+{
+}
+
+
+bool xlarig::CpuTopology::read(const char *path)
+{
+    m_units.clear();
+    m_l2.clear();
+    m_l3.clear();
+    m_hybrid = false;
+
+    char fileName[256];
+    char buf[1024];
+
+    snprintf(fileName, sizeof fileName, "%s/online", path);
+    if (!readLine(fileName, buf, sizeof buf)) {
+        return false;
+    }
+
+    const std::vector<int32_t> online = parseList(buf);
+
+    // Intel hybrid parts register separate PMUs for big and small cores.
+    std::vector<int32_t> atoms;
+    snprintf(fileName, sizeof fileName, "%s/../../cpu_atom/cpus", path);
+    if (readLine(fileName, buf, sizeof buf)) {
+        atoms = parseList(buf);
+    }
+
+    std::vector<int32_t> capacity(online.size(), 0);
+    int32_t maxCapacity = 0;
+
+    for (size_t i = 0; i < online.size(); ++i) {
+        const int32_t cpu = online[i];
+        Unit unit = { cpu, 0, cpu, -1, -1, false };
+
+        snprintf(fileName, sizeof fileName, "%s/cpu%d/topology/physical_package_id", path, cpu);
+        readInt(fileName, unit.package);
+
+        snprintf(fileName, sizeof fileName, "%s/cpu%d/topology/core_id", path, cpu);
+        readInt(fileName, unit.core);
+
+        snprintf(fileName, sizeof fileName, "%s/cpu%d/cpu_capacity", path, cpu);
+        if (readInt(fileName, capacity[i])) {
+            maxCapacity = std::max(maxCapacity, capacity[i]);
+        }
+
+        for (int index = 0; index < 8; ++index) {
+            int32_t level = 0;
+
+            snprintf(fileName, sizeof fileName, "%s/cpu%d/cache/index%d/level", path, cpu, index);
+            if (!readInt(fileName, level)) {
+                break;
+            }
+
+            if (level < 2) {
+                continue;
+            }
+
+            snprintf(fileName, sizeof fileName, "%s/cpu%d/cache/index%d/size", path, cpu, index);
+            if (!readLine(fileName, buf, sizeof buf)) {
+                continue;
+            }
+
+            const size_t size = parseSize(buf);
+
+            snprintf(fileName, sizeof fileName, "%s/cpu%d/cache/index%d/shared_cpu_list", path, cpu, index);
+            if (!readLine(fileName, buf, sizeof buf)) {
+                continue;
+            }
+
+            if (level == 2) {
+                unit.l2 = addCache(m_l2, parseList(buf), size);
+            }
+            else if (level == 3) {
+                unit.l3 = addCache(m_l3, parseList(buf), size);
+            }
+        }
+
+        unit.efficiency = std::find(atoms.begin(), atoms.end(), cpu) != atoms.end();
+        m_hybrid        = m_hybrid || unit.efficiency;
+
+        m_units.push_back(unit);
+    }
+
+    // big.LITTLE systems don't have cpu_atom, but report lower capacity for small cores.
+    for (size_t i = 0; i < m_units.size(); ++i) {
+        if (capacity[i] > 0 && capacity[i] < maxCapacity) {
+            m_units[i].efficiency = true;
+            m_hybrid              = true;
+        }
+    }
+
+    // Without L3 the last level cache is L2, treat each L2 domain as a cluster.
+    if (m_l3.empty() && !m_l2.empty()) {
+        m_l3 = m_l2;
+
+        for (Unit &unit : m_units) {
+            unit.l3 = unit.l2;
+        }
+    }
+
+    for (const Unit &unit : m_units) {
+        if (unit.l3 < 0) {
+            m_units.clear();
+
+            return false;
+        }
+    }
+
+    return isValid();
+}
+
+
+std::vector<xlarig::CpuTopology::Slot> xlarig::CpuTopology::layout(Algo algorithm, int multiway, bool autoMultiway, int64_t mask, int maxCpuUsage) const
+{
+    std::vector<std::vector<Slot> > domains(m_l3.size());
+    std::vector<size_t> l2used(m_l2.size(), 0);
+
+    const size_t costL3 = l3cost(algorithm);
+    const size_t costL2 = l2cost(algorithm);
+
+    size_t allowed = 0;
+
+    for (size_t d = 0; d < m_l3.size(); ++d) {
+        std::vector<const Unit *> primary;
+        std::vector<const Unit *> secondary;
+
+        std::vector<const Unit *> units;
+        for (const Unit &unit : m_units) {
+            if (unit.l3 == static_cast<int32_t>(d) && isAllowed(mask, unit.cpu)) {
+                units.push_back(&unit);
+            }
+        }
+
+        allowed += units.size();
+
+        // Performance cores first, so small cores only get leftover cache.
+        std::stable_sort(units.begin(), units.end(), [](const Unit *a, const Unit *b) {
+            return a->efficiency != b->efficiency ? !a->efficiency : a->core < b->core;
+        });
+
+        for (const Unit *unit : units) {
+            const bool sibling = std::find_if(primary.begin(), primary.end(), [unit](const Unit *u) {
+                return u->package == unit->package && u->core == unit->core;
+            }) != primary.end();
+
+            (sibling ? secondary : primary).push_back(unit);
+        }
+
+        size_t budget = m_l3[d].size;
+        std::vector<Slot> &slots = domains[d];
+
+        auto take = [&](const Unit *unit) {
+            const size_t cost = multiway * costL3;
+            if (budget < cost) {
+                return;
+            }
+
+            if (costL2 && unit->l2 >= 0) {
+                if (l2used[unit->l2] + costL2 > m_l2[unit->l2].size) {
+                    return;
+                }
+
+                l2used[unit->l2] += costL2;
+            }
+
+            budget -= cost;
+            slots.push_back({ unit->cpu, static_cast<int32_t>(d), multiway });
+        };
+
+        for (const Unit *unit : primary) {
+            take(unit);
+        }
+
+        // spare L3 on primary cores goes to extra hashes, up to 8 for the small cn-lite/cn-pico scratchpads
+        // on large caches, a second hash otherwise, wider kernels are left to autotune
+        if (autoMultiway && algorithm != RANDOM_X) {
+            const int maxWays = costL3 <= 1024 * 1024 ? IThread::MaxWay : IThread::DoubleWay;
+            bool changed      = true;
+
+            while (changed) {
+                changed = false;
+
+                for (Slot &slot : slots) {
+                    if (slot.multiway < maxWays && budget >= costL3) {
+                        slot.multiway++;
+                        budget -= costL3;
+                        changed = true;
+                    }
+                }
+            }
+        }
+
+        for (const Unit *unit : secondary) {
+            take(unit);
+        }
+    }
+
+    size_t total = 0;
+    for (const std::vector<Slot> &slots : domains) {
+        total += slots.size();
+    }
+
+    if (total == 0) {
+        for (const Unit &unit : m_units) {
+            if (isAllowed(mask, unit.cpu)) {
+                domains[unit.l3].push_back({ unit.cpu, unit.l3, multiway });
+                total = 1;
+                break;
+            }
+        }
+    }
+
+    size_t limit = total;
+    if (allowed && maxCpuUsage < 100) {
+        limit = std::max<size_t>(1, static_cast<size_t>(ceil(allowed * (maxCpuUsage / 100.0))));
+    }
+
+    // Drop threads round-robin from the most loaded domains, so the cut is spread evenly.
+    while (total > limit) {
+        size_t largest = 0;
+        for (size_t d = 1; d < domains.size(); ++d) {
+            if (domains[d].size() > domains[largest].size()) {
+                largest = d;
+            }
+        }
+
+        domains[largest].pop_back();
+        total--;
+    }
+
+    std::vector<Slot> out;
+    for (const std::vector<Slot> &slots : domains) {
+        out.insert(out.end(), slots.begin(), slots.end());
+    }
+
+    return out;
+}
+
+
+void xlarig::CpuTopology::print(const std::vector<IThread *> &threads) const
+{
+    if (!isValid()) {
+        return;
+    }
+
+    size_t cores = 0;
+    std::vector<std::pair<int32_t, int32_t> > seen;
+
+    for (const Unit &unit : m_units) {
+        if (std::find(seen.begin(), seen.end(), std::make_pair(unit.package, unit.core)) == seen.end()) {
+            seen.push_back(std::make_pair(unit.package, unit.core));
+            cores++;
+        }
+    }
+
+    Log::print(GREEN_BOLD(" * ") WHITE_BOLD("%-13s") "%zu socket(s), %zu L3, %zu cores, %zu threads%s",
+               "TOPOLOGY", sockets(), m_l3.size(), cores, m_units.size(), m_hybrid ? ", " CYAN_BOLD("hybrid") : "");
+
+    bool first = true;
+
+    for (size_t d = 0; d < m_l3.size(); ++d) {
+        char buf[256] = { 0 };
+        size_t offset = 0;
+        size_t count  = 0;
+
+        for (const IThread *thread : threads) {
+            const Unit *u = thread->affinity() >= 0 ? unit(static_cast<int32_t>(thread->affinity())) : nullptr;
+            if (!u || u->l3 != static_cast<int32_t>(d) || offset >= sizeof(buf) - 16) {
+                continue;
+            }
+
+            offset += snprintf(buf + offset, sizeof(buf) - offset, "%s%d%s", count ? " " : "", u->cpu, u->efficiency ? "e" : "");
+
+            if (thread->multiway() > 1) {
+                offset += snprintf(buf + offset, sizeof(buf) - offset, "x%d", static_cast<int>(thread->multiway()));
+            }
+
+            count++;
+        }
+
+        if (!count) {
+            continue;
+        }
+
+        Log::print(GREEN_BOLD(" * ") WHITE_BOLD("%-13s") "L3 #%zu " CYAN_BOLD("%.1f MB") " threads " CYAN_BOLD("%zu") " cpu %s",
+                   first ? "LAYOUT" : "", d, m_l3[d].size / 1024.0 / 1024.0, count, buf);
+
+        first = false;
+    }
+}
+
+
+const xlarig::CpuTopology::Unit *xlarig::CpuTopology::unit(int32_t cpu) const
+{
+    for (const Unit &unit : m_units) {
+        if (unit.cpu == cpu) {
+            return &unit;
+        }
+    }
+
+    return nullptr;
+}
+
+
+size_t xlarig::CpuTopology::sockets() const
+{
+    std::vector<int32_t> packages;
+
+    for (const Unit &unit : m_units) {
+        if (std::find(packages.begin(), packages.end(), unit.package) == packages.end()) {
+            packages.push_back(unit.package);
+        }
+    }
+
+    return packages.size();
+}
@@ -0,0 +1,101 @@
+/* XMRig and XLArig
+ * Copyright 2010      Jeff Garzik <jgarzik@pobox.com>
+ * Copyright 2012-2014 pooler      <pooler@litecoinpool.org>
+ * Copyright 2014      Lucas Jones <https://github.com/lucasjones>
+ * Copyright 2014-2016 Wolf9466    <https://github.com/OhGodAPet>
+ * Copyright 2016      Jay D Dee   <jayddee246@gmail.com>
+ * Copyright 2017-2018 XMR-Stak    <https://github.com/fireice-uk>, <https://github.com/psychocrypt>
+ * Copyright 2018-2019 SChernykh   <https://github.com/SChernykh>
+ * Copyright 2016-2019 XMRig       <https://github.com/xmrig>, <support@xmrig.com>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef XMRIG_CPUTOPOLOGY_H
+#define XMRIG_CPUTOPOLOGY_H
+
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+
+#include "common/xlarig.h"
+
+
+namespace xlarig {
+
+
+class IThread;
+
+
+/**
+ * @brief Logical CPU layout as reported by the kernel (sockets, shared caches, SMT siblings and core types).
+ *
+ * Only Linux exposes enough information through sysfs, on other platforms the topology is empty
+ * and callers must fall back to ICpuInfo::optimalThreadsCount().
+ */
+class CpuTopology
+{
+public:
+    struct Unit
+    {
+        int32_t cpu;
+        int32_t package;
+        int32_t core;
+        int32_t l2;
+        int32_t l3;
+        bool efficiency;
+    };
+
+    struct Cache
+    {
+        size_t size;
+        std::vector<int32_t> cpus;
+    };
+
+    struct Slot
+    {
+        int32_t cpu;
+        int32_t domain;
+        int multiway;
+    };
+
+    CpuTopology();
+
+    bool read(const char *path = "/sys/devices/system/cpu");
+    std::vector<Slot> layout(Algo algorithm, int multiway, bool autoMultiway, int64_t mask, int maxCpuUsage) const;
+    void print(const std::vector<IThread *> &threads) const;
+
+    inline bool isHybrid() const                       { return m_hybrid; }
+    inline bool isValid() const                        { return !m_units.empty() && !m_l3.empty(); }
+    inline const std::vector<Cache> &l2() const        { return m_l2; }
+    inline const std::vector<Cache> &l3() const        { return m_l3; }
+    inline const std::vector<Unit> &units() const      { return m_units; }
+
+private:
+    const Unit *unit(int32_t cpu) const;
+    size_t sockets() const;
+
+    bool m_hybrid;
+    std::vector<Cache> m_l2;
+    std::vector<Cache> m_l3;
+    std::vector<Unit> m_units;
+};
+
+
+} /* namespace xlarig */
+
+
+#endif /* XMRIG_CPUTOPOLOGY_H */
@@ -27,6 +27,7 @@
 #include <memory.h>
 
 
+#include "common/cpu/Cpu.h"
 #include "common/crypto/keccak.h"
 
 
@@ -161,6 +162,77 @@ void xlarig::keccakf(uint64_t st[25], int rounds)
     }
 }
 
+#ifdef XMRIG_FEATURE_KECCAK_LANES
+namespace xlarig {
+
+void keccakf_avx2(uint64_t *const *states, size_t count);
+void keccakf_avx512(uint64_t *const *states, size_t count);
+
+}
+
+
+static size_t keccak_lanes()
+{
+    static const size_t lanes = xlarig::Cpu::info()->hasAVX512() ? 8 : (xlarig::Cpu::info()->hasAVX2() ? 4 : 1);
+
+    return lanes;
+}
+#else
+static inline size_t keccak_lanes() { return 1; }
+#endif
+
+
+void xlarig::keccakf(uint64_t *const *st, size_t count)
+{
+    const size_t lanes = keccak_lanes();
+
+    while (count > 0) {
+        size_t n = 1;
+
+#       ifdef XMRIG_FEATURE_KECCAK_LANES
+        if (count > 1 && lanes == 8) {
+            n = count < 8 ? count : 8;
+            keccakf_avx512(st, n);
+        }
+        else if (count > 1 && lanes == 4) {
+            n = count < 4 ? count : 4;
+            keccakf_avx2(st, n);
+        }
+        else
+#       endif
+        {
+            keccakf(st[0], KECCAK_ROUNDS);
+        }
+
+        st    += n;
+        count -= n;
+    }
+}
+
+
+void xlarig::keccak(const uint8_t *in, size_t inlen, uint8_t *const *md, size_t count)
+{
+    if (count < 2 || inlen >= HASH_DATA_AREA || keccak_lanes() == 1) {
+        for (size_t i = 0; i < count; ++i) {
+            keccak(in + inlen * i, static_cast<int>(inlen), md[i], 200);
+        }
+
+        return;
+    }
+
+    // single block inputs (all CryptoNight blobs): pad into the states and permute them together
+    for (size_t i = 0; i < count; ++i) {
+        memset(md[i], 0, 200);
+        memcpy(md[i], in + inlen * i, inlen);
+
+        md[i][inlen]              ^= 0x01;
+        md[i][HASH_DATA_AREA - 1] |= 0x80;
+    }
+
+    keccakf(reinterpret_cast<uint64_t *const *>(md), count);
+}
+
+
 // compute a keccak hash (md) of given byte length from "in"
 typedef uint64_t state_t[25];
 
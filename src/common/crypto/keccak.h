@@ -50,6 +50,12 @@ inline void keccak(const char *in, size_t inlen, uint8_t *md)
 // update the state
 void keccakf(uint64_t st[25], int norounds);
 
+// full 24 round keccakf on "count" independent states, AVX2 (4 lanes) or AVX-512 (8 lanes) when available
+void keccakf(uint64_t *const *st, size_t count);
+
+// keccak hashes of "count" inputs of "inlen" bytes stored back to back, each md receives the full 200 byte state
+void keccak(const uint8_t *in, size_t inlen, uint8_t *const *md, size_t count);
+
 } /* namespace xlarig */
 
 #endif /* XMRIG_KECCAK_H */
@@ -0,0 +1,108 @@
+/* XMRig and XLArig
+ * Copyright 2010      Jeff Garzik               <jgarzik@pobox.com>
+ * Copyright 2011      Markku-Juhani O. Saarinen <mjos@iki.fi>
+ * Copyright 2012-2014 pooler                    <pooler@litecoinpool.org>
+ * Copyright 2014      Lucas Jones               <https://github.com/lucasjones>
+ * Copyright 2014-2016 Wolf9466                  <https://github.com/OhGodAPet>
+ * Copyright 2016      Jay D Dee                 <jayddee246@gmail.com>
+ * Copyright 2017-2018 XMR-Stak                  <https://github.com/fireice-uk>, <https://github.com/psychocrypt>
+ * Copyright 2016-2018 XLArig                     <https://github.com/xmrig>, <support@xmrig.com>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <immintrin.h>
+
+
+#include "common/crypto/keccak_lanes.h"
+
+
+namespace xlarig {
+
+
+struct KeccakAVX2
+{
+    using V = __m256i;
+
+    static inline V xor2(V a, V b)      { return _mm256_xor_si256(a, b); }
+    static inline V xor3(V a, V b, V c) { return _mm256_xor_si256(_mm256_xor_si256(a, b), c); }
+    static inline V chi(V a, V b, V c)  { return _mm256_xor_si256(a, _mm256_andnot_si256(b, c)); }
+    static inline V set1(uint64_t v)    { return _mm256_set1_epi64x(static_cast<int64_t>(v)); }
+
+    template<int N>
+    static inline V rol(V x)            { return _mm256_or_si256(_mm256_slli_epi64(x, N), _mm256_srli_epi64(x, 64 - N)); }
+};
+
+
+// 4x4 transpose of 64-bit words, its own inverse
+static inline void transpose(__m256i &r0, __m256i &r1, __m256i &r2, __m256i &r3)
+{
+    const __m256i t0 = _mm256_unpacklo_epi64(r0, r1);
+    const __m256i t1 = _mm256_unpackhi_epi64(r0, r1);
+    const __m256i t2 = _mm256_unpacklo_epi64(r2, r3);
+    const __m256i t3 = _mm256_unpackhi_epi64(r2, r3);
+
+    r0 = _mm256_permute2x128_si256(t0, t2, 0x20);
+    r1 = _mm256_permute2x128_si256(t1, t3, 0x20);
+    r2 = _mm256_permute2x128_si256(t0, t2, 0x31);
+    r3 = _mm256_permute2x128_si256(t1, t3, 0x31);
+}
+
+
+/**
+ * Up to 4 states, missing lanes run on a scratch state.
+ */
+void keccakf_avx2(uint64_t *const *states, size_t count)
+{
+    alignas(32) uint64_t dummy[25] = {};
+    uint64_t *st[4];
+
+    for (size_t i = 0; i < 4; ++i) {
+        st[i] = i < count ? states[i] : dummy;
+    }
+
+    __m256i a[25];
+
+    for (size_t i = 0; i < 24; i += 4) {
+        a[i    ] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(st[0] + i));
+        a[i + 1] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(st[1] + i));
+        a[i + 2] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(st[2] + i));
+        a[i + 3] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(st[3] + i));
+
+        transpose(a[i], a[i + 1], a[i + 2], a[i + 3]);
+    }
+
+    a[24] = _mm256_set_epi64x(static_cast<int64_t>(st[3][24]), static_cast<int64_t>(st[2][24]), static_cast<int64_t>(st[1][24]), static_cast<int64_t>(st[0][24]));
+
+    keccakf_lanes<KeccakAVX2>(a);
+
+    for (size_t i = 0; i < 24; i += 4) {
+        transpose(a[i], a[i + 1], a[i + 2], a[i + 3]);
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(st[0] + i), a[i    ]);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(st[1] + i), a[i + 1]);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(st[2] + i), a[i + 2]);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(st[3] + i), a[i + 3]);
+    }
+
+    alignas(32) uint64_t last[4];
+    _mm256_store_si256(reinterpret_cast<__m256i *>(last), a[24]);
+
+    for (size_t i = 0; i < count; ++i) {
+        st[i][24] = last[i];
+    }
+}
+
+
+} /* namespace xlarig */
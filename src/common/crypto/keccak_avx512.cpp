@@ -0,0 +1,85 @@
+/* XMRig and XLArig
+ * Copyright 2010      Jeff Garzik               <jgarzik@pobox.com>
+ * Copyright 2011      Markku-Juhani O. Saarinen <mjos@iki.fi>
+ * Copyright 2012-2014 pooler                    <pooler@litecoinpool.org>
+ * Copyright 2014      Lucas Jones               <https://github.com/lucasjones>
+ * Copyright 2014-2016 Wolf9466                  <https://github.com/OhGodAPet>
+ * Copyright 2016      Jay D Dee                 <jayddee246@gmail.com>
+ * Copyright 2017-2018 XMR-Stak                  <https://github.com/fireice-uk>, <https://github.com/psychocrypt>
+ * Copyright 2016-2018 XLArig                     <https://github.com/xmrig>, <support@xmrig.com>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <immintrin.h>
+
+
+#include "common/crypto/keccak_lanes.h"
+
+
+namespace xlarig {
+
+
+struct KeccakAVX512
+{
+    using V = __m512i;
+
+    static inline V xor2(V a, V b)      { return _mm512_xor_si512(a, b); }
+    static inline V xor3(V a, V b, V c) { return _mm512_ternarylogic_epi64(a, b, c, 0x96); }
+    static inline V chi(V a, V b, V c)  { return _mm512_ternarylogic_epi64(a, b, c, 0xD2); }
+    static inline V set1(uint64_t v)    { return _mm512_set1_epi64(static_cast<int64_t>(v)); }
+
+    // the masked form avoids GCC's uninitialized warning on _mm512_rol_epi64, same instruction
+    template<int N>
+    static inline V rol(V x)            { return _mm512_maskz_rol_epi64(0xff, x, N); }
+};
+
+
+/**
+ * Up to 8 states, they live in separate contexts so words are moved with gather/scatter using
+ * byte offsets from the first state, only the lanes in use are touched.
+ */
+void keccakf_avx512(uint64_t *const *states, size_t count)
+{
+    const __mmask8 mask = static_cast<__mmask8>((1u << count) - 1);
+    const char *base    = reinterpret_cast<const char *>(states[0]);
+
+    alignas(64) int64_t offsets[8] = { 0 };
+    for (size_t i = 0; i < count; ++i) {
+        offsets[i] = reinterpret_cast<const char *>(states[i]) - base;
+    }
+
+    const __m512i index = _mm512_load_si512(offsets);
+    const __m512i step  = _mm512_set1_epi64(8);
+
+    __m512i a[25];
+    __m512i offset = index;
+
+    for (size_t i = 0; i < 25; ++i) {
+        a[i]   = _mm512_mask_i64gather_epi64(_mm512_setzero_si512(), mask, offset, base, 1);
+        offset = _mm512_add_epi64(offset, step);
+    }
+
+    keccakf_lanes<KeccakAVX512>(a);
+
+    offset = index;
+
+    for (size_t i = 0; i < 25; ++i) {
+        _mm512_mask_i64scatter_epi64(const_cast<char *>(base), mask, offset, a[i], 1);
+        offset = _mm512_add_epi64(offset, step);
+    }
+}
+
+
+} /* namespace xlarig */
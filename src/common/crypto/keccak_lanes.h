@@ -0,0 +1,129 @@
+/* XMRig and XLArig
+ * Copyright 2010      Jeff Garzik               <jgarzik@pobox.com>
+ * Copyright 2011      Markku-Juhani O. Saarinen <mjos@iki.fi>
+ * Copyright 2012-2014 pooler                    <pooler@litecoinpool.org>
+ * Copyright 2014      Lucas Jones               <https://github.com/lucasjones>
+ * Copyright 2014-2016 Wolf9466                  <https://github.com/OhGodAPet>
+ * Copyright 2016      Jay D Dee                 <jayddee246@gmail.com>
+ * Copyright 2017-2018 XMR-Stak                  <https://github.com/fireice-uk>, <https://github.com/psychocrypt>
+ * Copyright 2016-2018 XLArig                     <https://github.com/xmrig>, <support@xmrig.com>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef XMRIG_KECCAK_LANES_H
+#define XMRIG_KECCAK_LANES_H
+
+
+#include <stdint.h>
+
+
+namespace xlarig {
+
+
+static const uint64_t keccak_lanes_rndc[24] =
+{
+    0x0000000000000001, 0x0000000000008082, 0x800000000000808a,
+    0x8000000080008000, 0x000000000000808b, 0x0000000080000001,
+    0x8000000080008081, 0x8000000000008009, 0x000000000000008a,
+    0x0000000000000088, 0x0000000080008009, 0x000000008000000a,
+    0x000000008000808b, 0x800000000000008b, 0x8000000000008089,
+    0x8000000000008003, 0x8000000000008002, 0x8000000000000080,
+    0x000000000000800a, 0x800000008000000a, 0x8000000080008081,
+    0x8000000000008080, 0x0000000080000001, 0x8000000080008008
+};
+
+
+/**
+ * Keccak-f[1600] on several independent states at once, one state per vector lane. Same steps as
+ * the scalar keccakf(), the ISA specific translation units provide the vector type and primitives:
+ * xor2, xor3, rol<N>, chi (a ^ (~b & c)) and set1.
+ */
+template<typename Ops>
+static inline void keccakf_lanes(typename Ops::V *st)
+{
+    using V = typename Ops::V;
+
+    V bc[5], t;
+
+    for (int round = 0; round < 24; ++round) {
+        // Theta
+        bc[0] = Ops::xor3(Ops::xor3(st[0], st[5], st[10]), st[15], st[20]);
+        bc[1] = Ops::xor3(Ops::xor3(st[1], st[6], st[11]), st[16], st[21]);
+        bc[2] = Ops::xor3(Ops::xor3(st[2], st[7], st[12]), st[17], st[22]);
+        bc[3] = Ops::xor3(Ops::xor3(st[3], st[8], st[13]), st[18], st[23]);
+        bc[4] = Ops::xor3(Ops::xor3(st[4], st[9], st[14]), st[19], st[24]);
+
+        for (int i = 0; i < 5; ++i) {
+            t = Ops::xor2(bc[(i + 4) % 5], Ops::template rol<1>(bc[(i + 1) % 5]));
+
+            st[i     ] = Ops::xor2(st[i     ], t);
+            st[i +  5] = Ops::xor2(st[i +  5], t);
+            st[i + 10] = Ops::xor2(st[i + 10], t);
+            st[i + 15] = Ops::xor2(st[i + 15], t);
+            st[i + 20] = Ops::xor2(st[i + 20], t);
+        }
+
+        // Rho Pi
+        t = st[1];
+        st[ 1] = Ops::template rol<44>(st[ 6]);
+        st[ 6] = Ops::template rol<20>(st[ 9]);
+        st[ 9] = Ops::template rol<61>(st[22]);
+        st[22] = Ops::template rol<39>(st[14]);
+        st[14] = Ops::template rol<18>(st[20]);
+        st[20] = Ops::template rol<62>(st[ 2]);
+        st[ 2] = Ops::template rol<43>(st[12]);
+        st[12] = Ops::template rol<25>(st[13]);
+        st[13] = Ops::template rol< 8>(st[19]);
+        st[19] = Ops::template rol<56>(st[23]);
+        st[23] = Ops::template rol<41>(st[15]);
+        st[15] = Ops::template rol<27>(st[ 4]);
+        st[ 4] = Ops::template rol<14>(st[24]);
+        st[24] = Ops::template rol< 2>(st[21]);
+        st[21] = Ops::template rol<55>(st[ 8]);
+        st[ 8] = Ops::template rol<45>(st[16]);
+        st[16] = Ops::template rol<36>(st[ 5]);
+        st[ 5] = Ops::template rol<28>(st[ 3]);
+        st[ 3] = Ops::template rol<21>(st[18]);
+        st[18] = Ops::template rol<15>(st[17]);
+        st[17] = Ops::template rol<10>(st[11]);
+        st[11] = Ops::template rol< 6>(st[ 7]);
+        st[ 7] = Ops::template rol< 3>(st[10]);
+        st[10] = Ops::template rol< 1>(t);
+
+        // Chi
+        for (int j = 0; j < 25; j += 5) {
+            bc[0] = st[j    ];
+            bc[1] = st[j + 1];
+            bc[2] = st[j + 2];
+            bc[3] = st[j + 3];
+            bc[4] = st[j + 4];
+
+            st[j    ] = Ops::chi(bc[0], bc[1], bc[2]);
+            st[j + 1] = Ops::chi(bc[1], bc[2], bc[3]);
+            st[j + 2] = Ops::chi(bc[2], bc[3], bc[4]);
+            st[j + 3] = Ops::chi(bc[3], bc[4], bc[0]);
+            st[j + 4] = Ops::chi(bc[4], bc[0], bc[1]);
+        }
+
+        // Iota
+        st[0] = Ops::xor2(st[0], Ops::set1(keccak_lanes_rndc[round]));
+    }
+}
+
+
+} /* namespace xlarig */
+
+
+#endif /* XMRIG_KECCAK_LANES_H */
@@ -43,6 +43,8 @@ public:
 
     virtual bool hasAES() const                                               = 0;
     virtual bool hasAVX2() const                                              = 0;
+    virtual bool hasAVX512() const                                            = 0;
+    virtual bool hasSSSE3() const                                             = 0;
     virtual bool isSupported() const                                          = 0;
     virtual bool isX64() const                                                = 0;
     virtual const char *brand() const                                         = 0;
@@ -57,6 +57,12 @@ enum AlgoVariant {
     AV_TRIPLE_SOFT, // --av=8  Triple hash mode (Software AES)
     AV_QUAD_SOFT,   // --av=9  Quard hash mode  (Software AES)
     AV_PENTA_SOFT,  // --av=10 Penta hash mode  (Software AES)
+    AV_HEXA,        // --av=11 Hexa hash mode
+    AV_HEPTA,       // --av=12 Hepta hash mode
+    AV_OCTA,        // --av=13 Octa hash mode
+    AV_HEXA_SOFT,   // --av=14 Hexa hash mode   (Software AES)
+    AV_HEPTA_SOFT,  // --av=15 Hepta hash mode  (Software AES)
+    AV_OCTA_SOFT,   // --av=16 Octa hash mode   (Software AES)
     AV_MAX
 };
 
@@ -28,9 +28,11 @@
 #include <inttypes.h>
 
 
+#include "base/io/json/Json.h"
 #include "base/io/log/Log.h"
 #include "base/kernel/interfaces/IJsonReader.h"
 #include "common/cpu/Cpu.h"
+#include "common/cpu/CpuTopology.h"
 #include "core/config/Config.h"
 #include "crypto/cn/Asm.h"
 #include "crypto/cn/CryptoNight_constants.h"
@@ -47,7 +49,9 @@ xlarig::Config::Config() :
     m_aesMode(AES_AUTO),
     m_algoVariant(AV_AUTO),
     m_assembly(ASM_AUTO),
+    m_autotune(false),
     m_hugePages(true),
+    m_perfCounters(false),
     m_safe(false),
     m_shouldSave(false),
     m_maxCpuUsage(100),
@@ -56,6 +60,14 @@ xlarig::Config::Config() :
 }
 
 
+xlarig::Config::~Config()
+{
+    for (IThread *thread : m_threads.list) {
+        delete thread;
+    }
+}
+
+
 bool xlarig::Config::isHwAES() const
 {
     return (m_aesMode == AES_AUTO ? (Cpu::info()->hasAES() ? AES_HW : AES_SOFT) : m_aesMode) == AES_HW;
@@ -68,13 +80,16 @@ bool xlarig::Config::read(const IJsonReader &reader, const char *fileName)
         return false;
     }
 
-    m_hugePages = reader.getBool("huge-pages", true);
-    m_safe      = reader.getBool("safe");
+    m_autotune     = reader.getBool("autotune");
+    m_hugePages    = reader.getBool("huge-pages", true);
+    m_perfCounters = reader.getBool("perf-counters");
+    m_safe         = reader.getBool("safe");
 
     setAesMode(reader.getValue("hw-aes"));
     setAlgoVariant(reader.getInt("av"));
     setMaxCpuUsage(reader.getInt("max-cpu-usage", 100));
     setPriority(reader.getInt("cpu-priority", -1));
+    setProxy(reader.getObject("proxy"));
     setThreads(reader.getValue("threads"));
 
 #   ifndef XMRIG_NO_ASM
@@ -106,6 +121,7 @@ void xlarig::Config::getJSON(rapidjson::Document &doc) const
 #   endif
 
     doc.AddMember("autosave",     isAutoSave(), allocator);
+    doc.AddMember("autotune",     isAutotune(), allocator);
     doc.AddMember("av",           algoVariant(), allocator);
     doc.AddMember("background",   isBackground(), allocator);
     doc.AddMember("colors",       Log::colors, allocator);
@@ -125,6 +141,15 @@ void xlarig::Config::getJSON(rapidjson::Document &doc) const
     doc.AddMember("hw-aes",            m_aesMode == AES_AUTO ? Value(kNullType) : Value(m_aesMode == AES_HW), allocator);
     doc.AddMember("log-file",          m_logFile.toJSON(), allocator);
     doc.AddMember("max-cpu-usage",     m_maxCpuUsage, allocator);
+    doc.AddMember("perf-counters",     isPerfCounters(), allocator);
+    doc.AddMember("pool-strategy",     StringRef(m_pools.strategyName()), allocator);
+
+    Value proxy(kObjectType);
+    proxy.AddMember("enabled",         m_proxy.enabled, allocator);
+    proxy.AddMember("host",            m_proxy.host.toJSON(), allocator);
+    proxy.AddMember("port",            m_proxy.port, allocator);
+    doc.AddMember("proxy",             proxy, allocator);
+
     doc.AddMember("pools",             m_pools.toJSON(doc), allocator);
     doc.AddMember("print-time",        printTime(), allocator);
     doc.AddMember("retries",           m_pools.retries(), allocator);
@@ -150,6 +175,40 @@ void xlarig::Config::getJSON(rapidjson::Document &doc) const
 }
 
 
+/**
+ * Replace the thread list, the previous entries are deleted so none of them may be used by running workers.
+ */
+void xlarig::Config::setThreads(const std::vector<CpuThread::Data> &threads)
+{
+    for (IThread *thread : m_threads.list) {
+        delete thread;
+    }
+
+    m_threads.cpu  = threads;
+    m_threads.mode = Advanced;
+    m_threads.list.clear();
+
+    for (size_t i = 0; i < m_threads.cpu.size(); ++i) {
+        m_threads.list.push_back(CpuThread::createFromData(i, m_algorithm.algo(), m_threads.cpu[i], m_priority, !isHwAES()));
+    }
+
+    m_threads.count = m_threads.list.size();
+    m_shouldSave    = true;
+}
+
+
+/**
+ * Hand the thread list over to the caller, used on reload when workers may still run on these entries.
+ */
+std::vector<xlarig::IThread *> xlarig::Config::releaseThreads()
+{
+    std::vector<IThread *> list = std::move(m_threads.list);
+    m_threads.list.clear();
+
+    return list;
+}
+
+
 bool xlarig::Config::finalize()
 {
     if (!m_threads.cpu.empty()) {
@@ -165,6 +224,26 @@ bool xlarig::Config::finalize()
     const AlgoVariant av = getAlgoVariant();
     m_threads.mode = m_threads.count ? Simple : Automatic;
 
+    if (m_threads.mode == Automatic && Cpu::topology()->isValid()) {
+        const bool softAES = CpuThread::isSoftAES(av);
+        const std::vector<CpuTopology::Slot> slots = Cpu::topology()->layout(m_algorithm.algo(), CpuThread::multiway(av), m_algoVariant == AV_AUTO,
+                                                                             m_threads.mask, m_maxCpuUsage);
+
+        for (size_t i = 0; i < slots.size(); ++i) {
+            CpuThread::Data data;
+            data.setMultiway(slots[i].multiway);
+            data.affinity = slots[i].cpu;
+            data.assembly = m_assembly;
+
+            m_threads.list.push_back(CpuThread::createFromData(i, m_algorithm.algo(), data, m_priority, softAES));
+        }
+
+        m_threads.count = m_threads.list.size();
+        m_shouldSave    = true;
+
+        return true;
+    }
+
     const Variant v = m_algorithm.variant();
     const size_t size = CpuThread::multiway(av) * cn_select_memory(m_algorithm.algo(), v) / 1024;
 
@@ -220,6 +299,18 @@ void xlarig::Config::setPriority(int priority)
 }
 
 
+void xlarig::Config::setProxy(const rapidjson::Value &proxy)
+{
+    if (!proxy.IsObject()) {
+        return;
+    }
+
+    m_proxy.enabled = Json::getBool(proxy, "enabled");
+    m_proxy.host    = Json::getString(proxy, "host", kDefaultProxyHost);
+    m_proxy.port    = static_cast<uint16_t>(Json::getUint(proxy, "port", kDefaultProxyPort));
+}
+
+
 void xlarig::Config::setThreads(const rapidjson::Value &threads)
 {
     if (threads.IsArray()) {
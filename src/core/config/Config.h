@@ -54,6 +54,8 @@ class Process;
  *   custom-diff (only for new connections)
  *   api/worker-id
  *   pools/
+ *   proxy/
+ *   threads/ (running threads are updated in place when possible)
  */
 class Config : public BaseConfig
 {
@@ -66,19 +68,28 @@ public:
 
 
     Config();
+    ~Config() override;
 
     bool isHwAES() const;
     bool read(const IJsonReader &reader, const char *fileName) override;
     void getJSON(rapidjson::Document &doc) const override;
+    void setThreads(const std::vector<CpuThread::Data> &threads);
+    std::vector<IThread *> releaseThreads();
 
     inline AlgoVariant algoVariant() const               { return m_algoVariant; }
     inline Assembly assembly() const                     { return m_assembly; }
+    inline bool isAutotune() const                       { return m_autotune; }
     inline bool isHugePages() const                      { return m_hugePages; }
+    inline bool isPerfCounters() const                   { return m_perfCounters; }
+    inline bool isProxy() const                          { return m_proxy.enabled; }
     inline bool isShouldSave() const                     { return (m_shouldSave || m_upgrade) && isAutoSave(); }
     inline const std::vector<IThread *> &threads() const { return m_threads.list; }
+    inline int maxCpuUsage() const                       { return m_maxCpuUsage; }
     inline int priority() const                          { return m_priority; }
     inline int threadsCount() const                      { return static_cast<int>(m_threads.list.size()); }
     inline int64_t affinity() const                      { return m_threads.mask; }
+    inline const String &proxyHost() const               { return m_proxy.host; }
+    inline uint16_t proxyPort() const                    { return m_proxy.port; }
     inline ThreadsMode threadsMode() const               { return m_threads.mode; }
 
 private:
@@ -87,6 +98,7 @@ private:
     void setAlgoVariant(int av);
     void setMaxCpuUsage(int max);
     void setPriority(int priority);
+    void setProxy(const rapidjson::Value &proxy);
     void setThreads(const rapidjson::Value &threads);
 
     AlgoVariant getAlgoVariant() const;
@@ -111,14 +123,31 @@ private:
     };
 
 
+    constexpr static const char *kDefaultProxyHost = "0.0.0.0";
+    constexpr static uint16_t kDefaultProxyPort    = 3333;
+
+
+    struct Proxy
+    {
+       inline Proxy() : enabled(false), host(kDefaultProxyHost), port(kDefaultProxyPort) {}
+
+       bool enabled;
+       String host;
+       uint16_t port;
+    };
+
+
     AesMode m_aesMode;
     AlgoVariant m_algoVariant;
     Assembly m_assembly;
+    bool m_autotune;
     bool m_hugePages;
+    bool m_perfCounters;
     bool m_safe;
     bool m_shouldSave;
     int m_maxCpuUsage;
     int m_priority;
+    Proxy m_proxy;
     Threads m_threads;
 };
 
@@ -23,10 +23,20 @@
  */
 
 
+#include <stdlib.h>
+
+
 #include "core/config/ConfigTransform.h"
 #include "base/kernel/interfaces/IConfig.h"
 
 
+namespace xlarig {
+
+static const char *kProxy = "proxy";
+
+}
+
+
 xlarig::ConfigTransform::ConfigTransform()
 {
 
@@ -36,14 +46,47 @@ xlarig::ConfigTransform::ConfigTransform()
 void xlarig::ConfigTransform::transform(rapidjson::Document &doc, int key, const char *arg)
 {
     BaseTransform::transform(doc, key, arg);
+
+    switch (key) {
+    case IConfig::AutotuneKey:     /* --autotune */
+    case IConfig::PerfCountersKey: /* --perf-counters */
+        return transformBoolean(doc, key, true);
+
+    case IConfig::ProxyHostKey: /* --proxy-host */
+        return set(doc, kProxy, "host", arg);
+
+    case IConfig::ProxyPortKey: /* --proxy-port */
+        return transformUint64(doc, key, static_cast<uint64_t>(strtol(arg, nullptr, 10)));
+
+    default:
+        break;
+    }
 }
 
 
 void xlarig::ConfigTransform::transformBoolean(rapidjson::Document &doc, int key, bool enable)
 {
+    switch (key) {
+    case IConfig::AutotuneKey: /* --autotune */
+        return set(doc, "autotune", enable);
+
+    case IConfig::PerfCountersKey: /* --perf-counters */
+        return set(doc, "perf-counters", enable);
+
+    default:
+        break;
+    }
 }
 
 
 void xlarig::ConfigTransform::transformUint64(rapidjson::Document &doc, int key, uint64_t arg)
 {
+    switch (key) {
+    case IConfig::ProxyPortKey: /* --proxy-port */
+        set(doc, kProxy, "enabled", true);
+        return set(doc, kProxy, "port", arg);
+
+    default:
+        break;
+    }
 }
@@ -47,6 +47,7 @@ R"===(
     },
     "asm": true,
     "autosave": true,
+    "autotune": false,
     "av": 0,
     "background": false,
     "colors": true,
@@ -58,6 +59,13 @@ R"===(
     "hw-aes": null,
     "log-file": null,
     "max-cpu-usage": 100,
+    "perf-counters": false,
+    "pool-strategy": "failover",
+    "proxy": {
+        "enabled": false,
+        "host": "0.0.0.0",
+        "port": 3333
+    },
     "pools": [
         {
             "url": "donate.v2.xlarig.com:3333",
@@ -65,13 +73,16 @@ R"===(
             "pass": "x",
             "rig-id": null,
             "nicehash": false,
+            "multi-algo": false,
             "keepalive": false,
             "variant": -1,
             "enabled": true,
             "tls": false,
             "tls-fingerprint": null,
+            "ktls": false,
             "daemon": false,
-            "daemon-poll-interval": 1000
+            "daemon-poll-interval": 1000,
+            "daemon-zmq-port": 0
         }
     ],
     "print-time": 60,
@@ -52,6 +52,10 @@ static const option options[] = {
     { "http-access-token",     1, nullptr, IConfig::HttpAccessTokenKey    },
     { "http-port",             1, nullptr, IConfig::HttpPort              },
     { "http-no-restricted",    0, nullptr, IConfig::HttpRestrictedKey     },
+    { "autotune",              0, nullptr, IConfig::AutotuneKey           },
+    { "perf-counters",         0, nullptr, IConfig::PerfCountersKey       },
+    { "proxy-host",            1, nullptr, IConfig::ProxyHostKey          },
+    { "proxy-port",            1, nullptr, IConfig::ProxyPortKey          },
     { "av",                    1, nullptr, IConfig::AVKey                 },
     { "background",            0, nullptr, IConfig::BackgroundKey         },
     { "config",                1, nullptr, IConfig::ConfigKey             },
@@ -64,10 +68,12 @@ static const option options[] = {
     { "log-file",              1, nullptr, IConfig::LogFileKey            },
     { "max-cpu-usage",         1, nullptr, IConfig::MaxCPUUsageKey        },
     { "nicehash",              0, nullptr, IConfig::NicehashKey           },
+    { "multi-algo",            0, nullptr, IConfig::MultiAlgoKey          },
     { "no-color",              0, nullptr, IConfig::ColorKey              },
     { "no-huge-pages",         0, nullptr, IConfig::HugePagesKey          },
     { "variant",               1, nullptr, IConfig::VariantKey            },
     { "pass",                  1, nullptr, IConfig::PasswordKey           },
+    { "pool-strategy",         1, nullptr, IConfig::PoolStrategyKey       },
     { "print-time",            1, nullptr, IConfig::PrintTimeKey          },
     { "retries",               1, nullptr, IConfig::RetriesKey            },
     { "retry-pause",           1, nullptr, IConfig::RetryPauseKey         },
@@ -81,9 +87,11 @@ static const option options[] = {
     { "rig-id",                1, nullptr, IConfig::RigIdKey              },
     { "tls",                   0, nullptr, IConfig::TlsKey                },
     { "tls-fingerprint",       1, nullptr, IConfig::FingerprintKey        },
+    { "ktls",                  0, nullptr, IConfig::KtlsKey               },
     { "asm",                   1, nullptr, IConfig::AssemblyKey           },
     { "daemon",                0, nullptr, IConfig::DaemonKey             },
     { "daemon-poll-interval",  1, nullptr, IConfig::DaemonPollKey         },
+    { "daemon-zmq-port",       1, nullptr, IConfig::DaemonZmqKey          },
 
 #   ifdef XMRIG_DEPRECATED
     { "api-port",              1, nullptr, IConfig::ApiPort               },
@@ -98,6 +106,8 @@ static const option options[] = {
 
 static struct option const config_options[] = {
     { "algo",              1, nullptr, IConfig::AlgorithmKey   },
+    { "autotune",          0, nullptr, IConfig::AutotuneKey    },
+    { "perf-counters",     0, nullptr, IConfig::PerfCountersKey },
     { "av",                1, nullptr, IConfig::AVKey          },
     { "background",        0, nullptr, IConfig::BackgroundKey  },
     { "colors",            0, nullptr, IConfig::ColorKey       },
@@ -109,6 +119,7 @@ static struct option const config_options[] = {
     { "huge-pages",        0, nullptr, IConfig::HugePagesKey   },
     { "log-file",          1, nullptr, IConfig::LogFileKey     },
     { "max-cpu-usage",     1, nullptr, IConfig::MaxCPUUsageKey },
+    { "pool-strategy",     1, nullptr, IConfig::PoolStrategyKey },
     { "print-time",        1, nullptr, IConfig::PrintTimeKey   },
     { "retries",           1, nullptr, IConfig::RetriesKey     },
     { "retry-pause",       1, nullptr, IConfig::RetryPauseKey  },
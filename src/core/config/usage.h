@@ -58,20 +58,24 @@ Options:\n\
   -t, --threads=N               number of miner threads\n\
   -v, --av=N                    algorithm variation, 0 auto select\n\
   -k, --keepalive               send keepalived packet for prevent timeout (needs pool support)\n\
-      --nicehash                enable nicehash.com support\n"
+      --nicehash                enable nicehash.com support\n\
+      --multi-algo              also offer the pool every other supported algorithm family\n"
 #ifdef XMRIG_FEATURE_TLS
 "\
       --tls                     enable SSL/TLS support (needs pool support)\n\
-      --tls-fingerprint=F       pool TLS certificate fingerprint, if set enable strict certificate pinning\n"
+      --tls-fingerprint=F       pool TLS certificate fingerprint, if set enable strict certificate pinning\n\
+      --ktls                    drive the TLS socket directly and use kernel TLS offload when available (Linux)\n"
 #endif
 #ifdef XMRIG_FEATURE_HTTP
 "\
       --daemon                  use daemon RPC instead of pool for solo mining\n\
-      --daemon-poll-interval=N  daemon poll interval in milliseconds (default: 1000)\n"
+      --daemon-poll-interval=N  daemon poll interval in milliseconds (default: 1000)\n\
+      --daemon-zmq-port=N       daemon ZMQ publisher port for instant new block notifications\n"
 #endif
 "\
   -r, --retries=N               number of times to retry before switch to backup server (default: 5)\n\
   -R, --retry-pause=N           time to pause between retries (default: 5)\n\
+      --pool-strategy=MODE      failover (default), hot-standby keeps all pools logged in, fastest follows the pool with the earliest jobs\n\
       --cpu-affinity            set process affinity to CPU core(s), mask 0x3 for cores 0 and 1\n\
       --cpu-priority            set process priority (0 idle, 2 normal to 5 highest)\n\
       --no-huge-pages           disable huge pages support\n\
@@ -89,8 +93,12 @@ Options:\n\
 "\
       --max-cpu-usage=N         maximum CPU usage for automatic threads mode (default: 100)\n\
       --safe                    safe adjust threads and av settings for current CPU\n\
-      --asm=ASM                 ASM optimizations, possible values: auto, none, intel, ryzen, bulldozer.\n\
-      --print-time=N            print hashrate report every N seconds\n"
+      --autotune                benchmark thread layouts on the current job and save the fastest\n\
+      --asm=ASM                 ASM optimizations, possible values: auto (fastest measured), none, intel, ryzen, bulldozer.\n\
+      --print-time=N            print hashrate report every N seconds\n\
+      --perf-counters           collect per thread hardware performance counters (Linux)\n\
+      --proxy-port=N            accept downstream miners on this port and share the pool connection with them\n\
+      --proxy-host=HOST         bind host for the embedded proxy (default: 0.0.0.0)\n"
 #ifdef XMRIG_FEATURE_HTTP
 "\
       --api-worker-id=ID        custom worker-id for API\n\
@@ -26,7 +26,12 @@
 #include <math.h>
 #include <string.h>
 
+#ifdef _MSC_VER
+#   include <intrin.h>
+#endif
 
+
+#include "common/cpu/Xgetbv.h"
 #include "core/cpu/AdvancedCpuInfo.h"
 
 
@@ -34,6 +39,8 @@ xlarig::AdvancedCpuInfo::AdvancedCpuInfo() :
     m_assembly(ASM_NONE),
     m_aes(false),
     m_avx2(false),
+    m_avx512(false),
+    m_ssse3(false),
     m_L2_exclusive(false),
     m_brand(),
     m_cores(0),
@@ -85,7 +92,11 @@ xlarig::AdvancedCpuInfo::AdvancedCpuInfo() :
         }
     }
 
-    m_avx2 = data.flags[CPU_FEATURE_AVX2] && data.flags[CPU_FEATURE_OSXSAVE];
+    m_avx2  = data.flags[CPU_FEATURE_AVX2] && data.flags[CPU_FEATURE_OSXSAVE];
+    m_ssse3 = data.flags[CPU_FEATURE_SSSE3];
+
+    // libcpuid only reports AVX-512 for Intel, read the leaf 7 bit directly and check that the OS saves ZMM state
+    m_avx512 = (raw.basic_cpuid[7][1] & (1 << 16)) && data.flags[CPU_FEATURE_OSXSAVE] && (xgetbv() & 0xe6) == 0xe6;
 }
 
 
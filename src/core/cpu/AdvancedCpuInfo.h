@@ -43,6 +43,8 @@ protected:
     inline Assembly assembly() const override       { return m_assembly; }
     inline bool hasAES() const override             { return m_aes; }
     inline bool hasAVX2() const override            { return m_avx2; }
+    inline bool hasAVX512() const override          { return m_avx512; }
+    inline bool hasSSSE3() const override           { return m_ssse3; }
     inline bool isSupported() const override        { return true; }
     inline const char *brand() const override       { return m_brand; }
     inline int32_t cores() const override           { return m_cores; }
@@ -62,6 +64,8 @@ private:
     Assembly m_assembly;
     bool m_aes;
     bool m_avx2;
+    bool m_avx512;
+    bool m_ssse3;
     bool m_L2_exclusive;
     char m_brand[64];
     int32_t m_cores;
@@ -26,6 +26,7 @@
 
 
 #include "common/cpu/Cpu.h"
+#include "common/cpu/CpuTopology.h"
 
 
 #ifndef XMRIG_NO_LIBCPUID
@@ -33,9 +34,18 @@
 #endif
 
 
+static xlarig::CpuTopology *cpuTopology = nullptr;
 static xlarig::ICpuInfo *cpuInfo = nullptr;
 
 
+const xlarig::CpuTopology *xlarig::Cpu::topology()
+{
+    assert(cpuTopology != nullptr);
+
+    return cpuTopology;
+}
+
+
 xlarig::ICpuInfo *xlarig::Cpu::info()
 {
     assert(cpuInfo != nullptr);
@@ -49,6 +59,9 @@ void xlarig::Cpu::init()
     assert(cpuInfo == nullptr);
 
     cpuInfo = new AdvancedCpuInfo();
+
+    cpuTopology = new CpuTopology();
+    cpuTopology->read();
 }
 
 
@@ -58,4 +71,7 @@ void xlarig::Cpu::release()
 
     delete cpuInfo;
     cpuInfo = nullptr;
+
+    delete cpuTopology;
+    cpuTopology = nullptr;
 }
@@ -0,0 +1,377 @@
+/* XMRig and XLArig
+ * Copyright 2010      Jeff Garzik <jgarzik@pobox.com>
+ * Copyright 2012-2014 pooler      <pooler@litecoinpool.org>
+ * Copyright 2014      Lucas Jones <https://github.com/lucasjones>
+ * Copyright 2014-2016 Wolf9466    <https://github.com/OhGodAPet>
+ * Copyright 2016      Jay D Dee   <jayddee246@gmail.com>
+ * Copyright 2017-2018 XMR-Stak    <https://github.com/fireice-uk>, <https://github.com/psychocrypt>
+ * Copyright 2018-2019 SChernykh   <https://github.com/SChernykh>
+ * Copyright 2016-2019 XMRig       <https://github.com/xmrig>, <support@xmrig.com>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <assert.h>
+#include <string.h>
+
+
+#include "common/cpu/Cpu.h"
+#include "crypto/cn/CnHash.h"
+#include "crypto/common/Algorithms.h"
+#include "crypto/common/VirtualMemory.h"
+
+
+#if defined(XMRIG_ARM)
+#   include "crypto/cn/CryptoNight_arm.h"
+#else
+#   include "crypto/cn/CryptoNight_x86.h"
+#endif
+
+
+#ifndef XMRIG_NO_ASM
+template<typename T, typename U>
+static void patchCode(T dst, U src, const uint32_t iterations, const uint32_t mask)
+{
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(src);
+
+    // Workaround for Visual Studio placing trampoline in debug builds.
+#   if defined(_MSC_VER)
+    if (p[0] == 0xE9) {
+        p += *(int32_t*)(p + 1) + 5;
+    }
+#   endif
+
+    size_t size = 0;
+    while (*(uint32_t*)(p + size) != 0xDEADC0DE) {
+        ++size;
+    }
+    size += sizeof(uint32_t);
+
+    memcpy((void*) dst, (const void*) src, size);
+
+    uint8_t* patched_data = reinterpret_cast<uint8_t*>(dst);
+    for (size_t i = 0; i + sizeof(uint32_t) <= size; ++i) {
+        switch (*(uint32_t*)(patched_data + i)) {
+        case xlarig::CRYPTONIGHT_ITER:
+            *(uint32_t*)(patched_data + i) = iterations;
+            break;
+
+        case xlarig::CRYPTONIGHT_MASK:
+            *(uint32_t*)(patched_data + i) = mask;
+            break;
+        }
+    }
+}
+
+
+extern "C" void cnv2_mainloop_ivybridge_asm(cryptonight_ctx **ctx);
+extern "C" void cnv2_mainloop_ryzen_asm(cryptonight_ctx **ctx);
+extern "C" void cnv2_mainloop_bulldozer_asm(cryptonight_ctx **ctx);
+extern "C" void cnv2_double_mainloop_sandybridge_asm(cryptonight_ctx **ctx);
+
+
+xlarig::CnHash::cn_mainloop_fun        cn_half_mainloop_ivybridge_asm             = nullptr;
+xlarig::CnHash::cn_mainloop_fun        cn_half_mainloop_ryzen_asm                 = nullptr;
+xlarig::CnHash::cn_mainloop_fun        cn_half_mainloop_bulldozer_asm             = nullptr;
+xlarig::CnHash::cn_mainloop_fun        cn_half_double_mainloop_sandybridge_asm    = nullptr;
+
+xlarig::CnHash::cn_mainloop_fun        cn_trtl_mainloop_ivybridge_asm             = nullptr;
+xlarig::CnHash::cn_mainloop_fun        cn_trtl_mainloop_ryzen_asm                 = nullptr;
+xlarig::CnHash::cn_mainloop_fun        cn_trtl_mainloop_bulldozer_asm             = nullptr;
+xlarig::CnHash::cn_mainloop_fun        cn_trtl_double_mainloop_sandybridge_asm    = nullptr;
+
+xlarig::CnHash::cn_mainloop_fun        cn_zls_mainloop_ivybridge_asm              = nullptr;
+xlarig::CnHash::cn_mainloop_fun        cn_zls_mainloop_ryzen_asm                  = nullptr;
+xlarig::CnHash::cn_mainloop_fun        cn_zls_mainloop_bulldozer_asm              = nullptr;
+xlarig::CnHash::cn_mainloop_fun        cn_zls_double_mainloop_sandybridge_asm     = nullptr;
+
+xlarig::CnHash::cn_mainloop_fun        cn_double_mainloop_ivybridge_asm           = nullptr;
+xlarig::CnHash::cn_mainloop_fun        cn_double_mainloop_ryzen_asm               = nullptr;
+xlarig::CnHash::cn_mainloop_fun        cn_double_mainloop_bulldozer_asm           = nullptr;
+xlarig::CnHash::cn_mainloop_fun        cn_double_double_mainloop_sandybridge_asm  = nullptr;
+
+
+void xlarig::CnHash::patchAsmVariants()
+{
+    const int allocation_size = 65536;
+    uint8_t *base = static_cast<uint8_t *>(VirtualMemory::allocateExecutableMemory(allocation_size));
+
+    cn_half_mainloop_ivybridge_asm              = reinterpret_cast<cn_mainloop_fun>         (base + 0x0000);
+    cn_half_mainloop_ryzen_asm                  = reinterpret_cast<cn_mainloop_fun>         (base + 0x1000);
+    cn_half_mainloop_bulldozer_asm              = reinterpret_cast<cn_mainloop_fun>         (base + 0x2000);
+    cn_half_double_mainloop_sandybridge_asm     = reinterpret_cast<cn_mainloop_fun>         (base + 0x3000);
+
+    cn_trtl_mainloop_ivybridge_asm              = reinterpret_cast<cn_mainloop_fun>         (base + 0x4000);
+    cn_trtl_mainloop_ryzen_asm                  = reinterpret_cast<cn_mainloop_fun>         (base + 0x5000);
+    cn_trtl_mainloop_bulldozer_asm              = reinterpret_cast<cn_mainloop_fun>         (base + 0x6000);
+    cn_trtl_double_mainloop_sandybridge_asm     = reinterpret_cast<cn_mainloop_fun>         (base + 0x7000);
+
+    cn_zls_mainloop_ivybridge_asm               = reinterpret_cast<cn_mainloop_fun>         (base + 0x8000);
+    cn_zls_mainloop_ryzen_asm                   = reinterpret_cast<cn_mainloop_fun>         (base + 0x9000);
+    cn_zls_mainloop_bulldozer_asm               = reinterpret_cast<cn_mainloop_fun>         (base + 0xA000);
+    cn_zls_double_mainloop_sandybridge_asm      = reinterpret_cast<cn_mainloop_fun>         (base + 0xB000);
+
+    cn_double_mainloop_ivybridge_asm            = reinterpret_cast<cn_mainloop_fun>         (base + 0xC000);
+    cn_double_mainloop_ryzen_asm                = reinterpret_cast<cn_mainloop_fun>         (base + 0xD000);
+    cn_double_mainloop_bulldozer_asm            = reinterpret_cast<cn_mainloop_fun>         (base + 0xE000);
+    cn_double_double_mainloop_sandybridge_asm   = reinterpret_cast<cn_mainloop_fun>         (base + 0xF000);
+
+    patchCode(cn_half_mainloop_ivybridge_asm,            cnv2_mainloop_ivybridge_asm,           xlarig::CRYPTONIGHT_HALF_ITER,   xlarig::CRYPTONIGHT_MASK);
+    patchCode(cn_half_mainloop_ryzen_asm,                cnv2_mainloop_ryzen_asm,               xlarig::CRYPTONIGHT_HALF_ITER,   xlarig::CRYPTONIGHT_MASK);
+    patchCode(cn_half_mainloop_bulldozer_asm,            cnv2_mainloop_bulldozer_asm,           xlarig::CRYPTONIGHT_HALF_ITER,   xlarig::CRYPTONIGHT_MASK);
+    patchCode(cn_half_double_mainloop_sandybridge_asm,   cnv2_double_mainloop_sandybridge_asm,  xlarig::CRYPTONIGHT_HALF_ITER,   xlarig::CRYPTONIGHT_MASK);
+
+    patchCode(cn_trtl_mainloop_ivybridge_asm,            cnv2_mainloop_ivybridge_asm,           xlarig::CRYPTONIGHT_TRTL_ITER,   xlarig::CRYPTONIGHT_PICO_MASK);
+    patchCode(cn_trtl_mainloop_ryzen_asm,                cnv2_mainloop_ryzen_asm,               xlarig::CRYPTONIGHT_TRTL_ITER,   xlarig::CRYPTONIGHT_PICO_MASK);
+    patchCode(cn_trtl_mainloop_bulldozer_asm,            cnv2_mainloop_bulldozer_asm,           xlarig::CRYPTONIGHT_TRTL_ITER,   xlarig::CRYPTONIGHT_PICO_MASK);
+    patchCode(cn_trtl_double_mainloop_sandybridge_asm,   cnv2_double_mainloop_sandybridge_asm,  xlarig::CRYPTONIGHT_TRTL_ITER,   xlarig::CRYPTONIGHT_PICO_MASK);
+
+    patchCode(cn_zls_mainloop_ivybridge_asm,             cnv2_mainloop_ivybridge_asm,           xlarig::CRYPTONIGHT_ZLS_ITER,    xlarig::CRYPTONIGHT_MASK);
+    patchCode(cn_zls_mainloop_ryzen_asm,                 cnv2_mainloop_ryzen_asm,               xlarig::CRYPTONIGHT_ZLS_ITER,    xlarig::CRYPTONIGHT_MASK);
+    patchCode(cn_zls_mainloop_bulldozer_asm,             cnv2_mainloop_bulldozer_asm,           xlarig::CRYPTONIGHT_ZLS_ITER,    xlarig::CRYPTONIGHT_MASK);
+    patchCode(cn_zls_double_mainloop_sandybridge_asm,    cnv2_double_mainloop_sandybridge_asm,  xlarig::CRYPTONIGHT_ZLS_ITER,    xlarig::CRYPTONIGHT_MASK);
+
+    patchCode(cn_double_mainloop_ivybridge_asm,          cnv2_mainloop_ivybridge_asm,           xlarig::CRYPTONIGHT_DOUBLE_ITER, xlarig::CRYPTONIGHT_MASK);
+    patchCode(cn_double_mainloop_ryzen_asm,              cnv2_mainloop_ryzen_asm,               xlarig::CRYPTONIGHT_DOUBLE_ITER, xlarig::CRYPTONIGHT_MASK);
+    patchCode(cn_double_mainloop_bulldozer_asm,          cnv2_mainloop_bulldozer_asm,           xlarig::CRYPTONIGHT_DOUBLE_ITER, xlarig::CRYPTONIGHT_MASK);
+    patchCode(cn_double_double_mainloop_sandybridge_asm, cnv2_double_mainloop_sandybridge_asm,  xlarig::CRYPTONIGHT_DOUBLE_ITER, xlarig::CRYPTONIGHT_MASK);
+
+    VirtualMemory::protectExecutableMemory(base, allocation_size);
+    VirtualMemory::flushInstructionCache(base, allocation_size);
+}
+#endif
+
+
+namespace xlarig {
+
+
+template<size_t... I> struct IndexSequence {};
+template<size_t N, size_t... I> struct MakeIndexSequence : MakeIndexSequence<N - 1, N - 1, I...> {};
+template<size_t... I> struct MakeIndexSequence<0, I...> { using type = IndexSequence<I...>; };
+
+
+// tables are flat, one cell per algorithm/variant pair
+using Cells = MakeIndexSequence<ALGO_MAX * VARIANT_MAX>::type;
+
+constexpr Algo cell_algo(size_t cell)       { return static_cast<Algo>(cell / VARIANT_MAX); }
+constexpr Variant cell_variant(size_t cell) { return static_cast<Variant>(cell % VARIANT_MAX); }
+constexpr AlgoImpl cell_impl(size_t cell)   { return algorithm_impl(cell_algo(cell), cell_variant(cell)); }
+
+
+static_assert(AV_SINGLE == 1 && AV_DOUBLE_SOFT == 4 && AV_PENTA_SOFT == 10 && AV_OCTA_SOFT == 16 && AV_MAX == 17, "FuncRow initializers follow the AlgoVariant order");
+
+
+struct FuncRow
+{
+    CnHash::cn_hash_fun av[AV_MAX];
+};
+
+
+/**
+ * Kernels for one cell, chosen by the impl of the pair in kAlgorithms. Pairs that are not listed
+ * stay empty and are never instantiated, listed pairs without a kernel fail to compile.
+ */
+template<Algo ALGO, Variant VARIANT, AlgoImpl IMPL, int INNER, int SOFT>
+struct Funcs
+{
+    static constexpr FuncRow row() { return FuncRow{{}}; }
+};
+
+
+template<Algo ALGO, Variant VARIANT, int INNER, int SOFT>
+struct Funcs<ALGO, VARIANT, IMPL_CN, INNER, SOFT>
+{
+    static_assert(cn_select_iter<ALGO, VARIANT>() != 0, "no CryptoNight kernel for this algorithm/variant pair");
+
+    static constexpr FuncRow row()
+    {
+        return FuncRow{{
+            nullptr,
+            cryptonight_single_hash<ALGO, SOFT_AES_OFF, VARIANT>,
+            cryptonight_double_hash<ALGO, SOFT_AES_OFF, VARIANT>,
+            cryptonight_single_hash<ALGO, SOFT,         VARIANT>,
+            cryptonight_double_hash<ALGO, SOFT,         VARIANT>,
+            cryptonight_triple_hash<ALGO, SOFT_AES_OFF, VARIANT>,
+            cryptonight_quad_hash<ALGO,   SOFT_AES_OFF, VARIANT>,
+            cryptonight_penta_hash<ALGO,  SOFT_AES_OFF, VARIANT>,
+            cryptonight_triple_hash<ALGO, SOFT,         VARIANT>,
+            cryptonight_quad_hash<ALGO,   SOFT,         VARIANT>,
+            cryptonight_penta_hash<ALGO,  SOFT,         VARIANT>,
+            cryptonight_multi_hash<ALGO,  SOFT_AES_OFF, VARIANT, 6>,
+            cryptonight_multi_hash<ALGO,  SOFT_AES_OFF, VARIANT, 7>,
+            cryptonight_multi_hash<ALGO,  SOFT_AES_OFF, VARIANT, 8>,
+            cryptonight_multi_hash<ALGO,  SOFT,         VARIANT, 6>,
+            cryptonight_multi_hash<ALGO,  SOFT,         VARIANT, 7>,
+            cryptonight_multi_hash<ALGO,  SOFT,         VARIANT, 8>
+        }};
+    }
+};
+
+
+template<Algo ALGO, Variant VARIANT, int INNER, int SOFT>
+struct Funcs<ALGO, VARIANT, IMPL_CN_ASM, INNER, SOFT> : Funcs<ALGO, VARIANT, IMPL_CN, INNER, SOFT> {};
+
+
+#ifdef XMRIG_ALGO_CN_GPU
+template<Algo ALGO, Variant VARIANT, int INNER, int SOFT>
+struct Funcs<ALGO, VARIANT, IMPL_CN_GPU, INNER, SOFT>
+{
+    static_assert(cn_base_variant<VARIANT>() == VARIANT_GPU, "cn/gpu kernels need a cn/gpu variant");
+
+    static constexpr FuncRow row()
+    {
+#       if defined(XMRIG_ARM)
+        return FuncRow{{
+            nullptr,
+            cryptonight_single_hash_gpu<ALGO, SOFT_AES_OFF, VARIANT>,
+            cryptonight_double_hash_gpu<ALGO, SOFT_AES_OFF, VARIANT>,
+            cryptonight_single_hash_gpu<ALGO, SOFT,         VARIANT>,
+            cryptonight_double_hash_gpu<ALGO, SOFT,         VARIANT>
+        }};
+#       else
+        return FuncRow{{
+            nullptr,
+            cryptonight_single_hash_gpu<ALGO, SOFT_AES_OFF, VARIANT, static_cast<CnGpuInner>(INNER)>,
+            cryptonight_double_hash_gpu<ALGO, SOFT_AES_OFF, VARIANT, static_cast<CnGpuInner>(INNER)>,
+            cryptonight_single_hash_gpu<ALGO, SOFT,         VARIANT, static_cast<CnGpuInner>(INNER)>,
+            cryptonight_double_hash_gpu<ALGO, SOFT,         VARIANT, static_cast<CnGpuInner>(INNER)>
+        }};
+#       endif
+    }
+};
+#endif
+
+
+template<int INNER, int SOFT, typename CELLS> struct FuncTable;
+
+template<int INNER, int SOFT, size_t... I>
+struct FuncTable<INNER, SOFT, IndexSequence<I...>>
+{
+    static constexpr FuncRow rows[sizeof...(I)] = { Funcs<cell_algo(I), cell_variant(I), cell_impl(I), INNER, SOFT>::row()... };
+};
+
+template<int INNER, int SOFT, size_t... I>
+constexpr FuncRow FuncTable<INNER, SOFT, IndexSequence<I...>>::rows[sizeof...(I)];
+
+
+#ifndef XMRIG_NO_ASM
+static_assert(ASM_INTEL == 2 && ASM_RYZEN == 3 && ASM_BULLDOZER == 4 && ASM_MAX == 5, "AsmRow initializers follow the Assembly order");
+
+
+// assembly main loops exist for single and double hash only
+struct AsmRow
+{
+    CnHash::cn_hash_fun way[2][ASM_MAX];
+};
+
+
+template<Algo ALGO, Variant VARIANT, AlgoImpl IMPL>
+struct AsmFuncs
+{
+    static constexpr AsmRow row() { return AsmRow{{}}; }
+};
+
+
+template<Algo ALGO, Variant VARIANT>
+struct AsmFuncs<ALGO, VARIANT, IMPL_CN_ASM>
+{
+    static_assert(cn_base_variant<VARIANT>() == VARIANT_2, "assembly main loops are cn/2 based");
+
+    static constexpr AsmRow row()
+    {
+        return AsmRow{{
+            {
+                nullptr, nullptr,
+                cryptonight_single_hash_asm<ALGO, VARIANT, ASM_INTEL>,
+                cryptonight_single_hash_asm<ALGO, VARIANT, ASM_RYZEN>,
+                cryptonight_single_hash_asm<ALGO, VARIANT, ASM_BULLDOZER>
+            },
+            {
+                nullptr, nullptr,
+                cryptonight_double_hash_asm<ALGO, VARIANT, ASM_INTEL>,
+                cryptonight_double_hash_asm<ALGO, VARIANT, ASM_RYZEN>,
+                cryptonight_double_hash_asm<ALGO, VARIANT, ASM_BULLDOZER>
+            }
+        }};
+    }
+};
+
+
+template<typename CELLS> struct AsmTable;
+
+template<size_t... I>
+struct AsmTable<IndexSequence<I...>>
+{
+    static constexpr AsmRow rows[sizeof...(I)] = { AsmFuncs<cell_algo(I), cell_variant(I), cell_impl(I)>::row()... };
+};
+
+template<size_t... I>
+constexpr AsmRow AsmTable<IndexSequence<I...>>::rows[sizeof...(I)];
+#endif
+
+
+#if !defined(XMRIG_ARM)
+template<int SOFT>
+static const FuncRow *innerTable()
+{
+#   ifdef XMRIG_ALGO_CN_GPU
+    return Cpu::info()->hasAVX512() ? FuncTable<CN_GPU_AVX512, SOFT, Cells>::rows :
+           Cpu::info()->hasAVX2()   ? FuncTable<CN_GPU_AVX2, SOFT, Cells>::rows :
+                                      FuncTable<CN_GPU_SSSE3, SOFT, Cells>::rows;
+#   else
+    return FuncTable<0, SOFT, Cells>::rows;
+#   endif
+}
+#endif
+
+
+static const FuncRow *funcTable()
+{
+#   if defined(XMRIG_ARM)
+    return FuncTable<0, SOFT_AES_TABLE, Cells>::rows;
+#   else
+    // the software AES flavour and the cn/gpu inner loop are picked once for the whole table instead of checking the CPU on every hash
+    static const FuncRow *table = Cpu::info()->hasSSSE3() ? innerTable<SOFT_AES_VPERM>() : innerTable<SOFT_AES_TABLE>();
+
+    return table;
+#   endif
+}
+
+
+} /* namespace xlarig */
+
+
+xlarig::CnHash::cn_hash_fun xlarig::CnHash::fn(Algo algorithm, AlgoVariant av, Variant variant, Assembly assembly)
+{
+    assert(algorithm >= CRYPTONIGHT && algorithm < ALGO_MAX);
+    assert(variant >= VARIANT_0 && variant < VARIANT_MAX);
+    assert(av >= AV_AUTO && av < AV_MAX);
+
+    const size_t cell = static_cast<size_t>(algorithm) * VARIANT_MAX + static_cast<size_t>(variant);
+
+#   ifndef XMRIG_NO_ASM
+    if (av == AV_SINGLE || av == AV_DOUBLE) {
+        if (assembly == ASM_AUTO) {
+            assembly = Cpu::info()->assembly();
+        }
+
+        const cn_hash_fun fun = AsmTable<Cells>::rows[cell].way[av - AV_SINGLE][assembly];
+        if (fun) {
+            return fun;
+        }
+    }
+#   endif
+
+    return funcTable()[cell].av[av];
+}
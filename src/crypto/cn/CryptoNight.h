@@ -41,6 +41,9 @@ struct cryptonight_ctx;
 typedef void(*cn_mainloop_fun_ms_abi)(cryptonight_ctx**) ABI_ATTRIBUTE;
 
 
+constexpr const size_t CN_GENERATED_CODE_SIZE = 0x4000;
+
+
 struct cryptonight_r_data {
     int variant;
     uint64_t height;
@@ -58,6 +61,7 @@ struct cryptonight_ctx {
 
     cn_mainloop_fun_ms_abi generated_code;
     cryptonight_r_data generated_code_data;
+    uint8_t *generated_code_buffer;
 };
 
 
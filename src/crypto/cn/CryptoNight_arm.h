@@ -160,7 +160,7 @@ static inline void soft_aes_genkey_sub(__m128i* xout0, __m128i* xout2)
 }
 
 
-template<bool SOFT_AES>
+template<int SOFT_AES>
 static inline void aes_genkey(const __m128i* memory, __m128i* k0, __m128i* k1, __m128i* k2, __m128i* k3, __m128i* k4, __m128i* k5, __m128i* k6, __m128i* k7, __m128i* k8, __m128i* k9)
 {
     __m128i xout0 = _mm_load_si128(memory);
@@ -186,7 +186,7 @@ static inline void aes_genkey(const __m128i* memory, __m128i* k0, __m128i* k1, _
 }
 
 
-template<bool SOFT_AES>
+template<int SOFT_AES>
 static inline void aes_round(__m128i key, __m128i* x0, __m128i* x1, __m128i* x2, __m128i* x3, __m128i* x4, __m128i* x5, __m128i* x6, __m128i* x7)
 {
     if (SOFT_AES) {
@@ -226,7 +226,7 @@ inline void mix_and_propagate(__m128i& x0, __m128i& x1, __m128i& x2, __m128i& x3
 }
 
 
-template<xlarig::Algo ALGO, size_t MEM, bool SOFT_AES>
+template<xlarig::Algo ALGO, size_t MEM, int SOFT_AES>
 static inline void cn_explode_scratchpad(const __m128i *input, __m128i *output)
 {
     __m128i xin0, xin1, xin2, xin3, xin4, xin5, xin6, xin7;
@@ -312,7 +312,7 @@ void cn_explode_scratchpad_gpu(const uint8_t *input, uint8_t *output)
 #endif
 
 
-template<xlarig::Algo ALGO, size_t MEM, bool SOFT_AES>
+template<xlarig::Algo ALGO, size_t MEM, int SOFT_AES>
 static inline void cn_implode_scratchpad(const __m128i *input, __m128i *output)
 {
     __m128i xout0, xout1, xout2, xout3, xout4, xout5, xout6, xout7;
@@ -454,7 +454,7 @@ static inline void cryptonight_monero_tweak(const uint8_t* l, uint64_t idx, __m1
 }
 
 
-template<xlarig::Algo ALGO, bool SOFT_AES, xlarig::Variant VARIANT>
+template<xlarig::Algo ALGO, int SOFT_AES, xlarig::Variant VARIANT>
 inline void cryptonight_single_hash(const uint8_t *__restrict__ input, size_t size, uint8_t *__restrict__ output, cryptonight_ctx **__restrict__ ctx, uint64_t height)
 {
     constexpr size_t MASK         = xlarig::cn_select_mask<ALGO>();
@@ -588,7 +588,7 @@ template<size_t ITER, uint32_t MASK>
 void cn_gpu_inner_arm(const uint8_t *spad, uint8_t *lpad);
 
 
-template<xlarig::Algo ALGO, bool SOFT_AES, xlarig::Variant VARIANT>
+template<xlarig::Algo ALGO, int SOFT_AES, xlarig::Variant VARIANT>
 inline void cryptonight_single_hash_gpu(const uint8_t *__restrict__ input, size_t size, uint8_t *__restrict__ output, cryptonight_ctx **__restrict__ ctx, uint64_t height)
 {
     constexpr size_t MASK         = xlarig::CRYPTONIGHT_GPU_MASK;
@@ -609,10 +609,18 @@ inline void cryptonight_single_hash_gpu(const uint8_t *__restrict__ input, size_
     xlarig::keccakf((uint64_t*) ctx[0]->state, 24);
     memcpy(output, ctx[0]->state, 32);
 }
+
+
+template<xlarig::Algo ALGO, int SOFT_AES, xlarig::Variant VARIANT>
+inline void cryptonight_double_hash_gpu(const uint8_t *__restrict__ input, size_t size, uint8_t *__restrict__ output, cryptonight_ctx **__restrict__ ctx, uint64_t height)
+{
+    cryptonight_single_hash_gpu<ALGO, SOFT_AES, VARIANT>(input,        size, output,      ctx,     height);
+    cryptonight_single_hash_gpu<ALGO, SOFT_AES, VARIANT>(input + size, size, output + 32, ctx + 1, height);
+}
 #endif
 
 
-template<xlarig::Algo ALGO, bool SOFT_AES, xlarig::Variant VARIANT>
+template<xlarig::Algo ALGO, int SOFT_AES, xlarig::Variant VARIANT>
 inline void cryptonight_double_hash(const uint8_t *__restrict__ input, size_t size, uint8_t *__restrict__ output, struct cryptonight_ctx **__restrict__ ctx, uint64_t height)
 {
     constexpr size_t MASK         = xlarig::cn_select_mask<ALGO>();
@@ -824,21 +832,27 @@ inline void cryptonight_double_hash(const uint8_t *__restrict__ input, size_t si
 }
 
 
-template<xlarig::Algo ALGO, bool SOFT_AES, xlarig::Variant VARIANT>
+template<xlarig::Algo ALGO, int SOFT_AES, xlarig::Variant VARIANT>
 inline void cryptonight_triple_hash(const uint8_t *__restrict__ input, size_t size, uint8_t *__restrict__ output, struct cryptonight_ctx **__restrict__ ctx, uint64_t height)
 {
 }
 
 
-template<xlarig::Algo ALGO, bool SOFT_AES, xlarig::Variant VARIANT>
+template<xlarig::Algo ALGO, int SOFT_AES, xlarig::Variant VARIANT>
 inline void cryptonight_quad_hash(const uint8_t *__restrict__ input, size_t size, uint8_t *__restrict__ output, struct cryptonight_ctx **__restrict__ ctx, uint64_t height)
 {
 }
 
 
-template<xlarig::Algo ALGO, bool SOFT_AES, xlarig::Variant VARIANT>
+template<xlarig::Algo ALGO, int SOFT_AES, xlarig::Variant VARIANT>
 inline void cryptonight_penta_hash(const uint8_t *__restrict__ input, size_t size, uint8_t *__restrict__ output, struct cryptonight_ctx **__restrict__ ctx, uint64_t height)
 {
 }
 
+
+template<xlarig::Algo ALGO, int SOFT_AES, xlarig::Variant VARIANT, size_t N>
+inline void cryptonight_multi_hash(const uint8_t *__restrict__ input, size_t size, uint8_t *__restrict__ output, struct cryptonight_ctx **__restrict__ ctx, uint64_t height)
+{
+}
+
 #endif /* __CRYPTONIGHT_ARM_H__ */
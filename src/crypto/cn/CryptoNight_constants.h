@@ -62,6 +62,11 @@ constexpr const uint32_t CRYPTONIGHT_PICO_MASK   = 0x1FFF0;
 constexpr const uint32_t CRYPTONIGHT_PICO_ITER   = 0x40000;
 constexpr const uint32_t CRYPTONIGHT_TRTL_ITER   = 0x10000;
 
+// DefyX per-VM scratchpad levels, must match RANDOMX_SCRATCHPAD_* in defyx/src/configuration.h.
+constexpr const size_t   DEFYX_SCRATCHPAD_L3     = 256 * 1024;
+constexpr const size_t   DEFYX_SCRATCHPAD_L2     = 128 * 1024;
+constexpr const size_t   DEFYX_SCRATCHPAD_L1     = 64 * 1024;
+
 
 template<Algo ALGO> inline constexpr size_t cn_select_memory()           { return 0; }
 template<> inline constexpr size_t cn_select_memory<CRYPTONIGHT>()       { return CRYPTONIGHT_MEMORY; }
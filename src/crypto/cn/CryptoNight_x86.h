@@ -37,9 +37,11 @@
 
 #include "common/cpu/Cpu.h"
 #include "common/crypto/keccak.h"
+#include "crypto/cn/CnHash.h"
 #include "crypto/cn/CryptoNight.h"
 #include "crypto/cn/CryptoNight_constants.h"
 #include "crypto/cn/CryptoNight_monero.h"
+#include "crypto/cn/r/CnrCodeCache.h"
 #include "crypto/cn/soft_aes.h"
 
 
@@ -75,6 +77,31 @@ static inline void do_skein_hash(const uint8_t *input, size_t len, uint8_t *outp
 void (* const extra_hashes[4])(const uint8_t *, size_t, uint8_t *) = {do_blake_hash, do_groestl_hash, do_jh_hash, do_skein_hash};
 
 
+// initial and final keccak of all N lanes in one go, multi-lane AVX2/AVX-512 kernels are used when available
+template<size_t N>
+static inline void cn_keccak(const uint8_t *input, size_t size, cryptonight_ctx **ctx)
+{
+    uint8_t *states[N];
+    for (size_t i = 0; i < N; ++i) {
+        states[i] = ctx[i]->state;
+    }
+
+    xlarig::keccak(input, size, states, N);
+}
+
+
+template<size_t N>
+static inline void cn_keccakf(cryptonight_ctx **ctx)
+{
+    uint64_t *states[N];
+    for (size_t i = 0; i < N; ++i) {
+        states[i] = reinterpret_cast<uint64_t*>(ctx[i]->state);
+    }
+
+    xlarig::keccakf(states, N);
+}
+
+
 #if defined(__x86_64__) || defined(_M_AMD64)
 #   ifdef __GNUC__
 static inline uint64_t __umul128(uint64_t a, uint64_t b, uint64_t* hi)
@@ -152,21 +179,21 @@ static inline void aes_genkey_sub(__m128i* xout0, __m128i* xout2)
 }
 
 
-template<uint8_t rcon>
+template<int SOFT_AES, uint8_t rcon>
 static inline void soft_aes_genkey_sub(__m128i* xout0, __m128i* xout2)
 {
-    __m128i xout1 = soft_aeskeygenassist<rcon>(*xout2);
+    __m128i xout1 = SOFT_AES == xlarig::SOFT_AES_VPERM ? soft_aeskeygenassist_ssse3<rcon>(*xout2) : soft_aeskeygenassist<rcon>(*xout2);
     xout1  = _mm_shuffle_epi32(xout1, 0xFF); // see PSHUFD, set all elems to 4th elem
     *xout0 = sl_xor(*xout0);
     *xout0 = _mm_xor_si128(*xout0, xout1);
-    xout1  = soft_aeskeygenassist<0x00>(*xout0);
+    xout1  = SOFT_AES == xlarig::SOFT_AES_VPERM ? soft_aeskeygenassist_ssse3<0x00>(*xout0) : soft_aeskeygenassist<0x00>(*xout0);
     xout1  = _mm_shuffle_epi32(xout1, 0xAA); // see PSHUFD, set all elems to 3rd elem
     *xout2 = sl_xor(*xout2);
     *xout2 = _mm_xor_si128(*xout2, xout1);
 }
 
 
-template<bool SOFT_AES>
+template<int SOFT_AES>
 static inline void aes_genkey(const __m128i* memory, __m128i* k0, __m128i* k1, __m128i* k2, __m128i* k3, __m128i* k4, __m128i* k5, __m128i* k6, __m128i* k7, __m128i* k8, __m128i* k9)
 {
     __m128i xout0 = _mm_load_si128(memory);
@@ -174,110 +201,56 @@ static inline void aes_genkey(const __m128i* memory, __m128i* k0, __m128i* k1, _
     *k0 = xout0;
     *k1 = xout2;
 
-    SOFT_AES ? soft_aes_genkey_sub<0x01>(&xout0, &xout2) : aes_genkey_sub<0x01>(&xout0, &xout2);
+    SOFT_AES ? soft_aes_genkey_sub<SOFT_AES, 0x01>(&xout0, &xout2) : aes_genkey_sub<0x01>(&xout0, &xout2);
     *k2 = xout0;
     *k3 = xout2;
 
-    SOFT_AES ? soft_aes_genkey_sub<0x02>(&xout0, &xout2) : aes_genkey_sub<0x02>(&xout0, &xout2);
+    SOFT_AES ? soft_aes_genkey_sub<SOFT_AES, 0x02>(&xout0, &xout2) : aes_genkey_sub<0x02>(&xout0, &xout2);
     *k4 = xout0;
     *k5 = xout2;
 
-    SOFT_AES ? soft_aes_genkey_sub<0x04>(&xout0, &xout2) : aes_genkey_sub<0x04>(&xout0, &xout2);
+    SOFT_AES ? soft_aes_genkey_sub<SOFT_AES, 0x04>(&xout0, &xout2) : aes_genkey_sub<0x04>(&xout0, &xout2);
     *k6 = xout0;
     *k7 = xout2;
 
-    SOFT_AES ? soft_aes_genkey_sub<0x08>(&xout0, &xout2) : aes_genkey_sub<0x08>(&xout0, &xout2);
+    SOFT_AES ? soft_aes_genkey_sub<SOFT_AES, 0x08>(&xout0, &xout2) : aes_genkey_sub<0x08>(&xout0, &xout2);
     *k8 = xout0;
     *k9 = xout2;
 }
 
 
-static FORCEINLINE void soft_aesenc(void* __restrict ptr, const void* __restrict key, const uint32_t* __restrict t)
-{
-    uint32_t x0 = ((const uint32_t*)(ptr))[0];
-    uint32_t x1 = ((const uint32_t*)(ptr))[1];
-    uint32_t x2 = ((const uint32_t*)(ptr))[2];
-    uint32_t x3 = ((const uint32_t*)(ptr))[3];
-
-    uint32_t y0 = t[x0 & 0xff]; x0 >>= 8;
-    uint32_t y1 = t[x1 & 0xff]; x1 >>= 8;
-    uint32_t y2 = t[x2 & 0xff]; x2 >>= 8;
-    uint32_t y3 = t[x3 & 0xff]; x3 >>= 8;
-    t += 256;
-
-    y0 ^= t[x1 & 0xff]; x1 >>= 8;
-    y1 ^= t[x2 & 0xff]; x2 >>= 8;
-    y2 ^= t[x3 & 0xff]; x3 >>= 8;
-    y3 ^= t[x0 & 0xff]; x0 >>= 8;
-    t += 256;
-
-    y0 ^= t[x2 & 0xff]; x2 >>= 8;
-    y1 ^= t[x3 & 0xff]; x3 >>= 8;
-    y2 ^= t[x0 & 0xff]; x0 >>= 8;
-    y3 ^= t[x1 & 0xff]; x1 >>= 8;
-    t += 256;
-
-    y0 ^= t[x3];
-    y1 ^= t[x0];
-    y2 ^= t[x1];
-    y3 ^= t[x2];
-
-    ((uint32_t*)ptr)[0] = y0 ^ ((uint32_t*)key)[0];
-    ((uint32_t*)ptr)[1] = y1 ^ ((uint32_t*)key)[1];
-    ((uint32_t*)ptr)[2] = y2 ^ ((uint32_t*)key)[2];
-    ((uint32_t*)ptr)[3] = y3 ^ ((uint32_t*)key)[3];
-}
+template<int SOFT_AES>
+void aes_round(__m128i key, __m128i* x0, __m128i* x1, __m128i* x2, __m128i* x3, __m128i* x4, __m128i* x5, __m128i* x6, __m128i* x7);
 
-static FORCEINLINE __m128i soft_aesenc(const void* __restrict ptr, const __m128i key, const uint32_t* __restrict t)
+template<>
+NOINLINE void aes_round<xlarig::SOFT_AES_TABLE>(__m128i key, __m128i* x0, __m128i* x1, __m128i* x2, __m128i* x3, __m128i* x4, __m128i* x5, __m128i* x6, __m128i* x7)
 {
-    uint32_t x0 = ((const uint32_t*)(ptr))[0];
-    uint32_t x1 = ((const uint32_t*)(ptr))[1];
-    uint32_t x2 = ((const uint32_t*)(ptr))[2];
-    uint32_t x3 = ((const uint32_t*)(ptr))[3];
-
-    uint32_t y0 = t[x0 & 0xff]; x0 >>= 8;
-    uint32_t y1 = t[x1 & 0xff]; x1 >>= 8;
-    uint32_t y2 = t[x2 & 0xff]; x2 >>= 8;
-    uint32_t y3 = t[x3 & 0xff]; x3 >>= 8;
-    t += 256;
-
-    y0 ^= t[x1 & 0xff]; x1 >>= 8;
-    y1 ^= t[x2 & 0xff]; x2 >>= 8;
-    y2 ^= t[x3 & 0xff]; x3 >>= 8;
-    y3 ^= t[x0 & 0xff]; x0 >>= 8;
-    t += 256;
-
-    y0 ^= t[x2 & 0xff]; x2 >>= 8;
-    y1 ^= t[x3 & 0xff]; x3 >>= 8;
-    y2 ^= t[x0 & 0xff]; x0 >>= 8;
-    y3 ^= t[x1 & 0xff]; x1 >>= 8;
-
-    y0 ^= t[x3 + 256];
-    y1 ^= t[x0 + 256];
-    y2 ^= t[x1 + 256];
-    y3 ^= t[x2 + 256];
-
-    return _mm_xor_si128(_mm_set_epi32(y3, y2, y1, y0), key);
+    *x0 = soft_aesenc(*x0, key);
+    *x1 = soft_aesenc(*x1, key);
+    *x2 = soft_aesenc(*x2, key);
+    *x3 = soft_aesenc(*x3, key);
+    *x4 = soft_aesenc(*x4, key);
+    *x5 = soft_aesenc(*x5, key);
+    *x6 = soft_aesenc(*x6, key);
+    *x7 = soft_aesenc(*x7, key);
 }
 
-template<bool SOFT_AES>
-void aes_round(__m128i key, __m128i* x0, __m128i* x1, __m128i* x2, __m128i* x3, __m128i* x4, __m128i* x5, __m128i* x6, __m128i* x7);
-
+// built for SSSE3 so the eight table-free rounds are inlined here, the scratchpad loops only pay one call
 template<>
-NOINLINE void aes_round<true>(__m128i key, __m128i* x0, __m128i* x1, __m128i* x2, __m128i* x3, __m128i* x4, __m128i* x5, __m128i* x6, __m128i* x7)
+NOINLINE SAES_TARGET_SSSE3 void aes_round<xlarig::SOFT_AES_VPERM>(__m128i key, __m128i* x0, __m128i* x1, __m128i* x2, __m128i* x3, __m128i* x4, __m128i* x5, __m128i* x6, __m128i* x7)
 {
-    *x0 = soft_aesenc((uint32_t*)x0, key, (const uint32_t*)saes_table);
-    *x1 = soft_aesenc((uint32_t*)x1, key, (const uint32_t*)saes_table);
-    *x2 = soft_aesenc((uint32_t*)x2, key, (const uint32_t*)saes_table);
-    *x3 = soft_aesenc((uint32_t*)x3, key, (const uint32_t*)saes_table);
-    *x4 = soft_aesenc((uint32_t*)x4, key, (const uint32_t*)saes_table);
-    *x5 = soft_aesenc((uint32_t*)x5, key, (const uint32_t*)saes_table);
-    *x6 = soft_aesenc((uint32_t*)x6, key, (const uint32_t*)saes_table);
-    *x7 = soft_aesenc((uint32_t*)x7, key, (const uint32_t*)saes_table);
+    *x0 = soft_aesenc_ssse3(*x0, key);
+    *x1 = soft_aesenc_ssse3(*x1, key);
+    *x2 = soft_aesenc_ssse3(*x2, key);
+    *x3 = soft_aesenc_ssse3(*x3, key);
+    *x4 = soft_aesenc_ssse3(*x4, key);
+    *x5 = soft_aesenc_ssse3(*x5, key);
+    *x6 = soft_aesenc_ssse3(*x6, key);
+    *x7 = soft_aesenc_ssse3(*x7, key);
 }
 
 template<>
-FORCEINLINE void aes_round<false>(__m128i key, __m128i* x0, __m128i* x1, __m128i* x2, __m128i* x3, __m128i* x4, __m128i* x5, __m128i* x6, __m128i* x7)
+FORCEINLINE void aes_round<xlarig::SOFT_AES_OFF>(__m128i key, __m128i* x0, __m128i* x1, __m128i* x2, __m128i* x3, __m128i* x4, __m128i* x5, __m128i* x6, __m128i* x7)
 {
     *x0 = _mm_aesenc_si128(*x0, key);
     *x1 = _mm_aesenc_si128(*x1, key);
@@ -289,6 +262,12 @@ FORCEINLINE void aes_round<false>(__m128i key, __m128i* x0, __m128i* x1, __m128i
     *x7 = _mm_aesenc_si128(*x7, key);
 }
 
+template<int SOFT_AES>
+static inline __m128i soft_aes_round(__m128i in, __m128i key)
+{
+    return SOFT_AES == xlarig::SOFT_AES_VPERM ? soft_aesenc_ssse3(in, key) : soft_aesenc(in, key);
+}
+
 inline void mix_and_propagate(__m128i& x0, __m128i& x1, __m128i& x2, __m128i& x3, __m128i& x4, __m128i& x5, __m128i& x6, __m128i& x7)
 {
     __m128i tmp0 = x0;
@@ -303,7 +282,7 @@ inline void mix_and_propagate(__m128i& x0, __m128i& x1, __m128i& x2, __m128i& x3
 }
 
 
-template<xlarig::Algo ALGO, size_t MEM, bool SOFT_AES>
+template<xlarig::Algo ALGO, size_t MEM, int SOFT_AES>
 static inline void cn_explode_scratchpad(const __m128i *input, __m128i *output)
 {
     __m128i xin0, xin1, xin2, xin3, xin4, xin5, xin6, xin7;
@@ -389,7 +368,7 @@ void cn_explode_scratchpad_gpu(const uint8_t *input, uint8_t *output)
 #endif
 
 
-template<xlarig::Algo ALGO, size_t MEM, bool SOFT_AES>
+template<xlarig::Algo ALGO, size_t MEM, int SOFT_AES>
 static inline void cn_implode_scratchpad(const __m128i *input, __m128i *output)
 {
     __m128i xout0, xout1, xout2, xout3, xout4, xout5, xout6, xout7;
@@ -549,10 +528,7 @@ static inline void cryptonight_monero_tweak(uint64_t* mem_out, const uint8_t* l,
     }
 }
 
-void wow_soft_aes_compile_code(const V4_Instruction* code, int code_size, void* machine_code, xlarig::Assembly ASM);
-void v4_soft_aes_compile_code(const V4_Instruction* code, int code_size, void* machine_code, xlarig::Assembly ASM);
-
-template<xlarig::Algo ALGO, bool SOFT_AES, xlarig::Variant VARIANT>
+template<xlarig::Algo ALGO, int SOFT_AES, xlarig::Variant VARIANT>
 inline void cryptonight_single_hash(const uint8_t *__restrict__ input, size_t size, uint8_t *__restrict__ output, cryptonight_ctx **__restrict__ ctx, uint64_t height)
 {
     constexpr size_t MASK         = xlarig::cn_select_mask<ALGO>();
@@ -577,16 +553,13 @@ inline void cryptonight_single_hash(const uint8_t *__restrict__ input, size_t si
     if (SOFT_AES && xlarig::cn_is_cryptonight_r<VARIANT>())
     {
         if (!ctx[0]->generated_code_data.match(VARIANT, height)) {
-            V4_Instruction code[256];
-            const int code_size = v4_random_math_init<VARIANT>(code, height);
-
-            if (VARIANT == xlarig::VARIANT_WOW)
-                wow_soft_aes_compile_code(code, code_size, reinterpret_cast<void*>(ctx[0]->generated_code), xlarig::ASM_NONE);
-            else if (VARIANT == xlarig::VARIANT_4)
-                v4_soft_aes_compile_code(code, code_size, reinterpret_cast<void*>(ctx[0]->generated_code), xlarig::ASM_NONE);
+            xlarig::CnrCodeCache::update(ctx[0], VARIANT, height, xlarig::ASM_NONE, true, false);
+        }
 
-            ctx[0]->generated_code_data.variant = VARIANT;
-            ctx[0]->generated_code_data.height = height;
+        // no executable memory for the program, an all ones hash is never a share
+        if (!ctx[0]->generated_code) {
+            memset(output, 0xFF, 32);
+            return;
         }
 
         ctx[0]->saes_table = (const uint32_t*)saes_table;
@@ -609,17 +582,14 @@ inline void cryptonight_single_hash(const uint8_t *__restrict__ input, size_t si
     uint64_t idx0 = al0;
 
     for (size_t i = 0; i < ITERATIONS; i++) {
-        __m128i cx;
-        if (VARIANT == xlarig::VARIANT_TUBE || !SOFT_AES) {
-            cx = _mm_load_si128((__m128i *) &l0[idx0 & MASK]);
-        }
+        __m128i cx = _mm_load_si128((__m128i *) &l0[idx0 & MASK]);
 
         const __m128i ax0 = _mm_set_epi64x(ah0, al0);
         if (VARIANT == xlarig::VARIANT_TUBE) {
             cx = aes_round_tweak_div(cx, ax0);
         }
         else if (SOFT_AES) {
-            cx = soft_aesenc((uint32_t*)&l0[idx0 & MASK], ax0, (const uint32_t*)saes_table);
+            cx = soft_aes_round<SOFT_AES>(cx, ax0);
         }
         else {
             cx = _mm_aesenc_si128(cx, ax0);
@@ -709,15 +679,51 @@ inline void cryptonight_single_hash(const uint8_t *__restrict__ input, size_t si
 
 
 #ifdef XMRIG_ALGO_CN_GPU
+namespace xlarig {
+
+
+enum CnGpuInner {
+    CN_GPU_SSSE3,
+    CN_GPU_AVX2,
+    CN_GPU_AVX512
+};
+
+
+} /* namespace xlarig */
+
+
 template<size_t ITER, uint32_t MASK>
 void cn_gpu_inner_avx(const uint8_t *spad, uint8_t *lpad);
 
 
+template<size_t ITER, uint32_t MASK>
+void cn_gpu_inner_avx512(const uint8_t *spad, uint8_t *lpad);
+
+
 template<size_t ITER, uint32_t MASK>
 void cn_gpu_inner_ssse3(const uint8_t *spad, uint8_t *lpad);
 
 
-template<xlarig::Algo ALGO, bool SOFT_AES, xlarig::Variant VARIANT>
+template<size_t ITER, uint32_t MASK, xlarig::CnGpuInner INNER>
+inline void cn_gpu_inner(const uint8_t *spad, uint8_t *lpad)
+{
+    switch (INNER) {
+    case xlarig::CN_GPU_AVX512:
+        cn_gpu_inner_avx512<ITER, MASK>(spad, lpad);
+        break;
+
+    case xlarig::CN_GPU_AVX2:
+        cn_gpu_inner_avx<ITER, MASK>(spad, lpad);
+        break;
+
+    default:
+        cn_gpu_inner_ssse3<ITER, MASK>(spad, lpad);
+        break;
+    }
+}
+
+
+template<xlarig::Algo ALGO, int SOFT_AES, xlarig::Variant VARIANT, xlarig::CnGpuInner INNER>
 inline void cryptonight_single_hash_gpu(const uint8_t *__restrict__ input, size_t size, uint8_t *__restrict__ output, cryptonight_ctx **__restrict__ ctx, uint64_t height)
 {
     constexpr size_t MASK         = xlarig::CRYPTONIGHT_GPU_MASK;
@@ -735,17 +741,44 @@ inline void cryptonight_single_hash_gpu(const uint8_t *__restrict__ input, size_
     fesetround(FE_TONEAREST);
 #   endif
 
-    if (xlarig::Cpu::info()->hasAVX2()) {
-        cn_gpu_inner_avx<ITERATIONS, MASK>(ctx[0]->state, ctx[0]->memory);
-    } else {
-        cn_gpu_inner_ssse3<ITERATIONS, MASK>(ctx[0]->state, ctx[0]->memory);
-    }
+    cn_gpu_inner<ITERATIONS, MASK, INNER>(ctx[0]->state, ctx[0]->memory);
 
     cn_implode_scratchpad<xlarig::CRYPTONIGHT_HEAVY, MEM, SOFT_AES>((__m128i*) ctx[0]->memory, (__m128i*) ctx[0]->state);
 
     xlarig::keccakf((uint64_t*) ctx[0]->state, 24);
     memcpy(output, ctx[0]->state, 32);
 }
+
+
+template<xlarig::Algo ALGO, int SOFT_AES, xlarig::Variant VARIANT, xlarig::CnGpuInner INNER>
+inline void cryptonight_double_hash_gpu(const uint8_t *__restrict__ input, size_t size, uint8_t *__restrict__ output, cryptonight_ctx **__restrict__ ctx, uint64_t height)
+{
+    constexpr size_t MASK         = xlarig::CRYPTONIGHT_GPU_MASK;
+    constexpr size_t ITERATIONS   = xlarig::cn_select_iter<ALGO, VARIANT>();
+    constexpr size_t MEM          = xlarig::cn_select_memory<ALGO>();
+
+    static_assert(MASK > 0 && ITERATIONS > 0 && MEM > 0, "unsupported algorithm/variant");
+
+    cn_keccak<2>(input, size, ctx);
+    cn_explode_scratchpad_gpu<ALGO, MEM>(ctx[0]->state, ctx[0]->memory);
+    cn_explode_scratchpad_gpu<ALGO, MEM>(ctx[1]->state, ctx[1]->memory);
+
+#   ifdef _MSC_VER
+    _control87(RC_NEAR, MCW_RC);
+#   else
+    fesetround(FE_TONEAREST);
+#   endif
+
+    cn_gpu_inner<ITERATIONS, MASK, INNER>(ctx[0]->state, ctx[0]->memory);
+    cn_gpu_inner<ITERATIONS, MASK, INNER>(ctx[1]->state, ctx[1]->memory);
+
+    cn_implode_scratchpad<xlarig::CRYPTONIGHT_HEAVY, MEM, SOFT_AES>((__m128i*) ctx[0]->memory, (__m128i*) ctx[0]->state);
+    cn_implode_scratchpad<xlarig::CRYPTONIGHT_HEAVY, MEM, SOFT_AES>((__m128i*) ctx[1]->memory, (__m128i*) ctx[1]->state);
+
+    cn_keccakf<2>(ctx);
+    memcpy(output,      ctx[0]->state, 32);
+    memcpy(output + 32, ctx[1]->state, 32);
+}
 #endif
 
 
@@ -757,54 +790,25 @@ extern "C" void cnv2_double_mainloop_sandybridge_asm(cryptonight_ctx **ctx);
 extern "C" void cnv2_rwz_mainloop_asm(cryptonight_ctx **ctx);
 extern "C" void cnv2_rwz_double_mainloop_asm(cryptonight_ctx **ctx);
 
-extern xlarig::CpuThread::cn_mainloop_fun        cn_half_mainloop_ivybridge_asm;
-extern xlarig::CpuThread::cn_mainloop_fun        cn_half_mainloop_ryzen_asm;
-extern xlarig::CpuThread::cn_mainloop_fun        cn_half_mainloop_bulldozer_asm;
-extern xlarig::CpuThread::cn_mainloop_fun        cn_half_double_mainloop_sandybridge_asm;
-
-extern xlarig::CpuThread::cn_mainloop_fun        cn_trtl_mainloop_ivybridge_asm;
-extern xlarig::CpuThread::cn_mainloop_fun        cn_trtl_mainloop_ryzen_asm;
-extern xlarig::CpuThread::cn_mainloop_fun        cn_trtl_mainloop_bulldozer_asm;
-extern xlarig::CpuThread::cn_mainloop_fun        cn_trtl_double_mainloop_sandybridge_asm;
-
-extern xlarig::CpuThread::cn_mainloop_fun        cn_zls_mainloop_ivybridge_asm;
-extern xlarig::CpuThread::cn_mainloop_fun        cn_zls_mainloop_ryzen_asm;
-extern xlarig::CpuThread::cn_mainloop_fun        cn_zls_mainloop_bulldozer_asm;
-extern xlarig::CpuThread::cn_mainloop_fun        cn_zls_double_mainloop_sandybridge_asm;
-
-extern xlarig::CpuThread::cn_mainloop_fun        cn_double_mainloop_ivybridge_asm;
-extern xlarig::CpuThread::cn_mainloop_fun        cn_double_mainloop_ryzen_asm;
-extern xlarig::CpuThread::cn_mainloop_fun        cn_double_mainloop_bulldozer_asm;
-extern xlarig::CpuThread::cn_mainloop_fun        cn_double_double_mainloop_sandybridge_asm;
-
-void wow_compile_code(const V4_Instruction* code, int code_size, void* machine_code, xlarig::Assembly ASM);
-void v4_compile_code(const V4_Instruction* code, int code_size, void* machine_code, xlarig::Assembly ASM);
-void wow_compile_code_double(const V4_Instruction* code, int code_size, void* machine_code, xlarig::Assembly ASM);
-void v4_compile_code_double(const V4_Instruction* code, int code_size, void* machine_code, xlarig::Assembly ASM);
-
-template<xlarig::Variant VARIANT>
-void cn_r_compile_code(const V4_Instruction* code, int code_size, void* machine_code, xlarig::Assembly ASM)
-{
-    v4_compile_code(code, code_size, machine_code, ASM);
-}
+extern xlarig::CnHash::cn_mainloop_fun        cn_half_mainloop_ivybridge_asm;
+extern xlarig::CnHash::cn_mainloop_fun        cn_half_mainloop_ryzen_asm;
+extern xlarig::CnHash::cn_mainloop_fun        cn_half_mainloop_bulldozer_asm;
+extern xlarig::CnHash::cn_mainloop_fun        cn_half_double_mainloop_sandybridge_asm;
 
-template<xlarig::Variant VARIANT>
-void cn_r_compile_code_double(const V4_Instruction* code, int code_size, void* machine_code, xlarig::Assembly ASM)
-{
-    v4_compile_code_double(code, code_size, machine_code, ASM);
-}
+extern xlarig::CnHash::cn_mainloop_fun        cn_trtl_mainloop_ivybridge_asm;
+extern xlarig::CnHash::cn_mainloop_fun        cn_trtl_mainloop_ryzen_asm;
+extern xlarig::CnHash::cn_mainloop_fun        cn_trtl_mainloop_bulldozer_asm;
+extern xlarig::CnHash::cn_mainloop_fun        cn_trtl_double_mainloop_sandybridge_asm;
 
-template<>
-void cn_r_compile_code<xlarig::VARIANT_WOW>(const V4_Instruction* code, int code_size, void* machine_code, xlarig::Assembly ASM)
-{
-    wow_compile_code(code, code_size, machine_code, ASM);
-}
+extern xlarig::CnHash::cn_mainloop_fun        cn_zls_mainloop_ivybridge_asm;
+extern xlarig::CnHash::cn_mainloop_fun        cn_zls_mainloop_ryzen_asm;
+extern xlarig::CnHash::cn_mainloop_fun        cn_zls_mainloop_bulldozer_asm;
+extern xlarig::CnHash::cn_mainloop_fun        cn_zls_double_mainloop_sandybridge_asm;
 
-template<>
-void cn_r_compile_code_double<xlarig::VARIANT_WOW>(const V4_Instruction* code, int code_size, void* machine_code, xlarig::Assembly ASM)
-{
-    wow_compile_code_double(code, code_size, machine_code, ASM);
-}
+extern xlarig::CnHash::cn_mainloop_fun        cn_double_mainloop_ivybridge_asm;
+extern xlarig::CnHash::cn_mainloop_fun        cn_double_mainloop_ryzen_asm;
+extern xlarig::CnHash::cn_mainloop_fun        cn_double_mainloop_bulldozer_asm;
+extern xlarig::CnHash::cn_mainloop_fun        cn_double_double_mainloop_sandybridge_asm;
 
 template<xlarig::Algo ALGO, xlarig::Variant VARIANT, xlarig::Assembly ASM>
 inline void cryptonight_single_hash_asm(const uint8_t *__restrict__ input, size_t size, uint8_t *__restrict__ output, cryptonight_ctx **__restrict__ ctx, uint64_t height)
@@ -812,11 +816,12 @@ inline void cryptonight_single_hash_asm(const uint8_t *__restrict__ input, size_
     constexpr size_t MEM = xlarig::cn_select_memory<ALGO>();
 
     if (xlarig::cn_is_cryptonight_r<VARIANT>() && !ctx[0]->generated_code_data.match(VARIANT, height)) {
-        V4_Instruction code[256];
-        const int code_size = v4_random_math_init<VARIANT>(code, height);
-        cn_r_compile_code<VARIANT>(code, code_size, reinterpret_cast<void*>(ctx[0]->generated_code), ASM);
-        ctx[0]->generated_code_data.variant = VARIANT;
-        ctx[0]->generated_code_data.height = height;
+        xlarig::CnrCodeCache::update(ctx[0], VARIANT, height, ASM, false, false);
+    }
+
+    if (xlarig::cn_is_cryptonight_r<VARIANT>() && !ctx[0]->generated_code) {
+        memset(output, 0xFF, 32);
+        return;
     }
 
     xlarig::keccak(input, size, ctx[0]->state);
@@ -896,15 +901,15 @@ inline void cryptonight_double_hash_asm(const uint8_t *__restrict__ input, size_
     constexpr size_t MEM = xlarig::cn_select_memory<ALGO>();
 
     if (xlarig::cn_is_cryptonight_r<VARIANT>() && !ctx[0]->generated_code_data.match(VARIANT, height)) {
-        V4_Instruction code[256];
-        const int code_size = v4_random_math_init<VARIANT>(code, height);
-        cn_r_compile_code_double<VARIANT>(code, code_size, reinterpret_cast<void*>(ctx[0]->generated_code), ASM);
-        ctx[0]->generated_code_data.variant = VARIANT;
-        ctx[0]->generated_code_data.height = height;
+        xlarig::CnrCodeCache::update(ctx[0], VARIANT, height, ASM, false, true);
+    }
+
+    if (xlarig::cn_is_cryptonight_r<VARIANT>() && !ctx[0]->generated_code) {
+        memset(output, 0xFF, 64);
+        return;
     }
 
-    xlarig::keccak(input,        size, ctx[0]->state);
-    xlarig::keccak(input + size, size, ctx[1]->state);
+    cn_keccak<2>(input, size, ctx);
 
     cn_explode_scratchpad<ALGO, MEM, false>(reinterpret_cast<__m128i*>(ctx[0]->state), reinterpret_cast<__m128i*>(ctx[0]->memory));
     cn_explode_scratchpad<ALGO, MEM, false>(reinterpret_cast<__m128i*>(ctx[1]->state), reinterpret_cast<__m128i*>(ctx[1]->memory));
@@ -934,8 +939,7 @@ inline void cryptonight_double_hash_asm(const uint8_t *__restrict__ input, size_
     cn_implode_scratchpad<ALGO, MEM, false>(reinterpret_cast<__m128i*>(ctx[0]->memory), reinterpret_cast<__m128i*>(ctx[0]->state));
     cn_implode_scratchpad<ALGO, MEM, false>(reinterpret_cast<__m128i*>(ctx[1]->memory), reinterpret_cast<__m128i*>(ctx[1]->state));
 
-    xlarig::keccakf(reinterpret_cast<uint64_t*>(ctx[0]->state), 24);
-    xlarig::keccakf(reinterpret_cast<uint64_t*>(ctx[1]->state), 24);
+    cn_keccakf<2>(ctx);
 
     extra_hashes[ctx[0]->state[0] & 3](ctx[0]->state, 200, output);
     extra_hashes[ctx[1]->state[0] & 3](ctx[1]->state, 200, output + 32);
@@ -943,7 +947,7 @@ inline void cryptonight_double_hash_asm(const uint8_t *__restrict__ input, size_
 #endif
 
 
-template<xlarig::Algo ALGO, bool SOFT_AES, xlarig::Variant VARIANT>
+template<xlarig::Algo ALGO, int SOFT_AES, xlarig::Variant VARIANT>
 inline void cryptonight_double_hash(const uint8_t *__restrict__ input, size_t size, uint8_t *__restrict__ output, cryptonight_ctx **__restrict__ ctx, uint64_t height)
 {
     constexpr size_t MASK         = xlarig::cn_select_mask<ALGO>();
@@ -956,8 +960,7 @@ inline void cryptonight_double_hash(const uint8_t *__restrict__ input, size_t si
         return;
     }
 
-    xlarig::keccak(input,        size, ctx[0]->state);
-    xlarig::keccak(input + size, size, ctx[1]->state);
+    cn_keccak<2>(input, size, ctx);
 
     const uint8_t* l0 = ctx[0]->memory;
     const uint8_t* l1 = ctx[1]->memory;
@@ -989,11 +992,8 @@ inline void cryptonight_double_hash(const uint8_t *__restrict__ input, size_t si
     uint64_t idx1 = al1;
 
     for (size_t i = 0; i < ITERATIONS; i++) {
-        __m128i cx0, cx1;
-        if (VARIANT == xlarig::VARIANT_TUBE || !SOFT_AES) {
-            cx0 = _mm_load_si128((__m128i *) &l0[idx0 & MASK]);
-            cx1 = _mm_load_si128((__m128i *) &l1[idx1 & MASK]);
-        }
+        __m128i cx0 = _mm_load_si128((__m128i *) &l0[idx0 & MASK]);
+        __m128i cx1 = _mm_load_si128((__m128i *) &l1[idx1 & MASK]);
 
         const __m128i ax0 = _mm_set_epi64x(ah0, al0);
         const __m128i ax1 = _mm_set_epi64x(ah1, al1);
@@ -1002,8 +1002,8 @@ inline void cryptonight_double_hash(const uint8_t *__restrict__ input, size_t si
             cx1 = aes_round_tweak_div(cx1, ax1);
         }
         else if (SOFT_AES) {
-            cx0 = soft_aesenc((uint32_t*)&l0[idx0 & MASK], ax0, (const uint32_t*)saes_table);
-            cx1 = soft_aesenc((uint32_t*)&l1[idx1 & MASK], ax1, (const uint32_t*)saes_table);
+            cx0 = soft_aes_round<SOFT_AES>(cx0, ax0);
+            cx1 = soft_aes_round<SOFT_AES>(cx1, ax1);
         }
         else {
             cx0 = _mm_aesenc_si128(cx0, ax0);
@@ -1146,8 +1146,7 @@ inline void cryptonight_double_hash(const uint8_t *__restrict__ input, size_t si
     cn_implode_scratchpad<ALGO, MEM, SOFT_AES>((__m128i*) l0, (__m128i*) h0);
     cn_implode_scratchpad<ALGO, MEM, SOFT_AES>((__m128i*) l1, (__m128i*) h1);
 
-    xlarig::keccakf(h0, 24);
-    xlarig::keccakf(h1, 24);
+    cn_keccakf<2>(ctx);
 
     extra_hashes[ctx[0]->state[0] & 3](ctx[0]->state, 200, output);
     extra_hashes[ctx[1]->state[0] & 3](ctx[1]->state, 200, output + 32);
@@ -1164,7 +1163,7 @@ inline void cryptonight_double_hash(const uint8_t *__restrict__ input, size_t si
         c = aes_round_tweak_div(c, a);                                 \
     }                                                                  \
     else if (SOFT_AES) {                                               \
-        c = soft_aesenc(&c, a, (const uint32_t*)saes_table);           \
+        c = soft_aes_round<SOFT_AES>(c, a);                            \
     } else {                                                           \
         c = _mm_aesenc_si128(c, a);                                    \
     }                                                                  \
@@ -1261,7 +1260,7 @@ inline void cryptonight_double_hash(const uint8_t *__restrict__ input, size_t si
     VARIANT4_RANDOM_MATH_INIT(n);
 
 
-template<xlarig::Algo ALGO, bool SOFT_AES, xlarig::Variant VARIANT>
+template<xlarig::Algo ALGO, int SOFT_AES, xlarig::Variant VARIANT>
 inline void cryptonight_triple_hash(const uint8_t *__restrict__ input, size_t size, uint8_t *__restrict__ output, cryptonight_ctx **__restrict__ ctx, uint64_t height)
 {
     constexpr size_t MASK         = xlarig::cn_select_mask<ALGO>();
@@ -1274,8 +1273,9 @@ inline void cryptonight_triple_hash(const uint8_t *__restrict__ input, size_t si
         return;
     }
 
+    cn_keccak<3>(input, size, ctx);
+
     for (size_t i = 0; i < 3; i++) {
-        xlarig::keccak(input + size * i, size, ctx[i]->state);
         cn_explode_scratchpad<ALGO, MEM, SOFT_AES>(reinterpret_cast<__m128i*>(ctx[i]->state), reinterpret_cast<__m128i*>(ctx[i]->memory));
     }
 
@@ -1319,13 +1319,17 @@ inline void cryptonight_triple_hash(const uint8_t *__restrict__ input, size_t si
 
     for (size_t i = 0; i < 3; i++) {
         cn_implode_scratchpad<ALGO, MEM, SOFT_AES>(reinterpret_cast<__m128i*>(ctx[i]->memory), reinterpret_cast<__m128i*>(ctx[i]->state));
-        xlarig::keccakf(reinterpret_cast<uint64_t*>(ctx[i]->state), 24);
+    }
+
+    cn_keccakf<3>(ctx);
+
+    for (size_t i = 0; i < 3; i++) {
         extra_hashes[ctx[i]->state[0] & 3](ctx[i]->state, 200, output + 32 * i);
     }
 }
 
 
-template<xlarig::Algo ALGO, bool SOFT_AES, xlarig::Variant VARIANT>
+template<xlarig::Algo ALGO, int SOFT_AES, xlarig::Variant VARIANT>
 inline void cryptonight_quad_hash(const uint8_t *__restrict__ input, size_t size, uint8_t *__restrict__ output, cryptonight_ctx **__restrict__ ctx, uint64_t height)
 {
     constexpr size_t MASK         = xlarig::cn_select_mask<ALGO>();
@@ -1338,8 +1342,9 @@ inline void cryptonight_quad_hash(const uint8_t *__restrict__ input, size_t size
         return;
     }
 
+    cn_keccak<4>(input, size, ctx);
+
     for (size_t i = 0; i < 4; i++) {
-        xlarig::keccak(input + size * i, size, ctx[i]->state);
         cn_explode_scratchpad<ALGO, MEM, SOFT_AES>(reinterpret_cast<__m128i*>(ctx[i]->state), reinterpret_cast<__m128i*>(ctx[i]->memory));
     }
 
@@ -1392,13 +1397,17 @@ inline void cryptonight_quad_hash(const uint8_t *__restrict__ input, size_t size
 
     for (size_t i = 0; i < 4; i++) {
         cn_implode_scratchpad<ALGO, MEM, SOFT_AES>(reinterpret_cast<__m128i*>(ctx[i]->memory), reinterpret_cast<__m128i*>(ctx[i]->state));
-        xlarig::keccakf(reinterpret_cast<uint64_t*>(ctx[i]->state), 24);
+    }
+
+    cn_keccakf<4>(ctx);
+
+    for (size_t i = 0; i < 4; i++) {
         extra_hashes[ctx[i]->state[0] & 3](ctx[i]->state, 200, output + 32 * i);
     }
 }
 
 
-template<xlarig::Algo ALGO, bool SOFT_AES, xlarig::Variant VARIANT>
+template<xlarig::Algo ALGO, int SOFT_AES, xlarig::Variant VARIANT>
 inline void cryptonight_penta_hash(const uint8_t *__restrict__ input, size_t size, uint8_t *__restrict__ output, cryptonight_ctx **__restrict__ ctx, uint64_t height)
 {
     constexpr size_t MASK         = xlarig::cn_select_mask<ALGO>();
@@ -1411,8 +1420,9 @@ inline void cryptonight_penta_hash(const uint8_t *__restrict__ input, size_t siz
         return;
     }
 
+    cn_keccak<5>(input, size, ctx);
+
     for (size_t i = 0; i < 5; i++) {
-        xlarig::keccak(input + size * i, size, ctx[i]->state);
         cn_explode_scratchpad<ALGO, MEM, SOFT_AES>(reinterpret_cast<__m128i*>(ctx[i]->state), reinterpret_cast<__m128i*>(ctx[i]->memory));
     }
 
@@ -1473,7 +1483,118 @@ inline void cryptonight_penta_hash(const uint8_t *__restrict__ input, size_t siz
 
     for (size_t i = 0; i < 5; i++) {
         cn_implode_scratchpad<ALGO, MEM, SOFT_AES>(reinterpret_cast<__m128i*>(ctx[i]->memory), reinterpret_cast<__m128i*>(ctx[i]->state));
-        xlarig::keccakf(reinterpret_cast<uint64_t*>(ctx[i]->state), 24);
+    }
+
+    cn_keccakf<5>(ctx);
+
+    for (size_t i = 0; i < 5; i++) {
+        extra_hashes[ctx[i]->state[0] & 3](ctx[i]->state, 200, output + 32 * i);
+    }
+}
+
+
+/**
+ * Generic N-way kernel for the wider (6 to 8 way) modes, each lane keeps its registers in arrays indexed
+ * by a compile time constant, so after unrolling it compiles to the same code as the hand-written kernels.
+ * The CN_STEP macros paste their "part" argument into local names, the lane-local aliases below use "x".
+ */
+template<xlarig::Algo ALGO, int SOFT_AES, xlarig::Variant VARIANT, size_t N>
+inline void cryptonight_multi_hash(const uint8_t *__restrict__ input, size_t size, uint8_t *__restrict__ output, cryptonight_ctx **__restrict__ ctx, uint64_t height)
+{
+    constexpr size_t MASK         = xlarig::cn_select_mask<ALGO>();
+    constexpr size_t ITERATIONS   = xlarig::cn_select_iter<ALGO, VARIANT>();
+    constexpr size_t MEM          = xlarig::cn_select_memory<ALGO>();
+    constexpr xlarig::Variant BASE = xlarig::cn_base_variant<VARIANT>();
+
+    if (BASE == xlarig::VARIANT_1 && size < 43) {
+        memset(output, 0, 32 * N);
+        return;
+    }
+
+    cn_keccak<N>(input, size, ctx);
+
+    for (size_t i = 0; i < N; i++) {
+        cn_explode_scratchpad<ALGO, MEM, SOFT_AES>(reinterpret_cast<__m128i*>(ctx[i]->state), reinterpret_cast<__m128i*>(ctx[i]->memory));
+    }
+
+    uint8_t *l[N];
+    uint64_t idx[N];
+    __m128i ax[N], bx0[N], bx1[N], cx[N], mc[N];
+    __m128i division_result_xmm[N], sqrt_result_xmm[N];
+    uint32_t r[N][9];
+    struct V4_Instruction code[256];
+
+    if ((VARIANT == xlarig::VARIANT_WOW) || (VARIANT == xlarig::VARIANT_4)) {
+        v4_random_math_init<VARIANT>(code, height);
+    }
+
+    for (size_t j = 0; j < N; j++) {
+        const uint64_t *h = reinterpret_cast<const uint64_t*>(ctx[j]->state);
+
+        l[j]                   = ctx[j]->memory;
+        mc[j]                  = _mm_setzero_si128();
+        division_result_xmm[j] = _mm_cvtsi64_si128(h[12]);
+        sqrt_result_xmm[j]     = _mm_cvtsi64_si128(h[13]);
+
+        if (BASE == xlarig::VARIANT_1) {
+            mc[j] = _mm_set_epi64x(*reinterpret_cast<const uint64_t*>(input + j * size + 35) ^ h[24], 0);
+        }
+
+        if ((VARIANT == xlarig::VARIANT_WOW) || (VARIANT == xlarig::VARIANT_4)) {
+            r[j][0] = static_cast<uint32_t>(h[12]);
+            r[j][1] = static_cast<uint32_t>(h[12] >> 32);
+            r[j][2] = static_cast<uint32_t>(h[13]);
+            r[j][3] = static_cast<uint32_t>(h[13] >> 32);
+        }
+
+        ax[j]  = _mm_set_epi64x(h[1] ^ h[5], h[0] ^ h[4]);
+        bx0[j] = _mm_set_epi64x(h[3] ^ h[7], h[2] ^ h[6]);
+        bx1[j] = _mm_set_epi64x(h[9] ^ h[11], h[8] ^ h[10]);
+        cx[j]  = _mm_setzero_si128();
+        idx[j] = _mm_cvtsi128_si64(ax[j]);
+    }
+
+    VARIANT2_SET_ROUNDING_MODE();
+
+    for (size_t i = 0; i < ITERATIONS; i++) {
+        uint64_t hi, lo;
+        uint64_t cl[N], ch[N];
+        __m128i *ptr[N];
+
+        for (size_t j = 0; j < N; j++) {
+            CN_STEP1(ax[j], bx0[j], bx1[j], cx[j], l[j], ptr[j], idx[j]);
+        }
+
+        for (size_t j = 0; j < N; j++) {
+            CN_STEP2(ax[j], bx0[j], bx1[j], cx[j], l[j], ptr[j], idx[j]);
+        }
+
+        for (size_t j = 0; j < N; j++) {
+            CN_STEP3(x, ax[j], bx0[j], bx1[j], cx[j], l[j], ptr[j], idx[j]);
+
+            cl[j] = clx;
+            ch[j] = chx;
+        }
+
+        for (size_t j = 0; j < N; j++) {
+            uint64_t clx                  = cl[j];
+            const uint64_t chx            = ch[j];
+            uint32_t *rx                  = r[j];
+            const V4_Instruction *codex   = code;
+            __m128i &division_result_xmm_x = division_result_xmm[j];
+            __m128i &sqrt_result_xmm_x     = sqrt_result_xmm[j];
+
+            CN_STEP4(x, ax[j], bx0[j], bx1[j], cx[j], l[j], mc[j], ptr[j], idx[j]);
+        }
+    }
+
+    for (size_t i = 0; i < N; i++) {
+        cn_implode_scratchpad<ALGO, MEM, SOFT_AES>(reinterpret_cast<__m128i*>(ctx[i]->memory), reinterpret_cast<__m128i*>(ctx[i]->state));
+    }
+
+    cn_keccakf<N>(ctx);
+
+    for (size_t i = 0; i < N; i++) {
         extra_hashes[ctx[i]->state[0] & 3](ctx[i]->state, 200, output + 32 * i);
     }
 }
@@ -0,0 +1,216 @@
+/* XMRig and XLArig
+ * Copyright 2010      Jeff Garzik <jgarzik@pobox.com>
+ * Copyright 2012-2014 pooler      <pooler@litecoinpool.org>
+ * Copyright 2014      Lucas Jones <https://github.com/lucasjones>
+ * Copyright 2014-2016 Wolf9466    <https://github.com/OhGodAPet>
+ * Copyright 2016      Jay D Dee   <jayddee246@gmail.com>
+ * Copyright 2017-2019 XMR-Stak    <https://github.com/fireice-uk>, <https://github.com/psychocrypt>
+ * Copyright 2018-2019 SChernykh   <https://github.com/SChernykh>
+ * Copyright 2016-2019 XMRig       <support@xmrig.com>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "crypto/cn/CryptoNight_constants.h"
+
+#ifdef __GNUC__
+#   include <x86intrin.h>
+#else
+#   include <intrin.h>
+#   define __restrict__ __restrict
+#endif
+
+
+/*
+ * The AVX2 kernel computes the two 32 byte halves of a 64 byte scratchpad line one after another,
+ * both halves only depend on the line loaded at the start of the iteration, so here they share a
+ * single 512 bit register: 128 bit lanes 0-1 hold the idx0 half and lanes 2-3 the idx2 half.
+ * Only AVX-512F instructions are used, per-lane byte rotations are built from dword shifts.
+ */
+
+
+inline __m512 fma_break(const __m512& x)
+{
+    // Break the dependency chain by setitng the exp to ?????01
+    __m512 xx = _mm512_castsi512_ps(_mm512_and_si512(_mm512_set1_epi32(0xFEFFFFFF), _mm512_castps_si512(x)));
+    return _mm512_castsi512_ps(_mm512_or_si512(_mm512_set1_epi32(0x00800000), _mm512_castps_si512(xx)));
+}
+
+
+inline __m512 mask_exp(const __m512& x, int and_mask, int or_mask)
+{
+    const __m512i r = _mm512_and_si512(_mm512_set1_epi32(and_mask), _mm512_castps_si512(x));
+    return _mm512_castsi512_ps(_mm512_or_si512(_mm512_set1_epi32(or_mask), r));
+}
+
+
+// 14
+inline void sub_round(const __m512& n0, const __m512& n1, const __m512& n2, const __m512& n3, const __m512& rnd_c, __m512& n, __m512& d, __m512& c)
+{
+    __m512 nn = _mm512_mul_ps(n0, c);
+    nn = _mm512_mul_ps(_mm512_add_ps(n1, c), _mm512_mul_ps(nn, nn));
+    nn = fma_break(nn);
+    n = _mm512_add_ps(n, nn);
+
+    __m512 dd = _mm512_mul_ps(n2, c);
+    dd = _mm512_mul_ps(_mm512_sub_ps(n3, c), _mm512_mul_ps(dd, dd));
+    dd = fma_break(dd);
+    d = _mm512_add_ps(d, dd);
+
+    //Constant feedback
+    c = _mm512_add_ps(c, rnd_c);
+    c = _mm512_add_ps(c, _mm512_set1_ps(0.734375f));
+    __m512 r = _mm512_add_ps(nn, dd);
+    r = mask_exp(r, 0x807FFFFF, 0x40000000);
+    c = _mm512_add_ps(c, r);
+}
+
+
+// 14*8 + 2 = 112
+inline void round_compute(const __m512& n0, const __m512& n1, const __m512& n2, const __m512& n3, const __m512& rnd_c, __m512& c, __m512& r)
+{
+    __m512 n = _mm512_setzero_ps(), d = _mm512_setzero_ps();
+
+    sub_round(n0, n1, n2, n3, rnd_c, n, d, c);
+    sub_round(n1, n2, n3, n0, rnd_c, n, d, c);
+    sub_round(n2, n3, n0, n1, rnd_c, n, d, c);
+    sub_round(n3, n0, n1, n2, rnd_c, n, d, c);
+    sub_round(n3, n2, n1, n0, rnd_c, n, d, c);
+    sub_round(n2, n1, n0, n3, rnd_c, n, d, c);
+    sub_round(n1, n0, n3, n2, rnd_c, n, d, c);
+    sub_round(n0, n3, n2, n1, rnd_c, n, d, c);
+
+    // Make sure abs(d) > 2.0 - this prevents division by zero and accidental overflows by division by < 1.0
+    d = mask_exp(d, 0xFF7FFFFF, 0x40000000);
+    r = _mm512_add_ps(r, _mm512_div_ps(n, d));
+}
+
+
+// 112×4 = 448
+template <bool add>
+inline __m512i double_compute(const __m512& n0, const __m512& n1, const __m512& n2, const __m512& n3, const __m512& cnt, const __m512& rnd_c, __m512& sum)
+{
+    __m512 c = cnt;
+    __m512 r = _mm512_setzero_ps();
+
+    round_compute(n0, n1, n2, n3, rnd_c, c, r);
+    round_compute(n0, n1, n2, n3, rnd_c, c, r);
+    round_compute(n0, n1, n2, n3, rnd_c, c, r);
+    round_compute(n0, n1, n2, n3, rnd_c, c, r);
+
+    // do a quick fmod by setting exp to 2
+    r = mask_exp(r, 0x807FFFFF, 0x40000000);
+
+    if(add)
+        sum = _mm512_add_ps(sum, r);
+    else
+        sum = r;
+
+    r = _mm512_mul_ps(r, _mm512_set1_ps(536870880.0f)); // 35
+    return _mm512_cvttps_epi32(r);
+}
+
+
+// Rotates every 128 bit lane right by rot bytes, same as the bslli/bsrli pair of the AVX2 kernel.
+template <size_t rot>
+inline __m512i rotate_lanes(const __m512i& r)
+{
+    const __m512i next = _mm512_shuffle_epi32(r, _MM_PERM_ADCB);
+
+    return _mm512_or_si512(_mm512_srli_epi32(r, rot * 8), _mm512_slli_epi32(next, 32 - rot * 8));
+}
+
+
+template <size_t rot>
+inline void double_compute_wrap(const __m512& n0, const __m512& n1, const __m512& n2, const __m512& n3, const __m512& cnt, const __m512& rnd_c, __m512& sum, __m512i& out)
+{
+    __m512i r = double_compute<rot % 2 != 0>(n0, n1, n2, n3, cnt, rnd_c, sum);
+    if(rot != 0)
+        r = rotate_lanes<rot>(r);
+
+    out = _mm512_xor_si512(out, r);
+}
+
+
+// Per 128 bit lane counters, {l0, h0} for the idx0 half and {l1, h1} for the idx2 half.
+inline __m512 counters(float l0, float h0, float l1, float h1)
+{
+    return _mm512_setr_ps(l0, l0, l0, l0, h0, h0, h0, h0, l1, l1, l1, l1, h1, h1, h1, h1);
+}
+
+
+template<uint32_t MASK>
+inline __m512i* scratchpad_line(uint8_t* lpad, uint32_t idx) { return reinterpret_cast<__m512i*>(lpad + (idx & MASK)); }
+
+
+template<size_t ITER, uint32_t MASK>
+void cn_gpu_inner_avx512(const uint8_t* spad, uint8_t* lpad)
+{
+    static_assert((MASK & 63) == 0, "scratchpad lines must be 64 byte aligned");
+
+    uint32_t s = reinterpret_cast<const uint32_t*>(spad)[0] >> 8;
+    __m512i* idx = scratchpad_line<MASK>(lpad, s);
+    __m512 rc = _mm512_setzero_ps();
+
+    const __m512 c0 = counters(1.3437500f, 1.4296875f, 1.4140625f, 1.3203125f);
+    const __m512 c1 = counters(1.2812500f, 1.3984375f, 1.2734375f, 1.3515625f);
+    const __m512 c2 = counters(1.3593750f, 1.3828125f, 1.2578125f, 1.3359375f);
+    const __m512 c3 = counters(1.3671875f, 1.3046875f, 1.2890625f, 1.4609375f);
+
+    for(size_t i = 0; i < ITER; i++)
+    {
+        const __m512i v = _mm512_load_si512(idx);
+        const __m512 n0 = _mm512_cvtepi32_ps(v);
+
+        // {n10, n11}, {n22, n02} and {n33, n30} of the AVX2 kernel
+        const __m512 n1 = _mm512_shuffle_f32x4(n0, n0, _MM_SHUFFLE(1, 1, 0, 1));
+        const __m512 n2 = _mm512_shuffle_f32x4(n0, n0, _MM_SHUFFLE(2, 0, 2, 2));
+        const __m512 n3 = _mm512_shuffle_f32x4(n0, n0, _MM_SHUFFLE(0, 3, 3, 3));
+
+        __m512 suma, sumb;
+        __m512i out = _mm512_setzero_si512();
+        double_compute_wrap<0>(n0, n1, n2, n3, c0, rc, suma, out);
+        double_compute_wrap<1>(n0, n2, n3, n1, c1, rc, suma, out);
+        double_compute_wrap<2>(n0, n3, n1, n2, c2, rc, sumb, out);
+        double_compute_wrap<3>(n0, n3, n2, n1, c3, rc, sumb, out);
+        _mm512_store_si512(idx, _mm512_xor_si512(v, out));
+
+        // Keep the AVX2 summation order: (sum0.lo + sum0.hi) + (sum1.lo + sum1.hi)
+        const __m512 sum01 = _mm512_add_ps(suma, sumb);
+        const __m256 s0 = _mm512_castps512_ps256(sum01);
+        const __m256 s1 = _mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(sum01), 1));
+        __m128 sum = _mm_add_ps(_mm_add_ps(_mm256_castps256_ps128(s0), _mm256_extractf128_ps(s0, 1)),
+                                _mm_add_ps(_mm256_castps256_ps128(s1), _mm256_extractf128_ps(s1, 1)));
+
+        const __m256i out01 = _mm256_xor_si256(_mm512_castsi512_si256(out), _mm512_extracti64x4_epi64(out, 1));
+        const __m128i out2  = _mm_xor_si128(_mm256_castsi256_si128(out01), _mm256_extracti128_si256(out01, 1));
+
+        sum = _mm_and_ps(_mm_castsi128_ps(_mm_set1_epi32(0x7fffffff)), sum); // take abs(va) by masking the float sign bit
+        // vs range 0 - 64
+        __m128i v0 = _mm_cvttps_epi32(_mm_mul_ps(sum, _mm_set1_ps(16777216.0f)));
+        v0 = _mm_xor_si128(v0, out2);
+        __m128i v1 = _mm_shuffle_epi32(v0, _MM_SHUFFLE(0, 1, 2, 3));
+        v0 = _mm_xor_si128(v0, v1);
+        v1 = _mm_shuffle_epi32(v0, _MM_SHUFFLE(0, 1, 0, 1));
+        v0 = _mm_xor_si128(v0, v1);
+
+        // vs is now between 0 and 1
+        sum = _mm_div_ps(sum, _mm_set1_ps(64.0f));
+        rc = _mm512_broadcast_f32x4(sum);
+        uint32_t n = _mm_cvtsi128_si32(v0);
+        idx = scratchpad_line<MASK>(lpad, n);
+    }
+}
+
+template void cn_gpu_inner_avx512<xlarig::CRYPTONIGHT_GPU_ITER, xlarig::CRYPTONIGHT_GPU_MASK>(const uint8_t* spad, uint8_t* lpad);
@@ -0,0 +1,312 @@
+/* XMRig and XLArig
+ * Copyright 2010      Jeff Garzik <jgarzik@pobox.com>
+ * Copyright 2012-2014 pooler      <pooler@litecoinpool.org>
+ * Copyright 2014      Lucas Jones <https://github.com/lucasjones>
+ * Copyright 2014-2016 Wolf9466    <https://github.com/OhGodAPet>
+ * Copyright 2016      Jay D Dee   <jayddee246@gmail.com>
+ * Copyright 2017-2018 XMR-Stak    <https://github.com/fireice-uk>, <https://github.com/psychocrypt>
+ * Copyright 2018-2019 SChernykh   <https://github.com/SChernykh>
+ * Copyright 2016-2019 XMRig       <https://github.com/xmrig>, <support@xmrig.com>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include <uv.h>
+
+
+#include "crypto/cn/CryptoNight_monero.h"
+#include "crypto/cn/r/CnrCodeCache.h"
+#include "crypto/common/VirtualMemory.h"
+
+
+void wow_compile_code(const V4_Instruction* code, int code_size, void* machine_code, xlarig::Assembly ASM);
+void v4_compile_code(const V4_Instruction* code, int code_size, void* machine_code, xlarig::Assembly ASM);
+void wow_compile_code_double(const V4_Instruction* code, int code_size, void* machine_code, xlarig::Assembly ASM);
+void v4_compile_code_double(const V4_Instruction* code, int code_size, void* machine_code, xlarig::Assembly ASM);
+void wow_soft_aes_compile_code(const V4_Instruction* code, int code_size, void* machine_code, xlarig::Assembly ASM);
+void v4_soft_aes_compile_code(const V4_Instruction* code, int code_size, void* machine_code, xlarig::Assembly ASM);
+
+
+namespace xlarig {
+
+
+/**
+ * Slots that no context is running are recycled least recently requested first.
+ */
+static const size_t kSlots     = 32;
+static const size_t kSlotSize  = CN_GENERATED_CODE_SIZE;
+static const size_t kMaxKinds  = 8;
+
+
+struct CnrKey
+{
+    inline bool isKind(const CnrKey &other) const { return variant == other.variant && assembly == other.assembly && softAES == other.softAES && doubleWay == other.doubleWay; }
+    inline bool operator==(const CnrKey &other) const { return isKind(other) && height == other.height; }
+
+    Variant variant;
+    uint64_t height;
+    Assembly assembly;
+    bool softAES;
+    bool doubleWay;
+};
+
+
+struct CnrSlot
+{
+    CnrKey key;
+    uint64_t used;
+    uint32_t refs;
+    bool valid;
+};
+
+
+static CnrKey kinds[kMaxKinds];
+static CnrSlot slots[kSlots];
+static size_t kindsCount = 0;
+static uint64_t counter  = 0;
+static uint8_t *memory   = nullptr;
+static uv_mutex_t mutex;
+static uv_once_t once    = UV_ONCE_INIT;
+
+
+static void init()
+{
+    uv_mutex_init(&mutex);
+
+    memory = static_cast<uint8_t *>(VirtualMemory::allocateExecutableMemory(kSlots * kSlotSize));
+    if (memory) {
+        VirtualMemory::protectExecutableMemory(memory, kSlots * kSlotSize);
+    }
+}
+
+
+template<Variant VARIANT>
+static void compile(const CnrKey &key, void *machine_code)
+{
+    V4_Instruction code[256];
+    const int code_size = v4_random_math_init<VARIANT>(code, key.height);
+
+    if (key.softAES) {
+        if (VARIANT == VARIANT_WOW) {
+            wow_soft_aes_compile_code(code, code_size, machine_code, ASM_NONE);
+        }
+        else {
+            v4_soft_aes_compile_code(code, code_size, machine_code, ASM_NONE);
+        }
+    }
+    else if (key.doubleWay) {
+        if (VARIANT == VARIANT_WOW) {
+            wow_compile_code_double(code, code_size, machine_code, key.assembly);
+        }
+        else {
+            v4_compile_code_double(code, code_size, machine_code, key.assembly);
+        }
+    }
+    else {
+        if (VARIANT == VARIANT_WOW) {
+            wow_compile_code(code, code_size, machine_code, key.assembly);
+        }
+        else {
+            v4_compile_code(code, code_size, machine_code, key.assembly);
+        }
+    }
+}
+
+
+static void compile(const CnrKey &key, void *machine_code)
+{
+    if (key.variant == VARIANT_WOW) {
+        compile<VARIANT_WOW>(key, machine_code);
+    }
+    else {
+        compile<VARIANT_4>(key, machine_code);
+    }
+}
+
+
+/**
+ * Must be called with the mutex held, returns the slot holding the context's program or nullptr.
+ */
+static CnrSlot *slotOf(const cryptonight_ctx *ctx)
+{
+    const uintptr_t code  = reinterpret_cast<uintptr_t>(ctx->generated_code);
+    const uintptr_t begin = reinterpret_cast<uintptr_t>(memory);
+
+    if (!memory || code < begin || code >= begin + kSlots * kSlotSize) {
+        return nullptr;
+    }
+
+    return &slots[(code - begin) / kSlotSize];
+}
+
+
+/**
+ * Must be called with the mutex held. A pinned result must be released with unpin() by the caller,
+ * nullptr is returned if the program is not cached and every slot is in use.
+ */
+static cn_mainloop_fun_ms_abi lookup(const CnrKey &key, bool pin)
+{
+    CnrSlot *victim = nullptr;
+
+    for (CnrSlot &slot : slots) {
+        if (slot.valid && slot.key == key) {
+            slot.used  = ++counter;
+            slot.refs += pin ? 1 : 0;
+
+            return reinterpret_cast<cn_mainloop_fun_ms_abi>(memory + (&slot - slots) * kSlotSize);
+        }
+
+        if (slot.refs > 0) {
+            continue;
+        }
+
+        if (!victim || !slot.valid || (victim->valid && slot.used < victim->used)) {
+            victim = &slot;
+        }
+    }
+
+    if (!victim) {
+        return nullptr;
+    }
+
+    uint8_t *code = memory + (victim - slots) * kSlotSize;
+
+    VirtualMemory::unprotectExecutableMemory(code, kSlotSize);
+    compile(key, code);
+    VirtualMemory::protectExecutableMemory(code, kSlotSize);
+
+    victim->key   = key;
+    victim->used  = ++counter;
+    victim->refs  = pin ? 1 : 0;
+    victim->valid = true;
+
+    return reinterpret_cast<cn_mainloop_fun_ms_abi>(code);
+}
+
+
+/**
+ * Must be called with the mutex held.
+ */
+static void unpin(const cryptonight_ctx *ctx)
+{
+    CnrSlot *slot = slotOf(ctx);
+    if (slot && slot->refs > 0) {
+        slot->refs--;
+    }
+}
+
+
+} /* namespace xlarig */
+
+
+/**
+ * Compile the programs for the given height and the next one for every flavour the workers have used,
+ * called from the main thread when a job arrives.
+ */
+void xlarig::CnrCodeCache::prefetch(Variant variant, uint64_t height)
+{
+    if (variant != VARIANT_WOW && variant != VARIANT_4) {
+        return;
+    }
+
+    uv_once(&once, init);
+
+    if (!memory) {
+        return;
+    }
+
+    uv_mutex_lock(&mutex);
+
+    for (size_t i = 0; i < kindsCount; ++i) {
+        if (kinds[i].variant != variant) {
+            continue;
+        }
+
+        CnrKey key = kinds[i];
+        key.height = height;
+        lookup(key, false);
+
+        key.height = height + 1;
+        lookup(key, false);
+    }
+
+    uv_mutex_unlock(&mutex);
+}
+
+
+/**
+ * Drop the context's hold on its cached program, called before the context is freed.
+ */
+void xlarig::CnrCodeCache::release(cryptonight_ctx *ctx)
+{
+    if (!memory) {
+        return;
+    }
+
+    uv_mutex_lock(&mutex);
+    unpin(ctx);
+    uv_mutex_unlock(&mutex);
+
+    ctx->generated_code = nullptr;
+}
+
+
+/**
+ * Point the context at the program for the given height, the cached copy is pinned until the context
+ * moves to another height or is released.
+ */
+void xlarig::CnrCodeCache::update(cryptonight_ctx *ctx, Variant variant, uint64_t height, Assembly assembly, bool softAES, bool doubleWay)
+{
+    uv_once(&once, init);
+
+    const CnrKey key = { variant, height, softAES ? ASM_NONE : assembly, softAES, doubleWay && !softAES };
+    cn_mainloop_fun_ms_abi code = nullptr;
+
+    if (memory) {
+        uv_mutex_lock(&mutex);
+        unpin(ctx);
+
+        bool known = false;
+        for (size_t i = 0; i < kindsCount; ++i) {
+            known |= kinds[i].isKind(key);
+        }
+
+        if (!known && kindsCount < kMaxKinds) {
+            kinds[kindsCount++] = key;
+        }
+
+        code = lookup(key, true);
+        uv_mutex_unlock(&mutex);
+    }
+
+    // the shared cache is unavailable or every slot is pinned, only then the context gets its own buffer
+    if (!code && !ctx->generated_code_buffer) {
+        ctx->generated_code_buffer = static_cast<uint8_t *>(VirtualMemory::allocateExecutableMemory(kSlotSize));
+    }
+    else if (code && ctx->generated_code_buffer) {
+        VirtualMemory::freeExecutableMemory(ctx->generated_code_buffer, kSlotSize);
+        ctx->generated_code_buffer = nullptr;
+    }
+
+    // without any executable memory the pointer stays null, the worker parks until the next job
+    if (!code && ctx->generated_code_buffer) {
+        compile(key, ctx->generated_code_buffer);
+        code = reinterpret_cast<cn_mainloop_fun_ms_abi>(ctx->generated_code_buffer);
+    }
+
+    ctx->generated_code              = code;
+    ctx->generated_code_data.variant = variant;
+    ctx->generated_code_data.height  = height;
+}
@@ -0,0 +1,61 @@
+/* XMRig and XLArig
+ * Copyright 2010      Jeff Garzik <jgarzik@pobox.com>
+ * Copyright 2012-2014 pooler      <pooler@litecoinpool.org>
+ * Copyright 2014      Lucas Jones <https://github.com/lucasjones>
+ * Copyright 2014-2016 Wolf9466    <https://github.com/OhGodAPet>
+ * Copyright 2016      Jay D Dee   <jayddee246@gmail.com>
+ * Copyright 2017-2018 XMR-Stak    <https://github.com/fireice-uk>, <https://github.com/psychocrypt>
+ * Copyright 2018-2019 SChernykh   <https://github.com/SChernykh>
+ * Copyright 2016-2019 XMRig       <https://github.com/xmrig>, <support@xmrig.com>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef XMRIG_CNRCODECACHE_H
+#define XMRIG_CNRCODECACHE_H
+
+
+#include <stdint.h>
+
+
+#include "common/xlarig.h"
+#include "crypto/cn/CryptoNight.h"
+
+
+namespace xlarig {
+
+
+/**
+ * @brief Process wide cache of compiled CryptoNight-R main loops.
+ *
+ * Every program depends only on (variant, height) and the code flavour (assembly, soft AES,
+ * single/double), so threads share one copy in read+exec pages instead of compiling their own.
+ * Workers::setJob() prefetches the job height and the next one for every flavour seen so far,
+ * hashing threads only swap their ctx function pointer. A slot stays pinned while a context uses
+ * it, if every slot is pinned the program is compiled into a code buffer allocated for the context,
+ * if that fails too the context is left without a program.
+ */
+class CnrCodeCache
+{
+public:
+    static void prefetch(Variant variant, uint64_t height);
+    static void release(cryptonight_ctx *ctx);
+    static void update(cryptonight_ctx *ctx, Variant variant, uint64_t height, Assembly assembly, bool softAES, bool doubleWay);
+};
+
+
+} /* namespace xlarig */
+
+
+#endif /* XMRIG_CNRCODECACHE_H */
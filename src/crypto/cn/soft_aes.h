@@ -38,6 +38,20 @@
 #include <inttypes.h>
 
 
+namespace xlarig {
+
+
+// software AES flavour of a CryptoNight kernel, passed as its SOFT_AES template parameter
+enum SoftAes {
+    SOFT_AES_OFF,
+    SOFT_AES_TABLE,
+    SOFT_AES_VPERM
+};
+
+
+} /* namespace xlarig */
+
+
 #define saes_data(w) {\
     w(0x63), w(0x7c), w(0x77), w(0x7b), w(0xf2), w(0x6b), w(0x6f), w(0xc5),\
     w(0x30), w(0x01), w(0x67), w(0x2b), w(0xfe), w(0xd7), w(0xab), w(0x76),\
@@ -89,6 +103,7 @@
 alignas(16) const uint32_t saes_table[4][256] = { saes_data(saes_u0), saes_data(saes_u1), saes_data(saes_u2), saes_data(saes_u3) };
 alignas(16) const uint8_t  saes_sbox[256] = saes_data(saes_h0);
 
+
 static inline __m128i soft_aesenc(const uint32_t* in, __m128i key)
 {
     const uint32_t x0 = in[0];
@@ -144,3 +159,79 @@ static inline __m128i soft_aeskeygenassist(__m128i key)
     const uint32_t X3 = sub_word(_mm_cvtsi128_si32(_mm_shuffle_epi32(key, 0xFF)));
     return _mm_set_epi32(_rotr(X3, 8) ^ rcon, X3, _rotr(X1, 8) ^ rcon, X1);
 }
+
+
+#if !defined(XMRIG_ARM)
+#   if defined(__GNUC__)
+#       define SAES_TARGET_SSSE3 __attribute__((target("ssse3")))
+#   else
+#       define SAES_TARGET_SSSE3
+#   endif
+
+
+/*
+ * Table-free software AES (vector permutation technique by M. Hamburg).
+ *
+ * SubBytes is computed as an inversion in GF(2^4)^2 where every step is a 16 entry pshufb lookup,
+ * so no memory access depends on the data and the T-tables above are never touched by the hash.
+ * ShiftRows is folded into the input shuffle, MixColumns is done with byte rotations and xtime.
+ * Only these functions are built for SSSE3, kernels use them when the CPU has it (SOFT_AES_VPERM).
+ */
+static SAES_TARGET_SSSE3 inline __m128i soft_aes_sub_bytes(__m128i x)
+{
+    const __m128i mask    = _mm_set1_epi8(0x0F);
+    const __m128i ipt_lo  = _mm_set_epi64x(0xCABAE09052227808, 0xC2B2E8985A2A7000);
+    const __m128i ipt_hi  = _mm_set_epi64x(0xCD80B1FCB0FDCC81, 0x4C01307D317C4D00);
+    const __m128i inv     = _mm_set_epi64x(0x040703090A0B0C02, 0x0E05060F0D080180);
+    const __m128i inva    = _mm_set_epi64x(0x030D0E0C02050809, 0x01040A060F0B0780);
+    const __m128i sbou    = _mm_set_epi64x(0x15AABF7AC502A878, 0xD0D26D176FBDC700);
+    const __m128i sbot    = _mm_set_epi64x(0x8E1E90D1412B35FA, 0xCFE474A55FBB6A00);
+
+    // change of basis
+    x = _mm_xor_si128(_mm_shuffle_epi8(ipt_lo, _mm_and_si128(x, mask)), _mm_shuffle_epi8(ipt_hi, _mm_and_si128(_mm_srli_epi32(x, 4), mask)));
+
+    // inversion
+    const __m128i i   = _mm_and_si128(_mm_srli_epi32(x, 4), mask);
+    const __m128i k   = _mm_and_si128(x, mask);
+    const __m128i j   = _mm_xor_si128(i, k);
+    const __m128i ak  = _mm_shuffle_epi8(inva, k);
+    const __m128i iak = _mm_xor_si128(_mm_shuffle_epi8(inv, i), ak);
+    const __m128i jak = _mm_xor_si128(_mm_shuffle_epi8(inv, j), ak);
+    const __m128i io  = _mm_xor_si128(_mm_shuffle_epi8(inv, iak), j);
+    const __m128i jo  = _mm_xor_si128(_mm_shuffle_epi8(inv, jak), i);
+
+    // affine transform back to the standard basis
+    return _mm_xor_si128(_mm_xor_si128(_mm_shuffle_epi8(sbou, io), _mm_shuffle_epi8(sbot, jo)), _mm_set1_epi8(0x63));
+}
+
+
+static SAES_TARGET_SSSE3 inline __m128i soft_aes_xtime(__m128i x)
+{
+    const __m128i carry = _mm_and_si128(_mm_cmplt_epi8(x, _mm_setzero_si128()), _mm_set1_epi8(0x1B));
+
+    return _mm_xor_si128(_mm_add_epi8(x, x), carry);
+}
+
+
+static SAES_TARGET_SSSE3 inline __m128i soft_aesenc_ssse3(__m128i in, __m128i key)
+{
+    const __m128i s  = soft_aes_sub_bytes(_mm_shuffle_epi8(in, _mm_setr_epi8(0, 5, 10, 15, 4, 9, 14, 3, 8, 13, 2, 7, 12, 1, 6, 11)));
+    const __m128i r1 = _mm_shuffle_epi8(s, _mm_setr_epi8(1, 2, 3, 0, 5, 6, 7, 4, 9, 10, 11, 8, 13, 14, 15, 12));
+    const __m128i r2 = _mm_shuffle_epi8(s, _mm_setr_epi8(2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13));
+    const __m128i r3 = _mm_shuffle_epi8(s, _mm_setr_epi8(3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14));
+
+    // MixColumns: 2*a0 ^ 3*a1 ^ a2 ^ a3 == xtime(a0 ^ a1) ^ a1 ^ a2 ^ a3
+    const __m128i out = _mm_xor_si128(_mm_xor_si128(soft_aes_xtime(_mm_xor_si128(s, r1)), r1), _mm_xor_si128(r2, r3));
+
+    return _mm_xor_si128(out, key);
+}
+
+
+template<uint8_t rcon>
+static SAES_TARGET_SSSE3 inline __m128i soft_aeskeygenassist_ssse3(__m128i key)
+{
+    const __m128i s = _mm_shuffle_epi8(soft_aes_sub_bytes(key), _mm_setr_epi8(4, 5, 6, 7, 5, 6, 7, 4, 12, 13, 14, 15, 13, 14, 15, 12));
+
+    return _mm_xor_si128(s, _mm_set_epi32(rcon, 0, rcon, 0));
+}
+#endif
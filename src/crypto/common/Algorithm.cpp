@@ -31,6 +31,7 @@
 
 
 #include "crypto/common/Algorithm.h"
+#include "crypto/common/Algorithms.h"
 
 
 #ifdef _MSC_VER
@@ -44,66 +45,8 @@
 #endif
 
 
-struct AlgoData
-{
-    const char *name;
-    const char *shortName;
-    xlarig::Algo algo;
-    xlarig::Variant variant;
-};
-
-
-static AlgoData const algorithms[] = {
-    { "cryptonight",           "cn",           xlarig::CRYPTONIGHT,       xlarig::VARIANT_AUTO   },
-    { "cryptonight/0",         "cn/0",         xlarig::CRYPTONIGHT,       xlarig::VARIANT_0      },
-    { "cryptonight/1",         "cn/1",         xlarig::CRYPTONIGHT,       xlarig::VARIANT_1      },
-    { "cryptonight/xtl",       "cn/xtl",       xlarig::CRYPTONIGHT,       xlarig::VARIANT_XTL    },
-    { "cryptonight/msr",       "cn/msr",       xlarig::CRYPTONIGHT,       xlarig::VARIANT_MSR    },
-    { "cryptonight/xao",       "cn/xao",       xlarig::CRYPTONIGHT,       xlarig::VARIANT_XAO    },
-    { "cryptonight/rto",       "cn/rto",       xlarig::CRYPTONIGHT,       xlarig::VARIANT_RTO    },
-    { "cryptonight/2",         "cn/2",         xlarig::CRYPTONIGHT,       xlarig::VARIANT_2      },
-    { "cryptonight/half",      "cn/half",      xlarig::CRYPTONIGHT,       xlarig::VARIANT_HALF   },
-    { "cryptonight/xtlv9",     "cn/xtlv9",     xlarig::CRYPTONIGHT,       xlarig::VARIANT_HALF   },
-    { "cryptonight/wow",       "cn/wow",       xlarig::CRYPTONIGHT,       xlarig::VARIANT_WOW    },
-    { "cryptonight/r",         "cn/r",         xlarig::CRYPTONIGHT,       xlarig::VARIANT_4      },
-    { "cryptonight/rwz",       "cn/rwz",       xlarig::CRYPTONIGHT,       xlarig::VARIANT_RWZ    },
-    { "cryptonight/zls",       "cn/zls",       xlarig::CRYPTONIGHT,       xlarig::VARIANT_ZLS    },
-    { "cryptonight/double",    "cn/double",    xlarig::CRYPTONIGHT,       xlarig::VARIANT_DOUBLE },
-
-#   ifdef XMRIG_ALGO_RANDOMX
-    { "defyx",           "defyx",       xlarig::RANDOM_X,          xlarig::VARIANT_RX_DEFYX },
-#   endif
-
-#   ifdef XMRIG_ALGO_CN_LITE
-    { "cryptonight-lite",      "cn-lite",      xlarig::CRYPTONIGHT_LITE,  xlarig::VARIANT_AUTO },
-    { "cryptonight-light",     "cn-light",     xlarig::CRYPTONIGHT_LITE,  xlarig::VARIANT_AUTO },
-    { "cryptonight-lite/0",    "cn-lite/0",    xlarig::CRYPTONIGHT_LITE,  xlarig::VARIANT_0    },
-    { "cryptonight-lite/1",    "cn-lite/1",    xlarig::CRYPTONIGHT_LITE,  xlarig::VARIANT_1    },
-#   endif
-
-#   ifdef XMRIG_ALGO_CN_HEAVY
-    { "cryptonight-heavy",      "cn-heavy",      xlarig::CRYPTONIGHT_HEAVY, xlarig::VARIANT_AUTO },
-    { "cryptonight-heavy/0",    "cn-heavy/0",    xlarig::CRYPTONIGHT_HEAVY, xlarig::VARIANT_0    },
-    { "cryptonight-heavy/xhv",  "cn-heavy/xhv",  xlarig::CRYPTONIGHT_HEAVY, xlarig::VARIANT_XHV  },
-    { "cryptonight-heavy/tube", "cn-heavy/tube", xlarig::CRYPTONIGHT_HEAVY, xlarig::VARIANT_TUBE },
-#   endif
-
-#   ifdef XMRIG_ALGO_CN_PICO
-    { "cryptonight-pico/trtl",  "cn-pico/trtl",  xlarig::CRYPTONIGHT_PICO, xlarig::VARIANT_TRTL },
-    { "cryptonight-pico",       "cn-pico",       xlarig::CRYPTONIGHT_PICO, xlarig::VARIANT_TRTL },
-    { "cryptonight-turtle",     "cn-trtl",       xlarig::CRYPTONIGHT_PICO, xlarig::VARIANT_TRTL },
-    { "cryptonight-ultralite",  "cn-ultralite",  xlarig::CRYPTONIGHT_PICO, xlarig::VARIANT_TRTL },
-    { "cryptonight_turtle",     "cn_turtle",     xlarig::CRYPTONIGHT_PICO, xlarig::VARIANT_TRTL },
-#   endif
-
-#   ifdef XMRIG_ALGO_CN_GPU
-    { "cryptonight/gpu",        "cn/gpu",  xlarig::CRYPTONIGHT, xlarig::VARIANT_GPU },
-#   endif
-};
-
-
 #ifdef XMRIG_PROXY_PROJECT
-static AlgoData const xmrStakAlgorithms[] = {
+static xlarig::AlgoData const xmrStakAlgorithms[] = {
     { "cryptonight-monerov7",    nullptr, xlarig::CRYPTONIGHT,       xlarig::VARIANT_1    },
     { "cryptonight_v7",          nullptr, xlarig::CRYPTONIGHT,       xlarig::VARIANT_1    },
     { "cryptonight-monerov8",    nullptr, xlarig::CRYPTONIGHT,       xlarig::VARIANT_2    },
@@ -156,8 +99,8 @@ bool xlarig::Algorithm::isValid() const
         return false;
     }
 
-    for (size_t i = 0; i < ARRAY_SIZE(algorithms); i++) {
-        if (algorithms[i].algo == m_algo && algorithms[i].variant == m_variant) {
+    for (size_t i = 0; i < kAlgorithmsCount; i++) {
+        if (kAlgorithms[i].algo == m_algo && kAlgorithms[i].variant == m_variant) {
             return true;
         }
     }
@@ -192,10 +135,10 @@ void xlarig::Algorithm::parseAlgorithm(const char *algo)
         return parseAlgorithm(algo + 1);
     }
 
-    for (size_t i = 0; i < ARRAY_SIZE(algorithms); i++) {
-        if ((strcasecmp(algo, algorithms[i].name) == 0) || (strcasecmp(algo, algorithms[i].shortName) == 0)) {
-            m_algo    = algorithms[i].algo;
-            m_variant = algorithms[i].variant;
+    for (size_t i = 0; i < kAlgorithmsCount; i++) {
+        if ((strcasecmp(algo, kAlgorithms[i].name) == 0) || (strcasecmp(algo, kAlgorithms[i].shortName) == 0)) {
+            m_algo    = kAlgorithms[i].algo;
+            m_variant = kAlgorithms[i].variant;
             break;
         }
     }
@@ -292,9 +235,9 @@ void xlarig::Algorithm::parseXmrStakAlgorithm(const char *algo)
 
 const char *xlarig::Algorithm::name(bool shortName) const
 {
-    for (size_t i = 0; i < ARRAY_SIZE(algorithms); i++) {
-        if (algorithms[i].algo == m_algo && algorithms[i].variant == m_variant) {
-            return shortName ? algorithms[i].shortName : algorithms[i].name;
+    for (size_t i = 0; i < kAlgorithmsCount; i++) {
+        if (kAlgorithms[i].algo == m_algo && kAlgorithms[i].variant == m_variant) {
+            return shortName ? kAlgorithms[i].shortName : kAlgorithms[i].name;
         }
     }
 
@@ -0,0 +1,138 @@
+/* XMRig and XLArig
+ * Copyright 2010      Jeff Garzik <jgarzik@pobox.com>
+ * Copyright 2012-2014 pooler      <pooler@litecoinpool.org>
+ * Copyright 2014      Lucas Jones <https://github.com/lucasjones>
+ * Copyright 2014-2016 Wolf9466    <https://github.com/OhGodAPet>
+ * Copyright 2016      Jay D Dee   <jayddee246@gmail.com>
+ * Copyright 2017-2018 XMR-Stak    <https://github.com/fireice-uk>, <https://github.com/psychocrypt>
+ * Copyright 2018      Lee Clagett <https://github.com/vtnerd>
+ * Copyright 2018-2019 SChernykh   <https://github.com/SChernykh>
+ * Copyright 2016-2019 XMRig       <https://github.com/xmrig>, <support@xmrig.com>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef XMRIG_ALGORITHMS_H
+#define XMRIG_ALGORITHMS_H
+
+
+#include <stddef.h>
+
+
+#include "common/xlarig.h"
+
+
+namespace xlarig {
+
+
+enum AlgoImpl {
+    IMPL_NONE,   // name only, autodetect rows and RandomX
+    IMPL_CN,     // CryptoNight kernels for every multiway and AES mode
+    IMPL_CN_ASM, // IMPL_CN plus the assembly main loops for single and double hash
+    IMPL_CN_GPU  // cn/gpu, single and double hash only
+};
+
+
+struct AlgoData
+{
+    const char *name;
+    const char *shortName;
+    Algo algo;
+    Variant variant;
+    AlgoImpl impl;
+};
+
+
+/**
+ * Single list of known algorithms: names for parsing and printing, and the kernels CnHash::fn()
+ * dispatch tables are generated from at compile time. Aliases must repeat the impl of the first row.
+ */
+static constexpr AlgoData kAlgorithms[] = {
+    { "cryptonight",            "cn",            CRYPTONIGHT,       VARIANT_AUTO,     IMPL_NONE   },
+    { "cryptonight/0",          "cn/0",          CRYPTONIGHT,       VARIANT_0,        IMPL_CN     },
+    { "cryptonight/1",          "cn/1",          CRYPTONIGHT,       VARIANT_1,        IMPL_CN     },
+    { "cryptonight/xtl",        "cn/xtl",        CRYPTONIGHT,       VARIANT_XTL,      IMPL_CN     },
+    { "cryptonight/msr",        "cn/msr",        CRYPTONIGHT,       VARIANT_MSR,      IMPL_CN     },
+    { "cryptonight/xao",        "cn/xao",        CRYPTONIGHT,       VARIANT_XAO,      IMPL_CN     },
+    { "cryptonight/rto",        "cn/rto",        CRYPTONIGHT,       VARIANT_RTO,      IMPL_CN     },
+    { "cryptonight/2",          "cn/2",          CRYPTONIGHT,       VARIANT_2,        IMPL_CN_ASM },
+    { "cryptonight/half",       "cn/half",       CRYPTONIGHT,       VARIANT_HALF,     IMPL_CN_ASM },
+    { "cryptonight/xtlv9",      "cn/xtlv9",      CRYPTONIGHT,       VARIANT_HALF,     IMPL_CN_ASM },
+    { "cryptonight/wow",        "cn/wow",        CRYPTONIGHT,       VARIANT_WOW,      IMPL_CN_ASM },
+    { "cryptonight/r",          "cn/r",          CRYPTONIGHT,       VARIANT_4,        IMPL_CN_ASM },
+    { "cryptonight/rwz",        "cn/rwz",        CRYPTONIGHT,       VARIANT_RWZ,      IMPL_CN_ASM },
+    { "cryptonight/zls",        "cn/zls",        CRYPTONIGHT,       VARIANT_ZLS,      IMPL_CN_ASM },
+    { "cryptonight/double",     "cn/double",     CRYPTONIGHT,       VARIANT_DOUBLE,   IMPL_CN_ASM },
+
+#   ifdef XMRIG_ALGO_RANDOMX
+    { "defyx",                  "defyx",         RANDOM_X,          VARIANT_RX_DEFYX, IMPL_NONE   },
+#   endif
+
+#   ifdef XMRIG_ALGO_CN_LITE
+    { "cryptonight-lite",       "cn-lite",       CRYPTONIGHT_LITE,  VARIANT_AUTO,     IMPL_NONE   },
+    { "cryptonight-light",      "cn-light",      CRYPTONIGHT_LITE,  VARIANT_AUTO,     IMPL_NONE   },
+    { "cryptonight-lite/0",     "cn-lite/0",     CRYPTONIGHT_LITE,  VARIANT_0,        IMPL_CN     },
+    { "cryptonight-lite/1",     "cn-lite/1",     CRYPTONIGHT_LITE,  VARIANT_1,        IMPL_CN     },
+#   endif
+
+#   ifdef XMRIG_ALGO_CN_HEAVY
+    { "cryptonight-heavy",      "cn-heavy",      CRYPTONIGHT_HEAVY, VARIANT_AUTO,     IMPL_NONE   },
+    { "cryptonight-heavy/0",    "cn-heavy/0",    CRYPTONIGHT_HEAVY, VARIANT_0,        IMPL_CN     },
+    { "cryptonight-heavy/xhv",  "cn-heavy/xhv",  CRYPTONIGHT_HEAVY, VARIANT_XHV,      IMPL_CN     },
+    { "cryptonight-heavy/tube", "cn-heavy/tube", CRYPTONIGHT_HEAVY, VARIANT_TUBE,     IMPL_CN     },
+#   endif
+
+#   ifdef XMRIG_ALGO_CN_PICO
+    { "cryptonight-pico/trtl",  "cn-pico/trtl",  CRYPTONIGHT_PICO,  VARIANT_TRTL,     IMPL_CN_ASM },
+    { "cryptonight-pico",       "cn-pico",       CRYPTONIGHT_PICO,  VARIANT_TRTL,     IMPL_CN_ASM },
+    { "cryptonight-turtle",     "cn-trtl",       CRYPTONIGHT_PICO,  VARIANT_TRTL,     IMPL_CN_ASM },
+    { "cryptonight-ultralite",  "cn-ultralite",  CRYPTONIGHT_PICO,  VARIANT_TRTL,     IMPL_CN_ASM },
+    { "cryptonight_turtle",     "cn_turtle",     CRYPTONIGHT_PICO,  VARIANT_TRTL,     IMPL_CN_ASM },
+#   endif
+
+#   ifdef XMRIG_ALGO_CN_GPU
+    { "cryptonight/gpu",        "cn/gpu",        CRYPTONIGHT,       VARIANT_GPU,      IMPL_CN_GPU },
+#   endif
+};
+
+
+constexpr const size_t kAlgorithmsCount = sizeof(kAlgorithms) / sizeof(kAlgorithms[0]);
+
+
+// index of the first row for the pair, kAlgorithmsCount if there is none
+constexpr size_t algorithm_index(Algo algo, Variant variant, size_t i = 0)
+{
+    return i == kAlgorithmsCount ? i : ((kAlgorithms[i].algo == algo && kAlgorithms[i].variant == variant) ? i : algorithm_index(algo, variant, i + 1));
+}
+
+
+constexpr AlgoImpl algorithm_impl(Algo algo, Variant variant)
+{
+    return algorithm_index(algo, variant) == kAlgorithmsCount ? IMPL_NONE : kAlgorithms[algorithm_index(algo, variant)].impl;
+}
+
+
+constexpr bool algorithm_aliases_match(size_t i = 0)
+{
+    return i == kAlgorithmsCount || (algorithm_impl(kAlgorithms[i].algo, kAlgorithms[i].variant) == kAlgorithms[i].impl && algorithm_aliases_match(i + 1));
+}
+
+
+static_assert(algorithm_aliases_match(), "aliases in kAlgorithms must use the same impl as the first row of the pair");
+
+
+} /* namespace xlarig */
+
+
+#endif /* XMRIG_ALGORITHMS_H */
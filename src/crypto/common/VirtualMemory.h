@@ -41,6 +41,7 @@ public:
     static void *allocateExecutableMemory(size_t size);
     static void *allocateLargePagesMemory(size_t size);
     static void flushInstructionCache(void *p, size_t size);
+    static void freeExecutableMemory(void *p, size_t size);
     static void freeLargePagesMemory(void *p, size_t size);
     static void protectExecutableMemory(void *p, size_t size);
     static void unprotectExecutableMemory(void *p, size_t size);
@@ -72,6 +72,12 @@ void xlarig::VirtualMemory::flushInstructionCache(void *p, size_t size)
 }
 
 
+void xlarig::VirtualMemory::freeExecutableMemory(void *p, size_t size)
+{
+    munmap(p, size);
+}
+
+
 void xlarig::VirtualMemory::freeLargePagesMemory(void *p, size_t size)
 {
     munmap(p, size);
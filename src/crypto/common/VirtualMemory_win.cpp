@@ -66,6 +66,12 @@ void xlarig::VirtualMemory::flushInstructionCache(void *p, size_t size)
 }
 
 
+void xlarig::VirtualMemory::freeExecutableMemory(void *p, size_t)
+{
+    VirtualFree(p, 0, MEM_RELEASE);
+}
+
+
 void xlarig::VirtualMemory::freeLargePagesMemory(void *p, size_t)
 {
     VirtualFree(p, 0, MEM_RELEASE);
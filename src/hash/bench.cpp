@@ -0,0 +1,134 @@
+/* XMRig and XLArig
+ * Copyright 2010      Jeff Garzik <jgarzik@pobox.com>
+ * Copyright 2012-2014 pooler      <pooler@litecoinpool.org>
+ * Copyright 2014      Lucas Jones <https://github.com/lucasjones>
+ * Copyright 2014-2016 Wolf9466    <https://github.com/OhGodAPet>
+ * Copyright 2016      Jay D Dee   <jayddee246@gmail.com>
+ * Copyright 2017-2018 XMR-Stak    <https://github.com/fireice-uk>, <https://github.com/psychocrypt>
+ * Copyright 2018-2019 SChernykh   <https://github.com/SChernykh>
+ * Copyright 2016-2019 XMRig       <https://github.com/xmrig>, <support@xmrig.com>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <thread>
+#include <vector>
+
+
+#include "hash/xlarig_hash.h"
+
+
+static const size_t kBlobSize = 76;
+
+
+struct BenchResult
+{
+    uint64_t count = 0;
+    int status     = XLARIG_HASH_OK;
+};
+
+
+static void run(const char *algo, size_t batch, uint32_t seed, const std::atomic<bool> &stop, BenchResult &result)
+{
+    std::vector<uint8_t> data(batch * kBlobSize);
+    std::vector<const uint8_t *> blobs(batch);
+    std::vector<size_t> sizes(batch, kBlobSize);
+    std::vector<uint8_t> out(batch * XLARIG_HASH_SIZE);
+    const uint8_t seedHash[32] = { 0 };
+
+    for (size_t i = 0; i < data.size(); ++i) {
+        seed = seed * 1103515245 + 12345;
+        data[i] = static_cast<uint8_t>(seed >> 16);
+    }
+
+    for (size_t i = 0; i < batch; ++i) {
+        blobs[i] = data.data() + i * kBlobSize;
+    }
+
+    while (!stop.load(std::memory_order_relaxed)) {
+        result.status = xlarig_hash_verify(algo, 1806260, seedHash, blobs.data(), sizes.data(), batch, out.data());
+        if (result.status != XLARIG_HASH_OK) {
+            break;
+        }
+
+        for (size_t i = 0; i < batch; ++i) {
+            data[i * kBlobSize + 39]++;
+        }
+
+        result.count += batch;
+    }
+
+    xlarig_hash_thread_release();
+}
+
+
+int main(int argc, char **argv)
+{
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <algo> [threads] [seconds] [batch]\n", argv[0]);
+
+        return 1;
+    }
+
+    const char *algo     = argv[1];
+    const size_t threads = argc > 2 ? strtoul(argv[2], nullptr, 10) : std::max(std::thread::hardware_concurrency(), 1u);
+    const int seconds    = argc > 3 ? atoi(argv[3]) : 10;
+    const size_t batch   = argc > 4 ? strtoul(argv[4], nullptr, 10) : 8;
+
+    if (threads == 0 || seconds <= 0 || batch == 0) {
+        fprintf(stderr, "threads, seconds and batch must be positive\n");
+
+        return 1;
+    }
+
+    std::atomic<bool> stop(false);
+    std::vector<BenchResult> results(threads);
+    std::vector<std::thread> workers;
+
+    const auto start = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < threads; ++i) {
+        workers.emplace_back(run, algo, batch, static_cast<uint32_t>(i + 1), std::cref(stop), std::ref(results[i]));
+    }
+
+    std::this_thread::sleep_for(std::chrono::seconds(seconds));
+    stop = true;
+
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    uint64_t total       = 0;
+
+    for (size_t i = 0; i < threads; ++i) {
+        if (results[i].status != XLARIG_HASH_OK) {
+            fprintf(stderr, "thread %zu: verify failed with status %d\n", i, results[i].status);
+
+            return 2;
+        }
+
+        printf("thread %-3zu %10.1f verifications/s\n", i, results[i].count / elapsed);
+        total += results[i].count;
+    }
+
+    printf("%s, %zu threads, batch %zu: %.1f verifications/s total, %.1f per core\n", algo, threads, batch, total / elapsed, total / elapsed / threads);
+
+    return 0;
+}
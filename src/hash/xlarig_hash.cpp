@@ -0,0 +1,387 @@
+/* XMRig and XLArig
+ * Copyright 2010      Jeff Garzik <jgarzik@pobox.com>
+ * Copyright 2012-2014 pooler      <pooler@litecoinpool.org>
+ * Copyright 2014      Lucas Jones <https://github.com/lucasjones>
+ * Copyright 2014-2016 Wolf9466    <https://github.com/OhGodAPet>
+ * Copyright 2016      Jay D Dee   <jayddee246@gmail.com>
+ * Copyright 2017-2018 XMR-Stak    <https://github.com/fireice-uk>, <https://github.com/psychocrypt>
+ * Copyright 2018-2019 SChernykh   <https://github.com/SChernykh>
+ * Copyright 2016-2019 XMRig       <https://github.com/xmrig>, <support@xmrig.com>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <iterator>
+#include <string.h>
+#include <uv.h>
+#include <vector>
+
+
+#include "common/cpu/Cpu.h"
+#include "crypto/cn/CnHash.h"
+#include "crypto/cn/CryptoNight.h"
+#include "crypto/common/Algorithm.h"
+#include "hash/xlarig_hash.h"
+#include "Mem.h"
+
+
+#ifdef XMRIG_ALGO_RANDOMX
+#   include "defyx.h"
+#endif
+
+
+namespace xlarig {
+
+
+static const size_t kMaxWays    = 8;
+static const size_t kMinBlob    = 43;
+static uv_once_t once           = UV_ONCE_INIT;
+
+
+static const AlgoVariant kHardAV[kMaxWays] = { AV_SINGLE,      AV_DOUBLE,      AV_TRIPLE,      AV_QUAD,      AV_PENTA,      AV_HEXA,      AV_HEPTA,      AV_OCTA      };
+static const AlgoVariant kSoftAV[kMaxWays] = { AV_SINGLE_SOFT, AV_DOUBLE_SOFT, AV_TRIPLE_SOFT, AV_QUAD_SOFT, AV_PENTA_SOFT, AV_HEXA_SOFT, AV_HEPTA_SOFT, AV_OCTA_SOFT };
+
+
+#ifdef XMRIG_ALGO_RANDOMX
+/**
+ * Light mode caches for the current and the previous seed, so shares around an epoch change
+ * don't rebuild the cache on every call. Readers hold the slot lock while hashing.
+ */
+struct DefyxSlot
+{
+    uv_rwlock_t lock;
+    defyx_cache *cache;
+    uint64_t generation;
+    uint64_t used;
+    uint8_t seed[32];
+    bool valid;
+};
+
+
+static const size_t kDefyxSlots = 2;
+static DefyxSlot defyxSlots[kDefyxSlots];
+static uv_mutex_t defyxMutex;
+static uint64_t defyxCounter = 0;
+#endif
+
+
+static void init()
+{
+    Cpu::init();
+    Mem::init(true);
+
+#   ifndef XMRIG_NO_ASM
+    CnHash::patchAsmVariants();
+#   endif
+
+#   ifdef XMRIG_ALGO_RANDOMX
+    uv_mutex_init(&defyxMutex);
+
+    for (DefyxSlot &slot : defyxSlots) {
+        uv_rwlock_init(&slot.lock);
+        slot.cache      = nullptr;
+        slot.generation = 0;
+        slot.used       = 0;
+        slot.valid      = false;
+    }
+#   endif
+}
+
+
+class HashContext
+{
+public:
+    inline ~HashContext() { release(); }
+
+    inline cryptonight_ctx **ctx()  { return m_ctx; }
+    inline uint8_t *input(size_t size) { if (m_input.size() < size) { m_input.resize(size); } return m_input.data(); }
+
+    bool reserve(const Algorithm &algorithm, size_t ways);
+    void release();
+
+#   ifdef XMRIG_ALGO_RANDOMX
+    defyx_vm *vm(const DefyxSlot &slot);
+#   endif
+
+private:
+    cryptonight_ctx *m_ctx[kMaxWays] = {};
+    MemInfo m_memory;
+    size_t m_count = 0;
+    std::vector<uint8_t> m_input;
+
+#   ifdef XMRIG_ALGO_RANDOMX
+    const DefyxSlot *m_slot = nullptr;
+    defyx_vm *m_vm          = nullptr;
+    uint64_t m_generation   = 0;
+#   endif
+};
+
+
+static thread_local HashContext context;
+
+
+/**
+ * The arena is only reallocated when it is too small or has too few lanes, so a thread that
+ * alternates between algorithms settles on one allocation.
+ */
+bool HashContext::reserve(const Algorithm &algorithm, size_t ways)
+{
+    const size_t scratchpad = Mem::scratchpad(algorithm);
+
+    if (ways <= m_count && Mem::carve(m_ctx, m_memory, scratchpad, ways)) {
+        return true;
+    }
+
+    if (m_count) {
+        Mem::release(m_ctx, m_count, m_memory);
+        m_count = 0;
+    }
+
+    m_memory = Mem::create(m_ctx, algorithm.algo(), ways);
+    m_count  = ways;
+
+    return Mem::carve(m_ctx, m_memory, scratchpad, ways);
+}
+
+
+void HashContext::release()
+{
+    if (m_count) {
+        Mem::release(m_ctx, m_count, m_memory);
+        m_memory = MemInfo();
+        m_count  = 0;
+    }
+
+#   ifdef XMRIG_ALGO_RANDOMX
+    if (m_vm) {
+        defyx_destroy_vm(m_vm);
+        m_vm   = nullptr;
+        m_slot = nullptr;
+    }
+#   endif
+}
+
+
+#ifdef XMRIG_ALGO_RANDOMX
+defyx_vm *HashContext::vm(const DefyxSlot &slot)
+{
+    if (m_vm && m_slot == &slot && m_generation == slot.generation) {
+        return m_vm;
+    }
+
+    if (!m_vm) {
+        int flags = RANDOMX_FLAG_JIT;
+        if (Cpu::info()->hasAES()) {
+            flags |= RANDOMX_FLAG_HARD_AES;
+        }
+
+        m_vm = defyx_create_vm(static_cast<defyx_flags>(flags), slot.cache, nullptr);
+    }
+    else {
+        defyx_vm_set_cache(m_vm, slot.cache);
+    }
+
+    m_slot       = m_vm ? &slot : nullptr;
+    m_generation = slot.generation;
+
+    return m_vm;
+}
+
+
+/**
+ * Returns the slot for the seed read locked, the least recently used slot is rebuilt on a miss.
+ */
+static DefyxSlot *acquire(const uint8_t *seed)
+{
+    uv_mutex_lock(&defyxMutex);
+
+    DefyxSlot *slot = nullptr;
+    for (DefyxSlot &s : defyxSlots) {
+        if (s.valid && memcmp(s.seed, seed, sizeof(s.seed)) == 0) {
+            slot = &s;
+            break;
+        }
+    }
+
+    if (!slot) {
+        slot = std::min_element(std::begin(defyxSlots), std::end(defyxSlots), [](const DefyxSlot &a, const DefyxSlot &b) { return a.used < b.used; });
+
+        uv_rwlock_wrlock(&slot->lock);
+
+        if (!slot->cache) {
+            slot->cache = defyx_alloc_cache(static_cast<defyx_flags>(RANDOMX_FLAG_JIT | RANDOMX_FLAG_LARGE_PAGES));
+            if (!slot->cache) {
+                slot->cache = defyx_alloc_cache(RANDOMX_FLAG_JIT);
+            }
+        }
+
+        if (slot->cache) {
+            memcpy(slot->seed, seed, sizeof(slot->seed));
+            defyx_init_cache(slot->cache, slot->seed, sizeof(slot->seed));
+            slot->generation++;
+        }
+
+        slot->valid = slot->cache != nullptr;
+        uv_rwlock_wrunlock(&slot->lock);
+
+        if (!slot->valid) {
+            uv_mutex_unlock(&defyxMutex);
+
+            return nullptr;
+        }
+    }
+
+    slot->used = ++defyxCounter;
+    uv_rwlock_rdlock(&slot->lock);
+    uv_mutex_unlock(&defyxMutex);
+
+    return slot;
+}
+
+
+static int verifyDefyx(const uint8_t *seed, const uint8_t *const blobs[], const size_t sizes[], size_t n, uint8_t *out)
+{
+    if (!seed) {
+        return XLARIG_HASH_INVALID_ARGUMENT;
+    }
+
+    DefyxSlot *slot = acquire(seed);
+    if (!slot) {
+        return XLARIG_HASH_NO_MEMORY;
+    }
+
+    defyx_vm *vm = context.vm(*slot);
+    if (vm) {
+        for (size_t i = 0; i < n; ++i) {
+            defyx_calculate_hash(vm, blobs[i], sizes[i], out + i * XLARIG_HASH_SIZE);
+        }
+    }
+
+    uv_rwlock_rdunlock(&slot->lock);
+
+    return vm ? XLARIG_HASH_OK : XLARIG_HASH_NO_MEMORY;
+}
+#endif
+
+
+/**
+ * Lanes per call: as many scratchpads as fit in this thread's share of L3, like the automatic
+ * multiway layout of the miner, reduced until a kernel exists (cn/gpu has two way kernels only).
+ * cn/r and cn/wow stay at two lanes, wider kernels interpret the random program every iteration.
+ */
+static CnHash::cn_hash_fun select(const Algorithm &algorithm, size_t &ways)
+{
+    const ICpuInfo *info      = Cpu::info();
+    const size_t scratchpad   = Mem::scratchpad(algorithm);
+    const size_t budget       = static_cast<size_t>(std::max(info->L3(), 0)) * 1024 / static_cast<size_t>(std::max(info->threads(), 1));
+    const AlgoVariant *avs    = info->hasAES() ? kHardAV : kSoftAV;
+
+    ways = std::min(ways, std::max<size_t>(budget / scratchpad, 1));
+
+    if (algorithm.variant() == VARIANT_4 || algorithm.variant() == VARIANT_WOW) {
+        ways = std::min<size_t>(ways, 2);
+    }
+
+    for (; ways > 0; --ways) {
+        CnHash::cn_hash_fun fn = CnHash::fn(algorithm.algo(), avs[ways - 1], algorithm.variant(), ASM_AUTO);
+        if (fn) {
+            return fn;
+        }
+    }
+
+    return nullptr;
+}
+
+
+static int verifyCn(const Algorithm &algorithm, uint64_t height, const uint8_t *const blobs[], const size_t sizes[], size_t n, uint8_t *out)
+{
+    for (size_t i = 0; i < n; ++i) {
+        if (sizes[i] < kMinBlob) {
+            return XLARIG_HASH_INVALID_ARGUMENT;
+        }
+    }
+
+    size_t i = 0;
+    while (i < n) {
+        size_t ways = 1;
+        while (ways < kMaxWays && i + ways < n && sizes[i + ways] == sizes[i]) {
+            ways++;
+        }
+
+        CnHash::cn_hash_fun fn = select(algorithm, ways);
+        if (!fn) {
+            return XLARIG_HASH_INVALID_ALGO;
+        }
+
+        if (!context.reserve(algorithm, ways)) {
+            return XLARIG_HASH_NO_MEMORY;
+        }
+
+        const size_t size = sizes[i];
+        const uint8_t *input = blobs[i];
+
+        if (ways > 1) {
+            uint8_t *buf = context.input(ways * size);
+            for (size_t j = 0; j < ways; ++j) {
+                memcpy(buf + j * size, blobs[i + j], size);
+            }
+
+            input = buf;
+        }
+
+        fn(input, size, out + i * XLARIG_HASH_SIZE, context.ctx(), height);
+        i += ways;
+    }
+
+    return XLARIG_HASH_OK;
+}
+
+
+} /* namespace xlarig */
+
+
+int xlarig_hash_verify(const char *algo, uint64_t height, const uint8_t *seed_hash, const uint8_t *const blobs[], const size_t sizes[], size_t n, uint8_t *out)
+{
+    using namespace xlarig;
+
+    if (!algo || (n && (!blobs || !sizes || !out))) {
+        return XLARIG_HASH_INVALID_ARGUMENT;
+    }
+
+    const Algorithm algorithm(algo);
+    if (!algorithm.isValid() || algorithm.variant() == VARIANT_AUTO) {
+        return XLARIG_HASH_INVALID_ALGO;
+    }
+
+    uv_once(&once, init);
+
+#   ifdef XMRIG_ALGO_RANDOMX
+    if (algorithm.algo() == RANDOM_X) {
+        return verifyDefyx(seed_hash, blobs, sizes, n, out);
+    }
+#   else
+    if (algorithm.algo() == RANDOM_X) {
+        return XLARIG_HASH_INVALID_ALGO;
+    }
+#   endif
+
+    return verifyCn(algorithm, height, blobs, sizes, n, out);
+}
+
+
+void xlarig_hash_thread_release(void)
+{
+    xlarig::context.release();
+}
@@ -0,0 +1,74 @@
+/* XMRig and XLArig
+ * Copyright 2010      Jeff Garzik <jgarzik@pobox.com>
+ * Copyright 2012-2014 pooler      <pooler@litecoinpool.org>
+ * Copyright 2014      Lucas Jones <https://github.com/lucasjones>
+ * Copyright 2014-2016 Wolf9466    <https://github.com/OhGodAPet>
+ * Copyright 2016      Jay D Dee   <jayddee246@gmail.com>
+ * Copyright 2017-2018 XMR-Stak    <https://github.com/fireice-uk>, <https://github.com/psychocrypt>
+ * Copyright 2018-2019 SChernykh   <https://github.com/SChernykh>
+ * Copyright 2016-2019 XMRig       <https://github.com/xmrig>, <support@xmrig.com>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef XLARIG_HASH_H
+#define XLARIG_HASH_H
+
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+#define XLARIG_HASH_SIZE 32
+
+
+enum xlarig_hash_status {
+    XLARIG_HASH_OK               =  0,
+    XLARIG_HASH_INVALID_ALGO     = -1,
+    XLARIG_HASH_INVALID_ARGUMENT = -2,
+    XLARIG_HASH_NO_MEMORY        = -3
+};
+
+
+/**
+ * Hashes a batch of blobs and writes n * XLARIG_HASH_SIZE bytes to out, the caller compares the
+ * results with the submitted hashes and the share target.
+ *
+ * algo is a full algorithm name as used in pool configs ("cn/r", "cn-pico/trtl", "defyx"...), the
+ * variant is part of the name. height is only used by cn/r, seed_hash (32 bytes) only by defyx
+ * and may be NULL for everything else. CryptoNight blobs must be at least 43 bytes long.
+ *
+ * Safe to call from any number of threads, each thread keeps its own contexts and scratchpads
+ * and reuses them across calls. Consecutive blobs of equal size are hashed several at a time.
+ */
+int xlarig_hash_verify(const char *algo, uint64_t height, const uint8_t *seed_hash, const uint8_t *const blobs[], const size_t sizes[], size_t n, uint8_t *out);
+
+
+/**
+ * Frees contexts and scratchpads of the calling thread, they are also freed when the thread exits.
+ */
+void xlarig_hash_thread_release(void);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* XLARIG_HASH_H */
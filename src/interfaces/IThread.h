@@ -48,7 +48,11 @@ public:
         DoubleWay,
         TripleWay,
         QuadWay,
-        PentaWay
+        PentaWay,
+        HexaWay,
+        HeptaWay,
+        OctaWay,
+        MaxWay = OctaWay
     };
 
     virtual ~IThread() = default;
@@ -41,6 +41,7 @@
 #include "core/config/Config.h"
 #include "core/Controller.h"
 #include "net/Network.h"
+#include "net/proxy/Proxy.h"
 #include "net/strategies/DonateStrategy.h"
 #include "rapidjson/document.h"
 #include "workers/Workers.h"
@@ -55,6 +56,7 @@
 xlarig::Network::Network(Controller *controller) :
     m_controller(controller),
     m_donate(nullptr),
+    m_proxy(nullptr),
     m_timer(nullptr)
 {
     Workers::setListener(this);
@@ -71,6 +73,8 @@ xlarig::Network::Network(Controller *controller) :
         m_donate = new DonateStrategy(controller, this);
     }
 
+    startProxy(controller->config());
+
     m_timer = new Timer(this, kTickInterval, kTickInterval);
 }
 
@@ -78,6 +82,7 @@ xlarig::Network::Network(Controller *controller) :
 xlarig::Network::~Network()
 {
     delete m_timer;
+    delete m_proxy;
 
     if (m_donate) {
         delete m_donate;
@@ -115,6 +120,18 @@ void xlarig::Network::onActive(IStrategy *strategy, IClient *client)
 
 void xlarig::Network::onConfigChanged(Config *config, Config *previousConfig)
 {
+    if (config->isProxy() != previousConfig->isProxy() || config->proxyHost() != previousConfig->proxyHost() || config->proxyPort() != previousConfig->proxyPort()) {
+        delete m_proxy;
+        m_proxy = nullptr;
+
+        startProxy(config);
+
+        // the job is sent again to take the local nonce slot reservation into account
+        if (m_strategy->isActive()) {
+            m_strategy->resume();
+        }
+    }
+
     if (config->pools() == previousConfig->pools() || !config->pools().active()) {
         return;
     }
@@ -131,6 +148,10 @@ void xlarig::Network::onConfigChanged(Config *config, Config *previousConfig)
 
 void xlarig::Network::onJob(IStrategy *strategy, IClient *client, const Job &job)
 {
+    if (m_proxy && m_donate != strategy) {
+        m_proxy->setJob(job);
+    }
+
     if (m_donate && m_donate->isActive() && m_donate != strategy) {
         return;
     }
@@ -165,6 +186,23 @@ void xlarig::Network::onPause(IStrategy *strategy)
 }
 
 
+int64_t xlarig::Network::onProxySubmit(const JobResult &result)
+{
+    return m_strategy->submit(result);
+}
+
+
+void xlarig::Network::onProxyMinersChanged()
+{
+    // donate jobs keep the whole nonce space, the pool job is sent again when the donation ends
+    if (!m_proxy->isActive() || !m_strategy->isActive() || (m_donate && m_donate->isActive())) {
+        return;
+    }
+
+    dispatch(m_proxy->job(), false);
+}
+
+
 void xlarig::Network::onRequest(IApiRequest &request)
 {
 #   ifdef XMRIG_FEATURE_API
@@ -173,13 +211,21 @@ void xlarig::Network::onRequest(IApiRequest &request)
 
         getResults(request.reply(), request.doc());
         getConnection(request.reply(), request.doc());
+
+        if (m_proxy) {
+            request.reply().AddMember("proxy", m_proxy->toJSON(request.doc()), request.doc().GetAllocator());
+        }
     }
 #   endif
 }
 
 
-void xlarig::Network::onResultAccepted(IStrategy *, IClient *, const SubmitResult &result, const char *error)
+void xlarig::Network::onResultAccepted(IStrategy *, IClient *client, const SubmitResult &result, const char *error)
 {
+    if (m_proxy && m_proxy->onResultAccepted(client, result, error)) {
+        return;
+    }
+
     m_state.add(result, error);
 
     if (error) {
@@ -209,16 +255,53 @@ void xlarig::Network::setJob(IClient *client, const Job &job, bool donate)
     }
 
     m_state.diff = job.diff();
+
+    if (!donate) {
+        m_state.onJob();
+    }
+
+    dispatch(job, donate);
+}
+
+
+void xlarig::Network::dispatch(const Job &job, bool donate)
+{
+    if (!donate && m_proxy && m_proxy->isActive() && m_proxy->hasMiners()) {
+        Job local = job;
+        local.setFixedByte(Proxy::kLocalSlot);
+
+        return Workers::setJob(local, donate);
+    }
+
     Workers::setJob(job, donate);
 }
 
 
+void xlarig::Network::startProxy(const Config *config)
+{
+    if (!config->isProxy()) {
+        return;
+    }
+
+    m_proxy = new Proxy(config->proxyHost(), config->proxyPort(), this);
+
+    if (!m_proxy->start()) {
+        delete m_proxy;
+        m_proxy = nullptr;
+    }
+}
+
+
 void xlarig::Network::tick()
 {
     const uint64_t now = Chrono::steadyMSecs();
 
     m_strategy->tick(now);
 
+    if (m_proxy) {
+        m_proxy->tick(now);
+    }
+
     if (m_donate) {
         m_donate->tick(now);
     }
@@ -226,6 +309,27 @@ void xlarig::Network::tick()
 
 
 #ifdef XMRIG_FEATURE_API
+namespace xlarig {
+
+
+static rapidjson::Value quantiles(const Histogram &histogram, rapidjson::Document &doc)
+{
+    using namespace rapidjson;
+    auto &allocator = doc.GetAllocator();
+
+    Value obj(kObjectType);
+    obj.AddMember("p50", histogram.quantile(0.5),  allocator);
+    obj.AddMember("p90", histogram.quantile(0.9),  allocator);
+    obj.AddMember("p99", histogram.quantile(0.99), allocator);
+    obj.AddMember("max", histogram.max(),          allocator);
+
+    return obj;
+}
+
+
+} /* namespace xlarig */
+
+
 void xlarig::Network::getConnection(rapidjson::Value &reply, rapidjson::Document &doc) const
 {
     using namespace rapidjson;
@@ -239,6 +343,8 @@ void xlarig::Network::getConnection(rapidjson::Value &reply, rapidjson::Document
     connection.AddMember("ip",              m_state.ip().toJSON(), allocator);
     connection.AddMember("uptime",          m_state.connectionTime(), allocator);
     connection.AddMember("ping",            m_state.latency(), allocator);
+    connection.AddMember("latency",         quantiles(m_state.latencies(), doc), allocator);
+    connection.AddMember("job_interval",    quantiles(m_state.jobIntervals(), doc), allocator);
     connection.AddMember("failures",        m_state.failures, allocator);
     connection.AddMember("tls",             m_state.tls().toJSON(), allocator);
     connection.AddMember("tls-fingerprint", m_state.fingerprint().toJSON(), allocator);
@@ -260,6 +366,8 @@ void xlarig::Network::getResults(rapidjson::Value &reply, rapidjson::Document &d
     results.AddMember("shares_total",  m_state.accepted + m_state.rejected, allocator);
     results.AddMember("avg_time",      m_state.avgTime(), allocator);
     results.AddMember("hashes_total",  m_state.total, allocator);
+    results.AddMember("shares_stale",  Workers::stale(), allocator);
+    results.AddMember("hashes_cancelled", Workers::cancelled(), allocator);
 
     Value best(kArrayType);
     for (size_t i = 0; i < m_state.topDiff.size(); ++i) {
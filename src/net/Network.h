@@ -35,6 +35,7 @@
 #include "base/kernel/interfaces/IStrategyListener.h"
 #include "base/kernel/interfaces/ITimerListener.h"
 #include "interfaces/IJobResultListener.h"
+#include "interfaces/IProxyListener.h"
 #include "net/NetworkState.h"
 #include "rapidjson/fwd.h"
 
@@ -44,9 +45,10 @@ namespace xlarig {
 
 class Controller;
 class IStrategy;
+class Proxy;
 
 
-class Network : public IJobResultListener, public IStrategyListener, public IBaseListener, public ITimerListener, public IApiListener
+class Network : public IJobResultListener, public IStrategyListener, public IBaseListener, public ITimerListener, public IApiListener, public IProxyListener
 {
 public:
     Network(Controller *controller);
@@ -64,13 +66,17 @@ protected:
     void onJob(IStrategy *strategy, IClient *client, const Job &job) override;
     void onJobResult(const JobResult &result) override;
     void onPause(IStrategy *strategy) override;
+    int64_t onProxySubmit(const JobResult &result) override;
+    void onProxyMinersChanged() override;
     void onRequest(IApiRequest &request) override;
     void onResultAccepted(IStrategy *strategy, IClient *client, const SubmitResult &result, const char *error) override;
 
 private:
     constexpr static int kTickInterval = 1 * 1000;
 
+    void dispatch(const Job &job, bool donate);
     void setJob(IClient *client, const Job &job, bool donate);
+    void startProxy(const Config *config);
     void tick();
 
 #   ifdef XMRIG_FEATURE_API
@@ -82,6 +88,7 @@ private:
     IStrategy *m_donate;
     IStrategy *m_strategy;
     NetworkState m_state;
+    Proxy *m_proxy;
     Timer *m_timer;
 };
 
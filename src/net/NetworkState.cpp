@@ -43,32 +43,26 @@ xlarig::NetworkState::NetworkState() :
     failures(0),
     rejected(0),
     total(0),
-    m_active(false)
+    m_active(false),
+    m_connectionTime(0),
+    m_lastJob(0)
 {
 }
 
 
 uint32_t xlarig::NetworkState::avgTime() const
 {
-    if (m_latency.empty()) {
+    if (m_latency.count() == 0) {
         return 0;
     }
 
-    return connectionTime() / (uint32_t)m_latency.size();
+    return static_cast<uint32_t>(connectionTime() / m_latency.count());
 }
 
 
 uint32_t xlarig::NetworkState::latency() const
 {
-    const size_t calls = m_latency.size();
-    if (calls == 0) {
-        return 0;
-    }
-
-    auto v = m_latency;
-    std::nth_element(v.begin(), v.begin() + calls / 2, v.end());
-
-    return v[calls / 2];
+    return m_latency.quantile(0.5);
 }
 
 
@@ -94,7 +88,7 @@ void xlarig::NetworkState::add(const SubmitResult &result, const char *error)
         std::sort(topDiff.rbegin(), topDiff.rend());
     }
 
-    m_latency.push_back(result.elapsed > 0xFFFF ? 0xFFFF : static_cast<uint16_t>(result.elapsed));
+    m_latency.add(result.elapsed);
 }
 
 
@@ -107,6 +101,19 @@ void xlarig::NetworkState::onActive(IClient *client)
     m_fingerprint    = client->tlsFingerprint();
     m_active         = true;
     m_connectionTime = Chrono::steadyMSecs();
+    m_lastJob        = 0;
+}
+
+
+void xlarig::NetworkState::onJob()
+{
+    const uint64_t now = Chrono::steadyMSecs();
+
+    if (m_lastJob) {
+        m_jobIntervals.add(now - m_lastJob);
+    }
+
+    m_lastJob = now;
 }
 
 
@@ -119,5 +126,7 @@ void xlarig::NetworkState::stop()
     m_fingerprint = nullptr;
 
     failures++;
-    m_latency.clear();
+    m_lastJob = 0;
+    m_latency.reset();
+    m_jobIntervals.reset();
 }
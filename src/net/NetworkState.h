@@ -27,9 +27,9 @@
 
 
 #include <array>
-#include <vector>
 
 
+#include "base/tools/Histogram.h"
 #include "base/tools/String.h"
 
 
@@ -45,15 +45,18 @@ class NetworkState
 public:
     NetworkState();
 
-    inline const String &fingerprint() const { return m_fingerprint; }
-    inline const String &ip() const          { return m_ip; }
-    inline const String &tls() const         { return m_tls; }
+    inline const Histogram &jobIntervals() const { return m_jobIntervals; }
+    inline const Histogram &latencies() const    { return m_latency; }
+    inline const String &fingerprint() const     { return m_fingerprint; }
+    inline const String &ip() const              { return m_ip; }
+    inline const String &tls() const             { return m_tls; }
 
     uint32_t avgTime() const;
     uint32_t latency() const;
     uint64_t connectionTime() const;
     void add(const SubmitResult &result, const char *error);
     void onActive(IClient *client);
+    void onJob();
     void stop();
 
     char pool[256];
@@ -66,11 +69,13 @@ public:
 
 private:
     bool m_active;
-    std::vector<uint16_t> m_latency;
+    Histogram m_jobIntervals;
+    Histogram m_latency;
     String m_fingerprint;
     String m_ip;
     String m_tls;
     uint64_t m_connectionTime;
+    uint64_t m_lastJob;
 };
 
 
@@ -0,0 +1,400 @@
+/* XMRig and XLArig
+ * Copyright 2010      Jeff Garzik <jgarzik@pobox.com>
+ * Copyright 2012-2014 pooler      <pooler@litecoinpool.org>
+ * Copyright 2014      Lucas Jones <https://github.com/lucasjones>
+ * Copyright 2014-2016 Wolf9466    <https://github.com/OhGodAPet>
+ * Copyright 2016      Jay D Dee   <jayddee246@gmail.com>
+ * Copyright 2017-2018 XMR-Stak    <https://github.com/fireice-uk>, <https://github.com/psychocrypt>
+ * Copyright 2018-2019 SChernykh   <https://github.com/SChernykh>
+ * Copyright 2016-2019 XMRig       <https://github.com/xmrig>, <support@xmrig.com>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include <inttypes.h>
+#include <string.h>
+#include <uv.h>
+
+
+#include "base/io/json/Json.h"
+#include "base/io/log/Log.h"
+#include "base/kernel/interfaces/IClient.h"
+#include "base/net/stratum/SubmitResult.h"
+#include "base/net/tools/TcpServer.h"
+#include "base/tools/Baton.h"
+#include "base/tools/Buffer.h"
+#include "base/tools/Chrono.h"
+#include "base/tools/Handle.h"
+#include "interfaces/IProxyListener.h"
+#include "net/JobResult.h"
+#include "net/proxy/Proxy.h"
+#include "net/proxy/ProxyMiner.h"
+#include "net/proxy/ShareVerifier.h"
+#include "rapidjson/document.h"
+
+
+namespace xlarig {
+
+
+class ProxyShare : public Baton<uv_work_t>
+{
+public:
+    inline ProxyShare(Proxy *proxy, const Job &job, uint32_t nonce, const uint8_t *hash, int64_t reqId, uintptr_t miner) :
+        job(job),
+        proxy(proxy),
+        reqId(reqId),
+        nonce(nonce),
+        miner(miner)
+    {
+        memcpy(this->hash, hash, sizeof(this->hash));
+    }
+
+    bool valid = false;
+    const Job job;
+    Proxy *proxy;
+    int64_t reqId;
+    uint32_t nonce;
+    uint8_t hash[32];
+    uintptr_t miner;
+};
+
+
+} /* namespace xlarig */
+
+
+xlarig::Proxy::Proxy(const String &host, uint16_t port, IProxyListener *listener) :
+    m_listener(listener),
+    m_host(host),
+    m_server(nullptr),
+    m_port(port),
+    m_accepted(0),
+    m_invalid(0),
+    m_rejected(0)
+{
+    m_slots.set(kLocalSlot);
+}
+
+
+xlarig::Proxy::~Proxy()
+{
+    // shares still being hashed are dropped when the thread pool hands them back
+    for (ProxyShare *share : m_verifying) {
+        share->proxy = nullptr;
+    }
+
+    for (const auto &kv : m_miners) {
+        delete kv.second;
+    }
+
+    delete m_server;
+
+    ShareVerifier::release();
+}
+
+
+bool xlarig::Proxy::onResultAccepted(IClient *client, const SubmitResult &result, const char *error)
+{
+    const auto it = m_results.find({ client->id(), result.seq });
+    if (it == m_results.end()) {
+        return false;
+    }
+
+    if (error) {
+        m_rejected++;
+
+        LOG_INFO(CYAN_BOLD("proxy ") RED_BOLD("rejected") " diff " WHITE_BOLD("%" PRIu64) " " RED("\"%s\"") " " BLACK_BOLD("(%" PRIu64 " ms)"), result.diff, error, result.elapsed);
+    }
+    else {
+        m_accepted++;
+    }
+
+    reply(it->second, error);
+    m_results.erase(it);
+
+    return true;
+}
+
+
+bool xlarig::Proxy::start()
+{
+    m_server = new TcpServer(m_host, m_port, this);
+
+    const int rc = m_server->bind();
+    Log::print(GREEN_BOLD(" * ") WHITE_BOLD("%-13s") BLUE_BOLD("%s:%d") " " RED_BOLD("%s"),
+               "PROXY",
+               m_host.data(),
+               rc < 0 ? m_port : rc,
+               rc < 0 ? uv_strerror(rc) : ""
+               );
+
+    return rc >= 0;
+}
+
+
+rapidjson::Value xlarig::Proxy::toJSON(rapidjson::Document &doc) const
+{
+    using namespace rapidjson;
+    auto &allocator = doc.GetAllocator();
+
+    Value obj(kObjectType);
+    obj.AddMember("miners",   static_cast<uint64_t>(m_miners.size()), allocator);
+    obj.AddMember("accepted", m_accepted, allocator);
+    obj.AddMember("rejected", m_rejected, allocator);
+    obj.AddMember("invalid",  m_invalid, allocator);
+
+    return obj;
+}
+
+
+void xlarig::Proxy::setJob(const Job &job)
+{
+    if (job.isNicehash()) {
+        if (m_job.isValid() || m_job.id().isNull()) {
+            LOG_WARN(CYAN_BOLD("proxy ") "upstream job has a fixed nonce byte, downstream miners stay idle");
+        }
+
+        m_job = job;
+        m_job.reset();
+        m_prevJob.reset();
+        m_nonces.clear();
+        m_prevNonces.clear();
+        return;
+    }
+
+    if (m_job.isValid() && m_job == job) {
+        return;
+    }
+
+    // Shares for the previous job are still forwarded until the chain moves, after that they can only be rejected.
+    m_prevJob = m_job;
+    m_prevNonces.swap(m_nonces);
+    m_nonces.clear();
+
+    if (m_prevJob.height() != job.height() || m_prevJob.poolId() != job.poolId()) {
+        m_prevJob.reset();
+        m_prevNonces.clear();
+    }
+
+    m_job = job;
+
+    for (const auto &kv : m_miners) {
+        kv.second->setJob(m_job);
+    }
+}
+
+
+void xlarig::Proxy::tick(uint64_t now)
+{
+    for (auto it = m_results.begin(); it != m_results.end();) {
+        if (it->second.expire > now) {
+            ++it;
+            continue;
+        }
+
+        m_rejected++;
+        reply(it->second, "Pool timeout");
+        it = m_results.erase(it);
+    }
+}
+
+
+void xlarig::Proxy::onVerify(uv_work_t *req)
+{
+    auto share = static_cast<ProxyShare *>(req->data);
+
+    share->valid = ShareVerifier::verify(share->job, share->nonce, share->hash);
+}
+
+
+void xlarig::Proxy::onVerified(uv_work_t *req, int)
+{
+    auto share   = static_cast<ProxyShare *>(req->data);
+    Proxy *proxy = share->proxy;
+
+    if (proxy) {
+        proxy->m_verifying.erase(share);
+
+        const char *error = proxy->forward(*share);
+        if (error) {
+            proxy->m_invalid++;
+            proxy->reply({ share->reqId, 0, share->miner }, error);
+        }
+    }
+
+    delete share;
+}
+
+
+const char *xlarig::Proxy::forward(const ProxyShare &share)
+{
+    if (!share.valid) {
+        const auto it = m_miners.find(share.miner);
+        LOG_WARN(CYAN_BOLD("proxy ") "miner " WHITE_BOLD("%s") " submitted a share with a wrong hash", it != m_miners.end() ? it->second->ip().data() : "?");
+
+        return "Invalid share";
+    }
+
+    // the chain may have moved while the share was hashed
+    const Job *job = find(share.job.id());
+    if (!job) {
+        return "Invalid job id";
+    }
+
+    const JobResult result(job->poolId(), job->id(), job->clientId(), share.nonce, share.hash, job->diff(), job->algorithm());
+    const int64_t seq = m_listener->onProxySubmit(result);
+    if (seq < 0) {
+        return "Pool not connected";
+    }
+
+    m_results[{ job->poolId(), seq }] = { share.reqId, Chrono::steadyMSecs() + kResultTimeout, share.miner };
+
+    return nullptr;
+}
+
+
+void xlarig::Proxy::onConnection(uv_stream_t *stream, uint16_t)
+{
+    size_t slot = kLocalSlot + 1;
+    while (slot < m_slots.size() && m_slots.test(slot)) {
+        slot++;
+    }
+
+    if (slot == m_slots.size()) {
+        LOG_WARN(CYAN_BOLD("proxy ") "all %zu nonce slots are in use, connection refused", m_slots.size() - 1);
+
+        uv_tcp_t *socket = new uv_tcp_t;
+        uv_tcp_init(uv_default_loop(), socket);
+        uv_accept(stream, reinterpret_cast<uv_stream_t *>(socket));
+        Handle::close(socket);
+
+        return;
+    }
+
+    ProxyMiner *miner = new ProxyMiner(static_cast<uint8_t>(slot), this);
+    if (!miner->accept(stream)) {
+        delete miner;
+
+        return;
+    }
+
+    m_slots.set(slot);
+    m_miners[miner->id()] = miner;
+
+    LOG_INFO(CYAN_BOLD("proxy ") "miner " WHITE_BOLD("%s") " connected, slot " WHITE_BOLD("%zu") ", " WHITE_BOLD("%zu") " total", miner->ip().data(), slot, m_miners.size());
+
+    if (m_miners.size() == 1) {
+        m_listener->onProxyMinersChanged();
+    }
+}
+
+
+void xlarig::Proxy::onMinerClose(ProxyMiner *miner)
+{
+    m_slots.reset(miner->slot());
+    m_miners.erase(miner->id());
+
+    LOG_INFO(CYAN_BOLD("proxy ") "miner " WHITE_BOLD("%s") " disconnected, " WHITE_BOLD("%zu") " total", miner->ip().data(), m_miners.size());
+
+    delete miner;
+
+    if (m_miners.empty()) {
+        m_listener->onProxyMinersChanged();
+    }
+}
+
+
+void xlarig::Proxy::onMinerLogin(ProxyMiner *miner, int64_t id)
+{
+    if (!isActive()) {
+        return miner->reply(id, "No job available");
+    }
+
+    miner->login(id, m_job);
+}
+
+
+void xlarig::Proxy::onMinerSubmit(ProxyMiner *miner, int64_t id, const rapidjson::Value &params)
+{
+    const char *error = submit(miner, id, params);
+    if (error) {
+        m_invalid++;
+        miner->reply(id, error);
+    }
+}
+
+
+const char *xlarig::Proxy::submit(ProxyMiner *miner, int64_t id, const rapidjson::Value &params)
+{
+    const char *jobId  = Json::getString(params, "job_id");
+    const char *nonce  = Json::getString(params, "nonce");
+    const char *result = Json::getString(params, "result");
+
+    const Job *job = find(jobId);
+    if (!job) {
+        return "Invalid job id";
+    }
+
+    uint32_t value = 0;
+    uint8_t hash[32];
+
+    if (!nonce || strlen(nonce) != 8 || !Buffer::fromHex(nonce, 8, reinterpret_cast<uint8_t *>(&value)) ||
+        !result || strlen(result) != 64 || !Buffer::fromHex(result, 64, hash)) {
+        return "Invalid params";
+    }
+
+    if ((value >> 24) != miner->slot()) {
+        return "Invalid nonce";
+    }
+
+    const JobResult share(job->poolId(), job->id(), job->clientId(), value, hash, job->diff(), job->algorithm());
+    if (share.actualDiff() < job->diff()) {
+        return "Low difficulty share";
+    }
+
+    if (!(job == &m_job ? m_nonces : m_prevNonces).insert(value).second) {
+        return "Duplicate share";
+    }
+
+    ProxyShare *task = new ProxyShare(this, *job, value, hash, id, miner->id());
+    m_verifying.insert(task);
+
+    uv_queue_work(uv_default_loop(), &task->req, Proxy::onVerify, Proxy::onVerified);
+
+    return nullptr;
+}
+
+
+const xlarig::Job *xlarig::Proxy::find(const char *jobId) const
+{
+    if (jobId && m_job.isValid() && m_job.id() == jobId) {
+        return &m_job;
+    }
+
+    if (jobId && m_prevJob.isValid() && m_prevJob.id() == jobId) {
+        return &m_prevJob;
+    }
+
+    return nullptr;
+}
+
+
+void xlarig::Proxy::reply(const Pending &pending, const char *error)
+{
+    const auto it = m_miners.find(pending.miner);
+    if (it != m_miners.end()) {
+        it->second->reply(pending.reqId, error);
+    }
+}
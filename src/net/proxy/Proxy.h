@@ -0,0 +1,124 @@
+/* XMRig and XLArig
+ * Copyright 2010      Jeff Garzik <jgarzik@pobox.com>
+ * Copyright 2012-2014 pooler      <pooler@litecoinpool.org>
+ * Copyright 2014      Lucas Jones <https://github.com/lucasjones>
+ * Copyright 2014-2016 Wolf9466    <https://github.com/OhGodAPet>
+ * Copyright 2016      Jay D Dee   <jayddee246@gmail.com>
+ * Copyright 2017-2018 XMR-Stak    <https://github.com/fireice-uk>, <https://github.com/psychocrypt>
+ * Copyright 2018-2019 SChernykh   <https://github.com/SChernykh>
+ * Copyright 2016-2019 XMRig       <https://github.com/xmrig>, <support@xmrig.com>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef XMRIG_PROXY_H
+#define XMRIG_PROXY_H
+
+
+#include <bitset>
+#include <map>
+#include <set>
+#include <utility>
+#include <uv.h>
+
+
+#include "base/kernel/interfaces/ITcpServerListener.h"
+#include "base/net/stratum/Job.h"
+#include "base/tools/String.h"
+#include "interfaces/IProxyMinerListener.h"
+#include "rapidjson/fwd.h"
+
+
+namespace xlarig {
+
+
+class IClient;
+class IProxyListener;
+class ProxyMiner;
+class ProxyShare;
+class SubmitResult;
+class TcpServer;
+
+
+/**
+ * Embedded stratum proxy: downstream miners share the upstream connection of this instance.
+ * The upstream nonce space is split with the nicehash fixed byte, slot 0 is kept for the local
+ * workers while at least one miner is connected and every downstream miner gets one of the
+ * remaining 255 values. Shares are hashed again on the thread pool and checked for duplicates
+ * before they are forwarded, and each one is answered once the pool replies.
+ */
+class Proxy : public ITcpServerListener, public IProxyMinerListener
+{
+public:
+    constexpr static uint8_t kLocalSlot       = 0;
+    constexpr static uint64_t kResultTimeout  = 30 * 1000;
+
+    Proxy(const String &host, uint16_t port, IProxyListener *listener);
+    ~Proxy() override;
+
+    inline bool hasMiners() const    { return !m_miners.empty(); }
+    inline bool isActive() const     { return m_job.isValid(); }
+    inline const Job &job() const    { return m_job; }
+
+    bool onResultAccepted(IClient *client, const SubmitResult &result, const char *error);
+    bool start();
+    rapidjson::Value toJSON(rapidjson::Document &doc) const;
+    void setJob(const Job &job);
+    void tick(uint64_t now);
+
+protected:
+    void onConnection(uv_stream_t *stream, uint16_t port) override;
+    void onMinerClose(ProxyMiner *miner) override;
+    void onMinerLogin(ProxyMiner *miner, int64_t id) override;
+    void onMinerSubmit(ProxyMiner *miner, int64_t id, const rapidjson::Value &params) override;
+
+private:
+    struct Pending
+    {
+        int64_t reqId;
+        uint64_t expire;
+        uintptr_t miner;
+    };
+
+    static void onVerify(uv_work_t *req);
+    static void onVerified(uv_work_t *req, int status);
+
+    const char *forward(const ProxyShare &share);
+    const char *submit(ProxyMiner *miner, int64_t id, const rapidjson::Value &params);
+    const Job *find(const char *jobId) const;
+    void reply(const Pending &pending, const char *error);
+
+    IProxyListener *m_listener;
+    Job m_job;
+    Job m_prevJob;
+    std::bitset<256> m_slots;
+    std::map<std::pair<int, int64_t>, Pending> m_results;
+    std::map<uintptr_t, ProxyMiner *> m_miners;
+    std::set<ProxyShare *> m_verifying;
+    std::set<uint32_t> m_nonces;
+    std::set<uint32_t> m_prevNonces;
+    String m_host;
+    TcpServer *m_server;
+    uint16_t m_port;
+    uint64_t m_accepted;
+    uint64_t m_invalid;
+    uint64_t m_rejected;
+};
+
+
+} /* namespace xlarig */
+
+
+#endif /* XMRIG_PROXY_H */
@@ -0,0 +1,377 @@
+/* XMRig and XLArig
+ * Copyright 2010      Jeff Garzik <jgarzik@pobox.com>
+ * Copyright 2012-2014 pooler      <pooler@litecoinpool.org>
+ * Copyright 2014      Lucas Jones <https://github.com/lucasjones>
+ * Copyright 2014-2016 Wolf9466    <https://github.com/OhGodAPet>
+ * Copyright 2016      Jay D Dee   <jayddee246@gmail.com>
+ * Copyright 2017-2018 XMR-Stak    <https://github.com/fireice-uk>, <https://github.com/psychocrypt>
+ * Copyright 2018-2019 SChernykh   <https://github.com/SChernykh>
+ * Copyright 2016-2019 XMRig       <https://github.com/xmrig>, <support@xmrig.com>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include <algorithm>
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+
+
+#include "base/io/json/Json.h"
+#include "base/io/log/Log.h"
+#include "base/net/stratum/Job.h"
+#include "base/tools/Baton.h"
+#include "base/tools/Buffer.h"
+#include "base/tools/Handle.h"
+#include "interfaces/IProxyMinerListener.h"
+#include "net/proxy/ProxyMiner.h"
+#include "rapidjson/document.h"
+#include "rapidjson/stringbuffer.h"
+#include "rapidjson/writer.h"
+
+
+namespace xlarig {
+
+
+Storage<ProxyMiner> ProxyMiner::m_storage;
+
+
+class MinerWriteBaton : public Baton<uv_write_t>
+{
+public:
+    inline MinerWriteBaton(const char *data, size_t size) :
+        m_data(data, size)
+    {
+        m_data.append(1, '\n');
+
+        buf.base = const_cast<char *>(m_data.c_str());
+        buf.len  = m_data.size();
+    }
+
+    inline static void onWrite(uv_write_t *req, int) { delete reinterpret_cast<MinerWriteBaton *>(req->data); }
+
+    uv_buf_t buf;
+
+private:
+    std::string m_data;
+};
+
+
+} /* namespace xlarig */
+
+
+xlarig::ProxyMiner::ProxyMiner(uint8_t slot, IProxyMinerListener *listener) :
+    m_ready(false),
+    m_listener(listener),
+    m_slot(slot)
+{
+    m_key    = m_storage.add(this);
+    m_socket = new uv_tcp_t;
+    m_socket->data = m_storage.ptr(m_key);
+
+    uv_tcp_init(uv_default_loop(), m_socket);
+    uv_tcp_nodelay(m_socket, 1);
+
+    char id[24];
+    snprintf(id, sizeof(id), "%" PRIuPTR, m_key);
+    m_rpcId = static_cast<const char *>(id);
+}
+
+
+xlarig::ProxyMiner::~ProxyMiner()
+{
+    m_storage.release(m_key);
+
+    Handle::close(m_socket);
+}
+
+
+bool xlarig::ProxyMiner::accept(uv_stream_t *server)
+{
+    if (uv_accept(server, reinterpret_cast<uv_stream_t *>(m_socket)) != 0) {
+        return false;
+    }
+
+    char ip[46]           = {};
+    sockaddr_storage addr = {};
+    int size              = sizeof(addr);
+
+    uv_tcp_getpeername(m_socket, reinterpret_cast<sockaddr*>(&addr), &size);
+    if (reinterpret_cast<sockaddr_in *>(&addr)->sin_family == AF_INET6) {
+        uv_ip6_name(reinterpret_cast<sockaddr_in6*>(&addr), ip, 45);
+    }
+    else {
+        uv_ip4_name(reinterpret_cast<sockaddr_in*>(&addr), ip, 16);
+    }
+
+    m_ip = static_cast<const char *>(ip);
+
+    return uv_read_start(reinterpret_cast<uv_stream_t *>(m_socket), onAllocBuffer, onRead) == 0;
+}
+
+
+void xlarig::ProxyMiner::close()
+{
+    if (uv_is_closing(reinterpret_cast<uv_handle_t *>(m_socket)) == 0) {
+        uv_close(reinterpret_cast<uv_handle_t *>(m_socket), ProxyMiner::onClose);
+    }
+}
+
+
+void xlarig::ProxyMiner::login(int64_t id, const Job &job)
+{
+    using namespace rapidjson;
+    Document doc(kObjectType);
+    auto &allocator = doc.GetAllocator();
+
+    Value extensions(kArrayType);
+    extensions.PushBack("algo",      allocator);
+    extensions.PushBack("nicehash",  allocator);
+    extensions.PushBack("keepalive", allocator);
+
+    Value result(kObjectType);
+    result.AddMember("id",         m_rpcId.toJSON(), allocator);
+    result.AddMember("job",        toJSON(job, doc), allocator);
+    result.AddMember("extensions", extensions, allocator);
+    result.AddMember("status",     "OK", allocator);
+
+    doc.AddMember("id",      id, allocator);
+    doc.AddMember("jsonrpc", "2.0", allocator);
+    doc.AddMember("error",   kNullType, allocator);
+    doc.AddMember("result",  result, allocator);
+
+    m_ready = true;
+
+    send(doc);
+}
+
+
+void xlarig::ProxyMiner::reply(int64_t id, const char *error)
+{
+    using namespace rapidjson;
+    Document doc(kObjectType);
+    auto &allocator = doc.GetAllocator();
+
+    doc.AddMember("id",      id, allocator);
+    doc.AddMember("jsonrpc", "2.0", allocator);
+
+    if (error) {
+        Value value(kObjectType);
+        value.AddMember("code",    -1, allocator);
+        value.AddMember("message", StringRef(error), allocator);
+
+        doc.AddMember("error",  value, allocator);
+        doc.AddMember("result", kNullType, allocator);
+    }
+    else {
+        Value result(kObjectType);
+        result.AddMember("status", "OK", allocator);
+
+        doc.AddMember("error",  kNullType, allocator);
+        doc.AddMember("result", result, allocator);
+    }
+
+    send(doc);
+}
+
+
+void xlarig::ProxyMiner::setJob(const Job &job)
+{
+    if (!m_ready) {
+        return;
+    }
+
+    using namespace rapidjson;
+    Document doc(kObjectType);
+    auto &allocator = doc.GetAllocator();
+
+    doc.AddMember("jsonrpc", "2.0", allocator);
+    doc.AddMember("method",  "job", allocator);
+    doc.AddMember("params",  toJSON(job, doc), allocator);
+
+    send(doc);
+}
+
+
+void xlarig::ProxyMiner::onLine(char *line, size_t size)
+{
+    LOG_DEBUG("[proxy %s] received (%d bytes): \"%.*s\"", m_ip.data(), static_cast<int>(size), static_cast<int>(size), line);
+
+    if (size < 32 || line[0] != '{') {
+        return close();
+    }
+
+    rapidjson::Document doc;
+    if (doc.ParseInsitu(line).HasParseError() || !doc.IsObject()) {
+        return close();
+    }
+
+    const int64_t id     = Json::getInt64(doc, "id", -1);
+    const char *method   = Json::getString(doc, "method", "");
+    const auto &params   = Json::getObject(doc, "params");
+
+    if (strcmp(method, "login") == 0) {
+        return m_listener->onMinerLogin(this, id);
+    }
+
+    if (!m_ready) {
+        return reply(id, "Unauthenticated");
+    }
+
+    if (strcmp(method, "submit") == 0) {
+        return m_listener->onMinerSubmit(this, id, params);
+    }
+
+    if (strcmp(method, "keepalived") == 0) {
+        using namespace rapidjson;
+        Document response(kObjectType);
+        auto &allocator = response.GetAllocator();
+
+        Value result(kObjectType);
+        result.AddMember("status", "KEEPALIVED", allocator);
+
+        response.AddMember("id",      id, allocator);
+        response.AddMember("jsonrpc", "2.0", allocator);
+        response.AddMember("error",   kNullType, allocator);
+        response.AddMember("result",  result, allocator);
+
+        return send(response);
+    }
+
+    reply(id, "Unsupported method");
+}
+
+
+rapidjson::Value xlarig::ProxyMiner::toJSON(const Job &job, rapidjson::Document &doc) const
+{
+    using namespace rapidjson;
+    auto &allocator = doc.GetAllocator();
+
+    uint8_t blob[Job::kMaxBlobSize];
+    memcpy(blob, job.blob(), job.size());
+    blob[42] = m_slot;
+
+    const uint64_t target = job.target();
+
+    Value params(kObjectType);
+    params.AddMember("blob",   Buffer::toHex(blob, job.size()).toJSON(doc), allocator);
+    params.AddMember("job_id", job.id().toJSON(), allocator);
+    params.AddMember("target", Buffer::toHex(reinterpret_cast<const uint8_t *>(&target), sizeof(target)).toJSON(doc), allocator);
+    params.AddMember("algo",   StringRef(job.algorithm().shortName()), allocator);
+    params.AddMember("id",     m_rpcId.toJSON(), allocator);
+
+    if (job.height()) {
+        params.AddMember("height", job.height(), allocator);
+    }
+
+    const uint8_t *seedHash = job.seedHash();
+    if (std::any_of(seedHash, seedHash + 32, [](uint8_t value) { return value != 0; })) {
+        params.AddMember("seed_hash", Buffer::toHex(seedHash, 32).toJSON(doc), allocator);
+    }
+
+    return params;
+}
+
+
+void xlarig::ProxyMiner::onClose()
+{
+    delete m_socket;
+    m_socket = nullptr;
+
+    m_listener->onMinerClose(this);
+}
+
+
+void xlarig::ProxyMiner::read(ssize_t nread)
+{
+    if (nread < 0) {
+        return close();
+    }
+
+    m_recvBuf.nread(static_cast<size_t>(nread));
+    m_recvBuf.getline(this);
+
+    if (m_recvBuf.available() == 0) {
+        LOG_DEBUG_ERR("[proxy %s] line too long", m_ip.data());
+
+        close();
+    }
+}
+
+
+void xlarig::ProxyMiner::send(const rapidjson::Document &doc)
+{
+    if (uv_is_closing(reinterpret_cast<uv_handle_t *>(m_socket))) {
+        return;
+    }
+
+    using namespace rapidjson;
+
+    StringBuffer buffer(nullptr, 512);
+    Writer<StringBuffer> writer(buffer);
+    doc.Accept(writer);
+
+    LOG_DEBUG("[proxy %s] send (%zu bytes): \"%s\"", m_ip.data(), buffer.GetSize(), buffer.GetString());
+
+    auto baton = new MinerWriteBaton(buffer.GetString(), buffer.GetSize());
+    if (uv_write(&baton->req, reinterpret_cast<uv_stream_t *>(m_socket), &baton->buf, 1, MinerWriteBaton::onWrite) < 0) {
+        delete baton;
+        close();
+    }
+}
+
+
+void xlarig::ProxyMiner::onAllocBuffer(uv_handle_t *handle, size_t, uv_buf_t *buf)
+{
+    auto miner = m_storage.get(handle->data);
+    if (!miner) {
+        buf->base = nullptr;
+        buf->len  = 0;
+
+        return;
+    }
+
+    buf->base = miner->m_recvBuf.current();
+
+#   ifdef _WIN32
+    buf->len = static_cast<ULONG>(miner->m_recvBuf.available());
+#   else
+    buf->len = miner->m_recvBuf.available();
+#   endif
+}
+
+
+void xlarig::ProxyMiner::onClose(uv_handle_t *handle)
+{
+    auto miner = m_storage.get(handle->data);
+    if (!miner) {
+        delete reinterpret_cast<uv_tcp_t *>(handle);
+
+        return;
+    }
+
+    miner->onClose();
+}
+
+
+void xlarig::ProxyMiner::onRead(uv_stream_t *stream, ssize_t nread, const uv_buf_t *)
+{
+    auto miner = m_storage.get(stream->data);
+    if (miner && nread != 0) {
+        miner->read(nread);
+    }
+}
@@ -0,0 +1,97 @@
+/* XMRig and XLArig
+ * Copyright 2010      Jeff Garzik <jgarzik@pobox.com>
+ * Copyright 2012-2014 pooler      <pooler@litecoinpool.org>
+ * Copyright 2014      Lucas Jones <https://github.com/lucasjones>
+ * Copyright 2014-2016 Wolf9466    <https://github.com/OhGodAPet>
+ * Copyright 2016      Jay D Dee   <jayddee246@gmail.com>
+ * Copyright 2017-2018 XMR-Stak    <https://github.com/fireice-uk>, <https://github.com/psychocrypt>
+ * Copyright 2018-2019 SChernykh   <https://github.com/SChernykh>
+ * Copyright 2016-2019 XMRig       <https://github.com/xmrig>, <support@xmrig.com>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef XMRIG_PROXYMINER_H
+#define XMRIG_PROXYMINER_H
+
+
+#include <uv.h>
+
+
+#include "base/kernel/interfaces/ILineListener.h"
+#include "base/net/tools/RecvBuf.h"
+#include "base/net/tools/Storage.h"
+#include "base/tools/String.h"
+#include "rapidjson/fwd.h"
+
+
+namespace xlarig {
+
+
+class IProxyMinerListener;
+class Job;
+
+
+/**
+ * Downstream stratum connection of the embedded proxy, every miner owns one value of the fixed
+ * nonce byte (nicehash convention) so miners sharing the upstream job never hash the same nonces.
+ */
+class ProxyMiner : public ILineListener
+{
+public:
+    ProxyMiner(uint8_t slot, IProxyMinerListener *listener);
+    ~ProxyMiner() override;
+
+    inline bool isReady() const      { return m_ready; }
+    inline const String &ip() const  { return m_ip; }
+    inline uintptr_t id() const      { return m_key; }
+    inline uint8_t slot() const      { return m_slot; }
+
+    bool accept(uv_stream_t *server);
+    void close();
+    void login(int64_t id, const Job &job);
+    void reply(int64_t id, const char *error = nullptr);
+    void setJob(const Job &job);
+
+protected:
+    void onLine(char *line, size_t size) override;
+
+private:
+    rapidjson::Value toJSON(const Job &job, rapidjson::Document &doc) const;
+    void onClose();
+    void read(ssize_t nread);
+    void send(const rapidjson::Document &doc);
+
+    static void onAllocBuffer(uv_handle_t *handle, size_t suggested_size, uv_buf_t *buf);
+    static void onClose(uv_handle_t *handle);
+    static void onRead(uv_stream_t *stream, ssize_t nread, const uv_buf_t *buf);
+
+    bool m_ready;
+    IProxyMinerListener *m_listener;
+    RecvBuf<4096> m_recvBuf;
+    String m_ip;
+    String m_rpcId;
+    uint8_t m_slot;
+    uintptr_t m_key;
+    uv_tcp_t *m_socket;
+
+    static Storage<ProxyMiner> m_storage;
+};
+
+
+} /* namespace xlarig */
+
+
+#endif /* XMRIG_PROXYMINER_H */
@@ -0,0 +1,251 @@
+/* XMRig and XLArig
+ * Copyright 2010      Jeff Garzik <jgarzik@pobox.com>
+ * Copyright 2012-2014 pooler      <pooler@litecoinpool.org>
+ * Copyright 2014      Lucas Jones <https://github.com/lucasjones>
+ * Copyright 2014-2016 Wolf9466    <https://github.com/OhGodAPet>
+ * Copyright 2016      Jay D Dee   <jayddee246@gmail.com>
+ * Copyright 2017-2018 XMR-Stak    <https://github.com/fireice-uk>, <https://github.com/psychocrypt>
+ * Copyright 2018-2019 SChernykh   <https://github.com/SChernykh>
+ * Copyright 2016-2019 XMRig       <https://github.com/xmrig>, <support@xmrig.com>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <string.h>
+#include <uv.h>
+
+
+#include "base/net/stratum/Job.h"
+#include "common/cpu/Cpu.h"
+#include "crypto/cn/CnHash.h"
+#include "crypto/cn/CryptoNight.h"
+#include "Mem.h"
+#include "net/proxy/ShareVerifier.h"
+
+
+#ifdef XMRIG_ALGO_RANDOMX
+#   include <defyx.h>
+#endif
+
+
+namespace xlarig {
+
+
+class VerifyContext
+{
+public:
+    inline ~VerifyContext() { release(); }
+
+    cryptonight_ctx **reserve(const Algorithm &algorithm);
+    void release();
+
+#   ifdef XMRIG_ALGO_RANDOMX
+    defyx_vm *vm(defyx_cache *cache, uint64_t generation);
+#   endif
+
+private:
+    Algo m_algo = INVALID_ALGO;
+    cryptonight_ctx *m_ctx[1] = {};
+    MemInfo m_memory;
+
+#   ifdef XMRIG_ALGO_RANDOMX
+    defyx_vm *m_vm          = nullptr;
+    uint64_t m_generation   = 0;
+#   endif
+};
+
+
+static thread_local VerifyContext context;
+
+
+#ifdef XMRIG_ALGO_RANDOMX
+static defyx_cache *defyxCache  = nullptr;
+static uint64_t defyxGeneration = 0;
+static uint8_t defyxSeed[32];
+static uv_once_t defyxOnce      = UV_ONCE_INIT;
+static uv_rwlock_t defyxLock;
+
+
+static void initDefyx()
+{
+    uv_rwlock_init(&defyxLock);
+}
+#endif
+
+
+cryptonight_ctx **VerifyContext::reserve(const Algorithm &algorithm)
+{
+    if (m_algo != algorithm.algo()) {
+        if (m_algo != INVALID_ALGO) {
+            Mem::release(m_ctx, 1, m_memory);
+        }
+
+        m_memory = Mem::create(m_ctx, algorithm.algo(), 1);
+        m_algo   = algorithm.algo();
+    }
+
+    return Mem::carve(m_ctx, m_memory, Mem::scratchpad(algorithm), 1) ? m_ctx : nullptr;
+}
+
+
+void VerifyContext::release()
+{
+    if (m_algo != INVALID_ALGO) {
+        Mem::release(m_ctx, 1, m_memory);
+        m_memory = MemInfo();
+        m_algo   = INVALID_ALGO;
+    }
+
+#   ifdef XMRIG_ALGO_RANDOMX
+    if (m_vm) {
+        defyx_destroy_vm(m_vm);
+        m_vm = nullptr;
+    }
+#   endif
+}
+
+
+#ifdef XMRIG_ALGO_RANDOMX
+/**
+ * Must be called with the lock held, the VM is rebuilt whenever the shared cache was replaced.
+ */
+defyx_vm *VerifyContext::vm(defyx_cache *cache, uint64_t generation)
+{
+    if (m_vm && m_generation == generation) {
+        return m_vm;
+    }
+
+    if (m_vm) {
+        defyx_destroy_vm(m_vm);
+    }
+
+    int flags = RANDOMX_FLAG_JIT;
+    if (Cpu::info()->hasAES()) {
+        flags |= RANDOMX_FLAG_HARD_AES;
+    }
+
+    m_vm = defyx_create_vm(static_cast<defyx_flags>(flags), cache, nullptr);
+    if (!m_vm) {
+        // no executable memory for the JIT, the interpreter is slower but gives the same hash
+        m_vm = defyx_create_vm(static_cast<defyx_flags>(flags & ~RANDOMX_FLAG_JIT), cache, nullptr);
+    }
+
+    m_generation = generation;
+
+    return m_vm;
+}
+
+
+static bool hashDefyx(const uint8_t *seed, const uint8_t *blob, size_t size, uint8_t *out)
+{
+    uv_once(&defyxOnce, initDefyx);
+    uv_rwlock_rdlock(&defyxLock);
+
+    if (defyxCache && memcmp(defyxSeed, seed, sizeof(defyxSeed)) == 0) {
+        defyx_vm *vm = context.vm(defyxCache, defyxGeneration);
+        if (vm) {
+            defyx_calculate_hash(vm, blob, size, out);
+        }
+
+        uv_rwlock_rdunlock(&defyxLock);
+
+        return vm != nullptr;
+    }
+
+    uv_rwlock_rdunlock(&defyxLock);
+
+    // the seed changed, the share is hashed under the write lock so a concurrent share for another seed can't switch it back in between
+    uv_rwlock_wrlock(&defyxLock);
+
+    if (!defyxCache) {
+        defyxCache = defyx_alloc_cache(static_cast<defyx_flags>(RANDOMX_FLAG_JIT | RANDOMX_FLAG_LARGE_PAGES));
+        if (!defyxCache) {
+            defyxCache = defyx_alloc_cache(RANDOMX_FLAG_JIT);
+        }
+
+        if (!defyxCache) {
+            defyxCache = defyx_alloc_cache(RANDOMX_FLAG_DEFAULT);
+        }
+    }
+
+    defyx_vm *vm = nullptr;
+    if (defyxCache) {
+        if (memcmp(defyxSeed, seed, sizeof(defyxSeed)) != 0) {
+            memcpy(defyxSeed, seed, sizeof(defyxSeed));
+            defyx_init_cache(defyxCache, defyxSeed, sizeof(defyxSeed));
+            defyxGeneration++;
+        }
+
+        vm = context.vm(defyxCache, defyxGeneration);
+        if (vm) {
+            defyx_calculate_hash(vm, blob, size, out);
+        }
+    }
+
+    uv_rwlock_wrunlock(&defyxLock);
+
+    return vm != nullptr;
+}
+#endif
+
+
+} /* namespace xlarig */
+
+
+bool xlarig::ShareVerifier::verify(const Job &job, uint32_t nonce, const uint8_t *hash)
+{
+    uint8_t blob[Job::kMaxBlobSize];
+    uint8_t result[32];
+
+    memcpy(blob, job.blob(), job.size());
+    *Job::nonce(blob) = nonce;
+
+    const Algorithm &algorithm = job.algorithm();
+
+#   ifdef XMRIG_ALGO_RANDOMX
+    if (algorithm.algo() == RANDOM_X) {
+        return hashDefyx(job.seedHash(), blob, job.size(), result) && memcmp(result, hash, sizeof(result)) == 0;
+    }
+#   endif
+
+    const CnHash::cn_hash_fun fn = CnHash::fn(algorithm.algo(), Cpu::info()->hasAES() ? AV_SINGLE : AV_SINGLE_SOFT, algorithm.variant(), ASM_AUTO);
+    cryptonight_ctx **ctx        = fn ? context.reserve(algorithm) : nullptr;
+
+    if (!ctx) {
+        return false;
+    }
+
+    fn(blob, job.size(), result, ctx, job.height());
+
+    return memcmp(result, hash, sizeof(result)) == 0;
+}
+
+
+void xlarig::ShareVerifier::release()
+{
+#   ifdef XMRIG_ALGO_RANDOMX
+    uv_once(&defyxOnce, initDefyx);
+    uv_rwlock_wrlock(&defyxLock);
+
+    if (defyxCache) {
+        defyx_release_cache(defyxCache);
+        defyxCache = nullptr;
+        memset(defyxSeed, 0, sizeof(defyxSeed));
+        defyxGeneration++;
+    }
+
+    uv_rwlock_wrunlock(&defyxLock);
+#   endif
+}
@@ -0,0 +1,349 @@
+/* XMRig and XLArig
+ * Copyright 2010      Jeff Garzik <jgarzik@pobox.com>
+ * Copyright 2012-2014 pooler      <pooler@litecoinpool.org>
+ * Copyright 2014      Lucas Jones <https://github.com/lucasjones>
+ * Copyright 2014-2016 Wolf9466    <https://github.com/OhGodAPet>
+ * Copyright 2016      Jay D Dee   <jayddee246@gmail.com>
+ * Copyright 2017-2018 XMR-Stak    <https://github.com/fireice-uk>, <https://github.com/psychocrypt>
+ * Copyright 2018-2019 SChernykh   <https://github.com/SChernykh>
+ * Copyright 2016-2019 XMRig       <https://github.com/xmrig>, <support@xmrig.com>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <atomic>
+#include <stdio.h>
+#include <string.h>
+#include <uv.h>
+#include <vector>
+
+
+#include "base/io/json/Json.h"
+#include "base/io/log/Log.h"
+#include "base/tools/Baton.h"
+#include "common/cpu/Cpu.h"
+#include "core/config/Config.h"
+#include "core/Controller.h"
+#include "crypto/cn/Asm.h"
+#include "crypto/cn/CryptoNight.h"
+#include "crypto/cn/CryptoNight_test.h"
+#include "Mem.h"
+#include "rapidjson/document.h"
+#include "workers/AsmBench.h"
+#include "workers/CpuThread.h"
+
+
+namespace xlarig {
+
+
+static const char *kCacheFile   = "asm.json";
+static const char *kWays[]      = { "single", "double" };
+static const size_t kHashes     = 256;
+static const size_t kRounds     = 4;
+static const uint64_t kMaxTime  = 500 * 1000 * 1000;
+static const Assembly kCandidates[] = { ASM_NONE, ASM_INTEL, ASM_RYZEN, ASM_BULLDOZER };
+
+
+struct AsmChoice
+{
+    AsmChoice()
+    {
+        for (size_t i = 0; i < ALGO_MAX; ++i) {
+            for (size_t j = 0; j < VARIANT_MAX; ++j) {
+                map[i][j][0] = ASM_AUTO;
+                map[i][j][1] = ASM_AUTO;
+            }
+        }
+    }
+
+    // written by the benchmark while worker threads may already run their self-test
+    std::atomic<int> map[ALGO_MAX][VARIANT_MAX][2];
+};
+
+
+struct AsmSample
+{
+    inline AsmSample(Assembly assembly, CpuThread::cn_hash_fun fn) : assembly(assembly), fn(fn), hashes(0), time(0) {}
+
+    inline double hashrate() const { return time ? hashes * 1e9 / time : 0.0; }
+
+    Assembly assembly;
+    CpuThread::cn_hash_fun fn;
+    uint64_t hashes;
+    uint64_t time;
+};
+
+
+class AsmBenchTask : public Baton<uv_work_t>
+{
+public:
+    inline AsmBenchTask(Algo algorithm, Variant variant, const String &fileName, const char *algo, void (*callback)()) :
+        algorithm(algorithm),
+        variant(variant),
+        algo(algo),
+        callback(callback),
+        fileName(fileName)
+    {}
+
+    Algo algorithm;
+    Variant variant;
+    const char *algo;
+    std::vector<AsmSample> samples[2];
+    void (*callback)();
+    String fileName;
+};
+
+
+static AsmChoice choice;
+
+
+static inline int wayIndex(AlgoVariant av)
+{
+    return av == AV_SINGLE ? 0 : (av == AV_DOUBLE ? 1 : -1);
+}
+
+
+static std::vector<AsmSample> candidates(Algo algorithm, AlgoVariant av, Variant variant)
+{
+    std::vector<AsmSample> samples;
+
+    for (Assembly assembly : kCandidates) {
+        CpuThread::cn_hash_fun fn = CpuThread::fn(algorithm, av, variant, assembly);
+        if (fn == nullptr) {
+            continue;
+        }
+
+        bool duplicate = false;
+        for (const AsmSample &sample : samples) {
+            duplicate |= sample.fn == fn;
+        }
+
+        if (!duplicate) {
+            samples.emplace_back(assembly, fn);
+        }
+    }
+
+    return samples;
+}
+
+
+// candidates take turns in short bursts, so clock ramps and noisy neighbours hit all of them alike
+static void measure(std::vector<AsmSample> &samples, cryptonight_ctx **ctx, size_t ways)
+{
+    uint8_t blob[76 * 2];
+    uint8_t hash[32 * 2];
+
+    for (size_t i = 0; i < ways; ++i) {
+        memcpy(blob + i * 76, test_input, 76);
+    }
+
+    uint32_t *nonce = reinterpret_cast<uint32_t *>(blob + 39);
+
+    for (AsmSample &sample : samples) {
+        sample.fn(blob, 76, hash, ctx, 0);
+    }
+
+    for (size_t round = 0; round < kRounds; ++round) {
+        for (AsmSample &sample : samples) {
+            const uint64_t start = uv_hrtime();
+            uint64_t elapsed     = 0;
+            size_t count         = 0;
+
+            do {
+                sample.fn(blob, 76, hash, ctx, 0);
+                (*nonce)++;
+                count++;
+                elapsed = uv_hrtime() - start;
+            }
+            while (count < kHashes / kRounds && elapsed < kMaxTime / kRounds);
+
+            sample.hashes += count * ways;
+            sample.time   += elapsed;
+        }
+    }
+}
+
+
+static const char *describe(const std::vector<AsmSample> &samples, const AsmSample &best, char *buf, size_t size)
+{
+    size_t pos = 0;
+    buf[0]     = '\0';
+
+    for (const AsmSample &sample : samples) {
+        if (&sample == &best || pos >= size) {
+            continue;
+        }
+
+        const int rc = snprintf(buf + pos, size - pos, "%s%s %.1f", pos ? ", " : "", Asm::toString(sample.assembly), sample.hashrate());
+        if (rc > 0) {
+            pos += static_cast<size_t>(rc);
+        }
+    }
+
+    return buf;
+}
+
+
+} /* namespace xlarig */
+
+
+xlarig::Assembly xlarig::AsmBench::assembly(Algo algorithm, AlgoVariant av, Variant variant)
+{
+    const int way = wayIndex(av);
+    if (way < 0 || algorithm < 0 || algorithm >= ALGO_MAX || variant < VARIANT_0 || variant >= VARIANT_MAX) {
+        return Cpu::info()->assembly();
+    }
+
+    const Assembly assembly = static_cast<Assembly>(choice.map[algorithm][variant][way].load(std::memory_order_relaxed));
+
+    return assembly != ASM_AUTO ? assembly : Cpu::info()->assembly();
+}
+
+
+bool xlarig::AsmBench::start(Controller *controller, void (*callback)())
+{
+    using namespace rapidjson;
+
+    const Config *config = controller->config();
+    if (config->assembly() != ASM_AUTO || !config->isHwAES()) {
+        return false;
+    }
+
+    const Algo algorithm  = config->algorithm().algo();
+    const Variant variant = config->algorithm().variant();
+    if (algorithm < 0 || algorithm >= ALGO_MAX || variant < VARIANT_0 || variant >= VARIANT_MAX) {
+        return false;
+    }
+
+    const char *algo = config->algorithm().shortName();
+    auto task        = new AsmBenchTask(algorithm, variant, config->siblingPath(kCacheFile), algo, callback);
+
+    task->samples[0] = candidates(algorithm, AV_SINGLE, variant);
+    task->samples[1] = candidates(algorithm, AV_DOUBLE, variant);
+
+    if (task->samples[0].size() < 2 && task->samples[1].size() < 2) {
+        delete task;
+        return false;
+    }
+
+    Document doc;
+    if (task->fileName.isNull() || !Json::get(task->fileName, doc) || !doc.IsObject()) {
+        doc.SetObject();
+    }
+
+    const Value &cpuCache = Json::getObject(doc, Cpu::info()->brand());
+    if (cpuCache.IsObject()) {
+        const Value &cached = Json::getObject(cpuCache, algo);
+
+        if (cached.IsObject()) {
+            for (size_t way = 0; way < 2; ++way) {
+                choice.map[algorithm][variant][way] = Asm::parse(Json::getString(cached, kWays[way], "auto"));
+            }
+
+            LOG_INFO(WHITE_BOLD("asm") " use cached main loops for \"%s\": single " CYAN_BOLD("%s") ", double " CYAN_BOLD("%s"),
+                     algo, Asm::toString(assembly(algorithm, AV_SINGLE, variant)), Asm::toString(assembly(algorithm, AV_DOUBLE, variant)));
+
+            delete task;
+            return false;
+        }
+    }
+
+    LOG_INFO(WHITE_BOLD("asm") " measure main loops for \"%s\", up to %zu hashes each", algo, kHashes);
+
+    uv_queue_work(uv_default_loop(), &task->req, AsmBench::onWork, AsmBench::onDone);
+
+    return true;
+}
+
+
+void xlarig::AsmBench::onDone(uv_work_t *req, int)
+{
+    auto task = static_cast<AsmBenchTask *>(req->data);
+
+    task->callback();
+
+    delete task;
+}
+
+
+void xlarig::AsmBench::onWork(uv_work_t *req)
+{
+    using namespace rapidjson;
+
+    auto task             = static_cast<AsmBenchTask *>(req->data);
+    const Algo algorithm  = task->algorithm;
+    const Variant variant = task->variant;
+    const char *cpu       = Cpu::info()->brand();
+
+    cryptonight_ctx *ctx[2] = { nullptr, nullptr };
+    MemInfo info = Mem::create(ctx, algorithm, 2);
+
+    Assembly results[2] = { ASM_AUTO, ASM_AUTO };
+
+    for (size_t way = 0; way < 2; ++way) {
+        std::vector<AsmSample> &samples = task->samples[way];
+        if (samples.size() < 2) {
+            continue;
+        }
+
+        measure(samples, ctx, way + 1);
+
+        const AsmSample *best = &samples[0];
+        for (const AsmSample &sample : samples) {
+            if (sample.hashrate() > best->hashrate()) {
+                best = &sample;
+            }
+        }
+
+        choice.map[algorithm][variant][way] = best->assembly;
+        results[way] = best->assembly;
+
+        char buf[128] = { 0 };
+        LOG_INFO(WHITE_BOLD("asm") " %s " CYAN_BOLD("%s %.1f H/s") " (%s)",
+                 kWays[way], Asm::toString(best->assembly), best->hashrate(), describe(samples, *best, buf, sizeof(buf)));
+    }
+
+    Mem::release(ctx, 2, info);
+
+    if (task->fileName.isNull()) {
+        return;
+    }
+
+    Document doc;
+    if (!Json::get(task->fileName, doc) || !doc.IsObject()) {
+        doc.SetObject();
+    }
+
+    auto &allocator = doc.GetAllocator();
+    Value result(kObjectType);
+
+    for (size_t way = 0; way < 2; ++way) {
+        if (results[way] != ASM_AUTO) {
+            result.AddMember(StringRef(kWays[way]), StringRef(Asm::toString(results[way])), allocator);
+        }
+    }
+
+    if (!doc.HasMember(cpu) || !doc[cpu].IsObject()) {
+        doc.RemoveMember(cpu);
+        doc.AddMember(Value(cpu, allocator), Value(kObjectType), allocator);
+    }
+
+    Value &cpuObj = doc[cpu];
+    cpuObj.RemoveMember(task->algo);
+    cpuObj.AddMember(Value(task->algo, allocator), result, allocator);
+
+    if (!Json::save(task->fileName, doc)) {
+        LOG_WARN("asm: failed to save \"%s\"", task->fileName.data());
+    }
+}
@@ -0,0 +1,65 @@
+/* XMRig and XLArig
+ * Copyright 2010      Jeff Garzik <jgarzik@pobox.com>
+ * Copyright 2012-2014 pooler      <pooler@litecoinpool.org>
+ * Copyright 2014      Lucas Jones <https://github.com/lucasjones>
+ * Copyright 2014-2016 Wolf9466    <https://github.com/OhGodAPet>
+ * Copyright 2016      Jay D Dee   <jayddee246@gmail.com>
+ * Copyright 2017-2018 XMR-Stak    <https://github.com/fireice-uk>, <https://github.com/psychocrypt>
+ * Copyright 2018-2019 SChernykh   <https://github.com/SChernykh>
+ * Copyright 2016-2019 XMRig       <https://github.com/xmrig>, <support@xmrig.com>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef XMRIG_ASMBENCH_H
+#define XMRIG_ASMBENCH_H
+
+
+#include <uv.h>
+
+
+#include "common/xlarig.h"
+
+
+namespace xlarig {
+
+
+class Controller;
+
+
+/**
+ * @brief Startup microbenchmark for the "asm": "auto" setting.
+ *
+ * Every main loop flavour available for the configured algorithm (C code, intel, ryzen and bulldozer assembly)
+ * is timed on a few hundred hashes in single and double way mode, the fastest one replaces the vendor guess in
+ * CpuThread::fn(). Results are cached next to the config file per CPU brand and algorithm. The measurement runs
+ * on the libuv thread pool, start() returns true if it was queued and the callback is then called from the main
+ * loop once the choice is made.
+ */
+class AsmBench
+{
+public:
+    static Assembly assembly(Algo algorithm, AlgoVariant av, Variant variant);
+    static bool start(Controller *controller, void (*callback)());
+
+private:
+    static void onDone(uv_work_t *req, int status);
+    static void onWork(uv_work_t *req);
+};
+
+
+} /* namespace xlarig */
+
+
+#endif /* XMRIG_ASMBENCH_H */
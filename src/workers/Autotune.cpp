@@ -0,0 +1,435 @@
+/* XMRig and XLArig
+ * Copyright 2010      Jeff Garzik <jgarzik@pobox.com>
+ * Copyright 2012-2014 pooler      <pooler@litecoinpool.org>
+ * Copyright 2014      Lucas Jones <https://github.com/lucasjones>
+ * Copyright 2014-2016 Wolf9466    <https://github.com/OhGodAPet>
+ * Copyright 2016      Jay D Dee   <jayddee246@gmail.com>
+ * Copyright 2017-2018 XMR-Stak    <https://github.com/fireice-uk>, <https://github.com/psychocrypt>
+ * Copyright 2018-2019 SChernykh   <https://github.com/SChernykh>
+ * Copyright 2016-2019 XMRig       <https://github.com/xmrig>, <support@xmrig.com>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <uv.h>
+
+
+#include "base/io/json/Json.h"
+#include "base/io/log/Log.h"
+#include "common/cpu/Cpu.h"
+#include "common/cpu/CpuTopology.h"
+#include "core/config/Config.h"
+#include "core/Controller.h"
+#include "crypto/cn/CryptoNight_constants.h"
+#include "rapidjson/document.h"
+#include "workers/Autotune.h"
+#include "workers/Hashrate.h"
+#include "workers/Workers.h"
+
+
+namespace xlarig {
+
+
+static const char *kCacheFile        = "autotune.json";
+static const size_t kMaxCandidates   = 12;
+static const uint64_t kLaunchTimeout = 180 * 1000;
+
+
+static bool isEqual(const std::vector<CpuThread::Data> &a, const std::vector<CpuThread::Data> &b)
+{
+    if (a.size() != b.size()) {
+        return false;
+    }
+
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i].multiway != b[i].multiway || a[i].affinity != b[i].affinity) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+static std::vector<CpuThread::Data> fromSlots(const std::vector<CpuTopology::Slot> &slots, Assembly assembly, bool primaryOnly)
+{
+    std::vector<CpuThread::Data> threads;
+    std::vector<std::pair<int32_t, int32_t> > cores;
+
+    for (const CpuTopology::Slot &slot : slots) {
+        if (primaryOnly) {
+            const auto &units = Cpu::topology()->units();
+            auto it = std::find_if(units.begin(), units.end(), [&slot](const CpuTopology::Unit &unit) { return unit.cpu == slot.cpu; });
+            if (it != units.end()) {
+                const std::pair<int32_t, int32_t> core(it->package, it->core);
+                if (std::find(cores.begin(), cores.end(), core) != cores.end()) {
+                    continue;
+                }
+
+                cores.push_back(core);
+            }
+        }
+
+        CpuThread::Data data;
+        data.setMultiway(slot.multiway);
+        data.affinity = slot.cpu;
+        data.assembly = assembly;
+
+        threads.push_back(data);
+    }
+
+    return threads;
+}
+
+
+} /* namespace xlarig */
+
+
+xlarig::Autotune::Autotune(Controller *controller) :
+    m_controller(controller),
+    m_current(0),
+    m_measured(0),
+    m_started(0)
+{
+    const Config *config = controller->config();
+
+    char key[256] = { 0 };
+    int size = snprintf(key, sizeof(key) - 1, "%s/%zu/", Cpu::info()->brand(), Cpu::topology()->units().size());
+    if (size < 0) {
+        size = 0;
+    }
+
+    for (const CpuTopology::Cache &cache : Cpu::topology()->l3()) {
+        if (static_cast<size_t>(size) >= sizeof(key) - 1) {
+            break;
+        }
+
+        size += snprintf(key + size, sizeof(key) - 1 - size, "%s%zuK", key[size - 1] == '/' ? "" : "+", cache.size / 1024);
+    }
+
+    if (static_cast<size_t>(size) < sizeof(key) - 1) {
+        snprintf(key + size, sizeof(key) - 1 - size, "/%s", config->algorithm().shortName());
+    }
+
+    m_key = static_cast<const char *>(key);
+
+    m_fileName = config->siblingPath(kCacheFile);
+
+    if (load()) {
+        return;
+    }
+
+    generate();
+
+    if (m_candidates.size() < 2) {
+        LOG_WARN("autotune: nothing to tune, only %zu layout available", m_candidates.size());
+        m_candidates.clear();
+
+        return;
+    }
+
+    LOG_INFO(WHITE_BOLD("autotune") " " CYAN_BOLD("%zu") " layouts queued, each one is measured over %u seconds on the current job",
+             m_candidates.size(), Hashrate::ShortInterval / 1000);
+}
+
+
+xlarig::Autotune::~Autotune()
+{
+    for (IThread *thread : m_threads) {
+        delete thread;
+    }
+}
+
+
+void xlarig::Autotune::tick()
+{
+    if (isDone()) {
+        return;
+    }
+
+    if (Workers::isPaused() || !Workers::job().isValid()) {
+        m_measured = 0;
+        return;
+    }
+
+    const uint64_t now = uv_now(uv_default_loop());
+
+    if (m_started == 0) {
+        std::vector<IThread *> threads = create(m_candidates[m_current]);
+        Workers::restart(threads);
+
+        for (IThread *thread : m_threads) {
+            delete thread;
+        }
+
+        m_threads  = std::move(threads);
+        m_started  = now;
+        m_measured = 0;
+
+        return;
+    }
+
+    const Hashrate *hashrate = Workers::hashrate();
+
+    if (m_measured == 0) {
+        for (size_t i = 0; i < hashrate->threads(); ++i) {
+            if (!isnormal(hashrate->calc(i, Hashrate::ShortInterval))) {
+                if (now - m_started > kLaunchTimeout) {
+                    LOG_WARN("autotune: layout %zu/%zu did not start hashing, skipped", m_current + 1, m_candidates.size());
+
+                    return next();
+                }
+
+                return;
+            }
+        }
+
+        // every thread has a full window now, start measuring from a clean one
+        m_measured = now;
+        return;
+    }
+
+    if (now - m_measured < Hashrate::ShortInterval) {
+        return;
+    }
+
+    Candidate &candidate = m_candidates[m_current];
+    candidate.hashrate   = hashrate->calc(Hashrate::ShortInterval);
+
+    char buf[64] = { 0 };
+    char num[16] = { 0 };
+    LOG_INFO(WHITE_BOLD("autotune") " %zu/%zu %s " CYAN_BOLD("%s H/s"),
+             m_current + 1, m_candidates.size(), describe(candidate, buf, sizeof(buf)), Hashrate::format(candidate.hashrate, num, sizeof(num)));
+
+    next();
+}
+
+
+bool xlarig::Autotune::load()
+{
+    if (m_fileName.isNull()) {
+        return false;
+    }
+
+    rapidjson::Document doc;
+    if (!Json::get(m_fileName, doc)) {
+        return false;
+    }
+
+    const rapidjson::Value &value = Json::getArray(doc, m_key);
+    if (!value.IsArray()) {
+        return false;
+    }
+
+    Candidate candidate;
+    for (const rapidjson::Value &thread : value.GetArray()) {
+        if (!thread.IsObject() || !thread.HasMember("low_power_mode")) {
+            continue;
+        }
+
+        auto data = CpuThread::parse(thread);
+        if (data.valid) {
+            candidate.threads.push_back(std::move(data));
+        }
+    }
+
+    if (candidate.threads.empty()) {
+        return false;
+    }
+
+    char buf[64] = { 0 };
+    LOG_INFO(WHITE_BOLD("autotune") " use cached layout %s for \"%s\"", describe(candidate, buf, sizeof(buf)), m_key.data());
+
+    m_controller->config()->setThreads(candidate.threads);
+
+    return true;
+}
+
+
+const char *xlarig::Autotune::describe(const Candidate &candidate, char *buf, size_t size) const
+{
+    size_t ways = 0;
+    for (const CpuThread::Data &data : candidate.threads) {
+        ways += data.multiway;
+    }
+
+    snprintf(buf, size, "threads " CYAN_BOLD("%zu(%zu)"), candidate.threads.size(), ways);
+
+    return buf;
+}
+
+
+std::vector<xlarig::IThread *> xlarig::Autotune::create(const Candidate &candidate) const
+{
+    const Config *config = m_controller->config();
+    std::vector<IThread *> threads;
+
+    for (size_t i = 0; i < candidate.threads.size(); ++i) {
+        threads.push_back(CpuThread::createFromData(i, config->algorithm().algo(), candidate.threads[i], config->priority(), !config->isHwAES()));
+    }
+
+    return threads;
+}
+
+
+void xlarig::Autotune::add(const std::vector<CpuThread::Data> &threads)
+{
+    if (threads.empty() || m_candidates.size() >= kMaxCandidates) {
+        return;
+    }
+
+    for (const Candidate &candidate : m_candidates) {
+        if (isEqual(candidate.threads, threads)) {
+            return;
+        }
+    }
+
+    Candidate candidate;
+    candidate.threads = threads;
+
+    m_candidates.push_back(std::move(candidate));
+}
+
+
+void xlarig::Autotune::finish()
+{
+    size_t best = 0;
+    for (size_t i = 1; i < m_candidates.size(); ++i) {
+        if (m_candidates[i].hashrate > m_candidates[best].hashrate) {
+            best = i;
+        }
+    }
+
+    if (!isnormal(m_candidates[best].hashrate)) {
+        LOG_ERR("autotune: no layout produced a valid hashrate, keep current threads");
+        return;
+    }
+
+    char buf[64] = { 0 };
+    char num[16] = { 0 };
+    LOG_INFO(WHITE_BOLD("autotune") " done, best layout %s " CYAN_BOLD("%s H/s"),
+             describe(m_candidates[best], buf, sizeof(buf)), Hashrate::format(m_candidates[best].hashrate, num, sizeof(num)));
+
+    if (best != m_candidates.size() - 1) {
+        std::vector<IThread *> threads = create(m_candidates[best]);
+        Workers::restart(threads);
+
+        for (IThread *thread : m_threads) {
+            delete thread;
+        }
+
+        m_threads = std::move(threads);
+    }
+
+    Config *config = m_controller->config();
+    config->setThreads(m_candidates[best].threads);
+
+    if (config->isShouldSave()) {
+        config->save();
+    }
+
+    save(m_candidates[best]);
+}
+
+
+void xlarig::Autotune::generate()
+{
+    const Config *config   = m_controller->config();
+    const Algo algo        = config->algorithm().algo();
+    const Assembly asmType = config->assembly();
+    int maxWays            = algo == RANDOM_X ? IThread::SingleWay : IThread::MaxWay;
+
+#   ifdef XMRIG_ALGO_CN_GPU
+    if (config->algorithm().variant() == VARIANT_GPU) {
+        maxWays = IThread::DoubleWay;
+    }
+#   endif
+
+    if (Cpu::topology()->isValid()) {
+        for (int ways = IThread::SingleWay; ways <= maxWays; ++ways) {
+            const std::vector<CpuTopology::Slot> slots = Cpu::topology()->layout(algo, ways, false, config->affinity(), config->maxCpuUsage());
+
+            add(fromSlots(slots, asmType, false));
+            add(fromSlots(slots, asmType, true));
+        }
+
+        if (maxWays > IThread::SingleWay) {
+            add(fromSlots(Cpu::topology()->layout(algo, IThread::SingleWay, true, config->affinity(), config->maxCpuUsage()), asmType, false));
+        }
+
+        return;
+    }
+
+    const size_t memory = cn_select_memory(algo, config->algorithm().variant()) / 1024;
+
+    for (int ways = IThread::SingleWay; ways <= maxWays; ++ways) {
+        const size_t count = Cpu::info()->optimalThreadsCount(ways * memory, config->maxCpuUsage());
+
+        CpuThread::Data data;
+        data.setMultiway(ways);
+        data.assembly = asmType;
+
+        add(std::vector<CpuThread::Data>(count, data));
+    }
+}
+
+
+void xlarig::Autotune::next()
+{
+    m_current++;
+    m_started  = 0;
+    m_measured = 0;
+
+    if (isDone()) {
+        finish();
+    }
+}
+
+
+void xlarig::Autotune::save(const Candidate &candidate) const
+{
+    using namespace rapidjson;
+
+    if (m_fileName.isNull()) {
+        return;
+    }
+
+    Document doc;
+    if (!Json::get(m_fileName, doc)) {
+        doc.SetObject();
+    }
+
+    auto &allocator = doc.GetAllocator();
+
+    Value threads(kArrayType);
+    for (const IThread *thread : create(candidate)) {
+        threads.PushBack(thread->toConfig(doc), allocator);
+        delete thread;
+    }
+
+    if (doc.HasMember(m_key.data())) {
+        doc[m_key.data()] = threads;
+    }
+    else {
+        doc.AddMember(Value(m_key.data(), allocator), threads, allocator);
+    }
+
+    if (!Json::save(m_fileName, doc)) {
+        LOG_WARN("autotune: failed to save \"%s\"", m_fileName.data());
+    }
+}
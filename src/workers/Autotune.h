@@ -0,0 +1,93 @@
+/* XMRig and XLArig
+ * Copyright 2010      Jeff Garzik <jgarzik@pobox.com>
+ * Copyright 2012-2014 pooler      <pooler@litecoinpool.org>
+ * Copyright 2014      Lucas Jones <https://github.com/lucasjones>
+ * Copyright 2014-2016 Wolf9466    <https://github.com/OhGodAPet>
+ * Copyright 2016      Jay D Dee   <jayddee246@gmail.com>
+ * Copyright 2017-2018 XMR-Stak    <https://github.com/fireice-uk>, <https://github.com/psychocrypt>
+ * Copyright 2018-2019 SChernykh   <https://github.com/SChernykh>
+ * Copyright 2016-2019 XMRig       <https://github.com/xmrig>, <support@xmrig.com>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef XMRIG_AUTOTUNE_H
+#define XMRIG_AUTOTUNE_H
+
+
+#include <stdint.h>
+#include <vector>
+
+
+#include "base/tools/String.h"
+#include "workers/CpuThread.h"
+
+
+namespace xlarig {
+
+
+class Controller;
+class IThread;
+
+
+/**
+ * @brief Online search for the fastest thread layout.
+ *
+ * Candidate layouts (multiway, thread count, SMT siblings) are run one after another against the current job,
+ * each one is scored by the total hashrate over a full Hashrate::ShortInterval window. The winner is written back
+ * to the config and cached per CPU brand and topology, so identical hosts pick it up without searching again.
+ */
+class Autotune
+{
+public:
+    Autotune(Controller *controller);
+    ~Autotune();
+
+    void tick();
+
+    inline bool isDone() const { return m_current >= m_candidates.size(); }
+
+private:
+    struct Candidate
+    {
+        inline Candidate() : hashrate(0.0) {}
+
+        double hashrate;
+        std::vector<CpuThread::Data> threads;
+    };
+
+    bool load();
+    const char *describe(const Candidate &candidate, char *buf, size_t size) const;
+    std::vector<IThread *> create(const Candidate &candidate) const;
+    void add(const std::vector<CpuThread::Data> &threads);
+    void finish();
+    void generate();
+    void next();
+    void save(const Candidate &candidate) const;
+
+    Controller *m_controller;
+    size_t m_current;
+    std::vector<Candidate> m_candidates;
+    std::vector<IThread *> m_threads;
+    String m_fileName;
+    String m_key;
+    uint64_t m_measured;
+    uint64_t m_started;
+};
+
+
+} /* namespace xlarig */
+
+
+#endif /* XMRIG_AUTOTUNE_H */
@@ -27,6 +27,8 @@
 
 
 #include "common/xlarig.h"
+#include "crypto/cn/CnHash.h"
+#include "crypto/common/Algorithm.h"
 #include "interfaces/IThread.h"
 
 
@@ -45,7 +47,7 @@ public:
 
         inline void setMultiway(int value)
         {
-            if (value >= SingleWay && value <= PentaWay) {
+            if (value >= SingleWay && value <= MaxWay) {
                 multiway = static_cast<Multiway>(value);
                 valid    = true;
             }
@@ -60,12 +62,7 @@ public:
 
     CpuThread(size_t index, Algo algorithm, AlgoVariant av, Multiway multiway, int64_t affinity, int priority, bool softAES, bool prefetch, Assembly assembly);
 
-    typedef void (*cn_hash_fun)(const uint8_t *input, size_t size, uint8_t *output, cryptonight_ctx **ctx, uint64_t height);
-    typedef void (*cn_mainloop_fun)(cryptonight_ctx **ctx);
-
-#   ifndef XMRIG_NO_ASM
-    static void patchAsmVariants();
-#   endif
+    typedef CnHash::cn_hash_fun cn_hash_fun;
 
     static bool isSoftAES(AlgoVariant av);
     static cn_hash_fun fn(Algo algorithm, AlgoVariant av, Variant variant, Assembly assembly);
@@ -77,6 +74,7 @@ public:
     inline bool isPrefetch() const               { return m_prefetch; }
     inline bool isSoftAES() const                { return m_softAES; }
     inline cn_hash_fun fn(Variant variant) const { return fn(m_algorithm, m_av, variant, m_assembly); }
+    inline cn_hash_fun fn(const Algorithm &algorithm) const { return fn(algorithm.algo(), m_av, algorithm.variant(), m_assembly); }
 
     inline Algo algorithm() const override       { return m_algorithm; }
     inline int priority() const override         { return m_priority; }
@@ -75,6 +75,21 @@ Hashrate::Hashrate(size_t threads, xlarig::Controller *controller) :
 }
 
 
+Hashrate::~Hashrate()
+{
+    stop();
+
+    for (size_t i = 0; i < m_threads; i++) {
+        delete [] m_counts[i];
+        delete [] m_timestamps[i];
+    }
+
+    delete [] m_counts;
+    delete [] m_timestamps;
+    delete [] m_top;
+}
+
+
 double Hashrate::calc(size_t ms) const
 {
     double result = 0.0;
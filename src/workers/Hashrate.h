@@ -45,6 +45,7 @@ public:
     };
 
     Hashrate(size_t threads, xlarig::Controller *controller);
+    ~Hashrate();
     double calc(size_t ms) const;
     double calc(size_t threadId, size_t ms) const;
     void add(size_t threadId, uint64_t count, uint64_t timestamp);
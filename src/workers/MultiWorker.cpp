@@ -27,49 +27,103 @@
 #include <thread>
 
 
+#include "base/io/log/Log.h"
+#include "crypto/cn/CryptoNight.h"
 #include "crypto/cn/CryptoNight_test.h"
 #include "workers/CpuThread.h"
 #include "workers/MultiWorker.h"
 #include "workers/Workers.h"
 
 
+constexpr const size_t kTestHashes = sizeof(test_input) / 76;
+
+
+struct TestVector
+{
+    xlarig::Algo algo;
+    xlarig::Variant variant;
+    const uint8_t *output;
+    bool height;
+};
+
+
+static TestVector const testVectors[] = {
+    { xlarig::CRYPTONIGHT,       xlarig::VARIANT_0,      test_output_v0,         false },
+    { xlarig::CRYPTONIGHT,       xlarig::VARIANT_1,      test_output_v1,         false },
+    { xlarig::CRYPTONIGHT,       xlarig::VARIANT_2,      test_output_v2,         false },
+    { xlarig::CRYPTONIGHT,       xlarig::VARIANT_XTL,    test_output_xtl,        false },
+    { xlarig::CRYPTONIGHT,       xlarig::VARIANT_MSR,    test_output_msr,        false },
+    { xlarig::CRYPTONIGHT,       xlarig::VARIANT_XAO,    test_output_xao,        false },
+    { xlarig::CRYPTONIGHT,       xlarig::VARIANT_RTO,    test_output_rto,        false },
+    { xlarig::CRYPTONIGHT,       xlarig::VARIANT_HALF,   test_output_half,       false },
+    { xlarig::CRYPTONIGHT,       xlarig::VARIANT_WOW,    test_output_wow,        true  },
+    { xlarig::CRYPTONIGHT,       xlarig::VARIANT_4,      test_output_r,          true  },
+    { xlarig::CRYPTONIGHT,       xlarig::VARIANT_RWZ,    test_output_rwz,        false },
+    { xlarig::CRYPTONIGHT,       xlarig::VARIANT_ZLS,    test_output_zls,        false },
+    { xlarig::CRYPTONIGHT,       xlarig::VARIANT_DOUBLE, test_output_double,     false },
+
+#   ifdef XMRIG_ALGO_CN_GPU
+    { xlarig::CRYPTONIGHT,       xlarig::VARIANT_GPU,    test_output_gpu,        false },
+#   endif
+
+#   ifdef XMRIG_ALGO_CN_LITE
+    { xlarig::CRYPTONIGHT_LITE,  xlarig::VARIANT_0,      test_output_v0_lite,    false },
+    { xlarig::CRYPTONIGHT_LITE,  xlarig::VARIANT_1,      test_output_v1_lite,    false },
+#   endif
+
+#   ifdef XMRIG_ALGO_CN_HEAVY
+    { xlarig::CRYPTONIGHT_HEAVY, xlarig::VARIANT_0,      test_output_v0_heavy,   false },
+    { xlarig::CRYPTONIGHT_HEAVY, xlarig::VARIANT_XHV,    test_output_xhv_heavy,  false },
+    { xlarig::CRYPTONIGHT_HEAVY, xlarig::VARIANT_TUBE,   test_output_tube_heavy, false },
+#   endif
+
+#   ifdef XMRIG_ALGO_CN_PICO
+    { xlarig::CRYPTONIGHT_PICO,  xlarig::VARIANT_TRTL,   test_output_pico_trtl,  false },
+#   endif
+};
+
+
 template<size_t N>
 MultiWorker<N>::MultiWorker(ThreadHandle *handle)
     : Worker(handle)
 {
-    if (m_thread->algorithm() != xlarig::RANDOM_X) {
-        m_memory = Mem::create(m_ctx, m_thread->algorithm(), N);
-    }
+    m_memory = Mem::create(m_ctx, N);
+    updateMemory(xlarig::Algorithm(m_thread->algorithm(), xlarig::VARIANT_AUTO));
 }
 
 
 template<size_t N>
 MultiWorker<N>::~MultiWorker()
 {
-    Mem::release(m_ctx, N, m_memory);
-
 #   ifdef XMRIG_ALGO_RANDOMX
     if (m_rx_vm) {
         defyx_destroy_vm(m_rx_vm);
     }
 #   endif
+
+    Mem::release(m_ctx, N, m_memory);
 }
 
 
 #ifdef XMRIG_ALGO_RANDOMX
+template<size_t N>
+int MultiWorker<N>::isCancelled(void *arg)
+{
+    return Workers::isJobOutdated(*static_cast<const uint64_t *>(arg)) ? 1 : 0;
+}
+
+
 template<size_t N>
 void MultiWorker<N>::allocateRandomX_VM()
 {
     if (!m_rx_vm) {
-        int flags = RANDOMX_FLAG_LARGE_PAGES | RANDOMX_FLAG_FULL_MEM | RANDOMX_FLAG_JIT;
+        int flags = RANDOMX_FLAG_FULL_MEM | RANDOMX_FLAG_JIT;
         if (!m_thread->isSoftAES()) {
             flags |= RANDOMX_FLAG_HARD_AES;
         }
 
-        m_rx_vm = defyx_create_vm(static_cast<defyx_flags>(flags), nullptr, Workers::getDataset());
-        if (!m_rx_vm) {
-            m_rx_vm = defyx_create_vm(static_cast<defyx_flags>(flags - RANDOMX_FLAG_LARGE_PAGES), nullptr, Workers::getDataset());
-        }
+        // the scratchpad is the start of the thread arena, shared with CryptoNight lanes
+        m_rx_vm = defyx_create_vm_scratchpad(static_cast<defyx_flags>(flags), nullptr, Workers::getDataset(), m_memory.memory);
     }
 }
 #endif
@@ -78,110 +132,129 @@ void MultiWorker<N>::allocateRandomX_VM()
 template<size_t N>
 bool MultiWorker<N>::selfTest()
 {
-    using namespace xlarig;
-
-    if (m_thread->algorithm() == CRYPTONIGHT) {
-        const bool rc = verify(VARIANT_0,      test_output_v0)   &&
-                        verify(VARIANT_1,      test_output_v1)   &&
-                        verify(VARIANT_2,      test_output_v2)   &&
-                        verify(VARIANT_XTL,    test_output_xtl)  &&
-                        verify(VARIANT_MSR,    test_output_msr)  &&
-                        verify(VARIANT_XAO,    test_output_xao)  &&
-                        verify(VARIANT_RTO,    test_output_rto)  &&
-                        verify(VARIANT_HALF,   test_output_half) &&
-                        verify2(VARIANT_WOW,   test_output_wow)  &&
-                        verify2(VARIANT_4,     test_output_r)    &&
-                        verify(VARIANT_RWZ,    test_output_rwz)  &&
-                        verify(VARIANT_ZLS,    test_output_zls)  &&
-                        verify(VARIANT_DOUBLE, test_output_double);
-
-#       ifdef XMRIG_ALGO_CN_GPU
-        if (!rc || N > 1) {
-            return rc;
-        }
+    const xlarig::Algo algo = m_thread->algorithm();
 
-        return verify(VARIANT_GPU, test_output_gpu);
-#       else
-        return rc;
-#       endif
-    }
-
-#   ifdef XMRIG_ALGO_CN_LITE
-    if (m_thread->algorithm() == CRYPTONIGHT_LITE) {
-        return verify(VARIANT_0,    test_output_v0_lite) &&
-               verify(VARIANT_1,    test_output_v1_lite);
+#   ifdef XMRIG_ALGO_RANDOMX
+    if (algo == xlarig::RANDOM_X) {
+        return true;
     }
 #   endif
 
-#   ifdef XMRIG_ALGO_CN_HEAVY
-    if (m_thread->algorithm() == CRYPTONIGHT_HEAVY) {
-        return verify(VARIANT_0,    test_output_v0_heavy)  &&
-               verify(VARIANT_XHV,  test_output_xhv_heavy) &&
-               verify(VARIANT_TUBE, test_output_tube_heavy);
-    }
-#   endif
+    size_t count = 0;
 
-#   ifdef XMRIG_ALGO_CN_PICO
-    if (m_thread->algorithm() == CRYPTONIGHT_PICO) {
-        return verify(VARIANT_TRTL, test_output_pico_trtl);
+    for (const TestVector &test : testVectors) {
+        if (test.algo != algo || (test.variant == xlarig::VARIANT_GPU && N > 2)) {
+            continue;
+        }
+
+        if (!verify(xlarig::Algorithm(test.algo, test.variant))) {
+            return false;
+        }
+
+        count++;
     }
-#   endif
 
-#   ifdef XMRIG_ALGO_RANDOMX
-    if (m_thread->algorithm() == RANDOM_X) {
-        return true;
+    return count > 0;
+}
+
+
+/**
+ * Jobs of a variant outside the configured family are checked against their own test vector
+ * the first time they show up, one verify instead of the whole family keeps the switch short.
+ */
+template<size_t N>
+bool MultiWorker<N>::isVerified(const xlarig::Algorithm &algorithm)
+{
+    const xlarig::Algo algo = algorithm.algo();
+    const uint32_t bit      = 1U << algorithm.variant();
+
+    if (((m_verified[algo] | m_failed[algo]) & bit) == 0 && !verify(algorithm)) {
+        m_failed[algo] |= bit;
+
+        LOG_ERR("thread %zu error: \"hash self-test failed\" for %s, its jobs are skipped.", id(), algorithm.shortName());
     }
-#   endif
 
-    return false;
+    return (m_verified[algo] & bit) != 0;
 }
 
 
 template<size_t N>
 void MultiWorker<N>::start()
 {
-    while (Workers::sequence() > 0) {
-        if (Workers::isPaused()) {
-            do {
-                std::this_thread::sleep_for(std::chrono::milliseconds(200));
-            }
-            while (Workers::isPaused());
+    while (!isStopped()) {
+        if (isWaiting()) {
+            wait();
 
-            if (Workers::sequence() == 0) {
+            if (isStopped()) {
                 break;
             }
 
             consumeJob();
         }
 
+        if (m_state.job.isValid() && !isReady()) {
+            // nothing this thread can hash for the current job, sleep until the next one (sequence 0 is a stop)
+            if (m_sequence != 0) {
+                Workers::park(m_sequence);
+            }
+
+            consumeJob();
+            continue;
+        }
+
         while (!Workers::isOutdated(m_sequence)) {
             if ((m_count & 0x7) == 0) {
                 storeStats();
             }
 
-            const xlarig::Variant v = m_state.job.algorithm().variant();
+            if (m_fn) {
+                m_fn(m_state.blob, m_state.job.size(), m_hash, m_ctx, m_state.job.height());
 
-#           ifdef XMRIG_ALGO_RANDOMX
-            if (v == xlarig::VARIANT_RX_DEFYX) {
-                allocateRandomX_VM();
-                Workers::updateDataset(m_state.job.seedHash(), m_totalWays);
-                defyx_calculate_hash(m_rx_vm, m_state.blob, m_state.job.size(), m_hash);
+#               ifndef XMRIG_NO_ASM
+                // the cn/r program got no executable memory and nothing was hashed, retry with the next job
+                if (!m_ctx[0]->generated_code && m_ctx[0]->generated_code_data.variant == m_state.job.algorithm().variant()) {
+                    LOG_ERR("thread %zu error: \"no executable memory for the %s program\", waiting for the next job.", id(), m_state.job.algorithm().shortName());
+
+                    if (m_sequence != 0) {
+                        Workers::park(m_sequence);
+                    }
+
+                    break;
+                }
+#               endif
             }
-            else if (v == xlarig::VARIANT_RX_DEFYX) {
-                // FIXME: same as above, but needs to be different!
+#           ifdef XMRIG_ALGO_RANDOMX
+            else {
                 allocateRandomX_VM();
-                Workers::updateDataset(m_state.job.seedHash(), m_totalWays);
-                defyx_calculate_hash(m_rx_vm, m_state.blob, m_state.job.size(), m_hash);
+                if (!Workers::updateDataset(m_state.job.seedHash(), m_handle, m_sequence)) {
+                    break;
+                }
+
+                // one VM per thread, wider workers run their lanes through it in turn
+                const size_t size = m_state.job.size();
+                size_t i = 0;
+                for (; i < N; ++i) {
+                    if (!defyx_calculate_hash_cancellable(m_rx_vm, m_state.blob + (i * size), size, m_hash + (i * 32), isCancelled, &m_generation)) {
+                        break;
+                    }
+                }
+
+                // the job changed in the middle of a hash, the remaining lanes would only produce stale shares
+                if (i < N) {
+                    Workers::addCancelled();
+                    break;
+                }
             }
-            else
 #           endif
-            {
-                m_thread->fn(v)(m_state.blob, m_state.job.size(), m_hash, m_ctx, m_state.job.height());
-            }
 
             for (size_t i = 0; i < N; ++i) {
                 if (*reinterpret_cast<uint64_t*>(m_hash + (i * 32) + 24) < m_state.job.target()) {
-                    Workers::submit(xlarig::JobResult(m_state.job.poolId(), m_state.job.id(), m_state.job.clientId(), *nonce(i), m_hash + (i * 32), m_state.job.diff(), m_state.job.algorithm()));
+                    if (Workers::isJobOutdated(m_generation)) {
+                        Workers::addStale();
+                    }
+                    else {
+                        Workers::submit(xlarig::JobResult(m_state.job.poolId(), m_state.job.id(), m_state.job.clientId(), *nonce(i), m_hash + (i * 32), m_state.job.diff(), m_state.job.algorithm()));
+                    }
                 }
 
                 *nonce(i) += 1;
@@ -197,6 +270,19 @@ void MultiWorker<N>::start()
 }
 
 
+template<size_t N>
+bool MultiWorker<N>::isReady() const
+{
+#   ifdef XMRIG_ALGO_RANDOMX
+    if (m_state.job.algorithm().algo() == xlarig::RANDOM_X) {
+        return true;
+    }
+#   endif
+
+    return m_fn != nullptr;
+}
+
+
 template<size_t N>
 bool MultiWorker<N>::resume(const xlarig::Job &job)
 {
@@ -210,23 +296,59 @@ bool MultiWorker<N>::resume(const xlarig::Job &job)
 
 
 template<size_t N>
-bool MultiWorker<N>::verify(xlarig::Variant variant, const uint8_t *referenceValue)
+bool MultiWorker<N>::verify(const xlarig::Algorithm &algorithm)
 {
+    for (const TestVector &test : testVectors) {
+        if (test.algo != algorithm.algo() || test.variant != algorithm.variant()) {
+            continue;
+        }
+
+        if (test.height ? verify2(algorithm, test.output) : verify(algorithm, test.output)) {
+            m_verified[test.algo] |= 1U << test.variant;
+            return true;
+        }
+
+        return false;
+    }
+
+    return false;
+}
+
 
-    xlarig::CpuThread::cn_hash_fun func = m_thread->fn(variant);
+template<size_t N>
+bool MultiWorker<N>::verify(const xlarig::Algorithm &algorithm, const uint8_t *referenceValue)
+{
+    xlarig::CpuThread::cn_hash_fun func = m_thread->fn(algorithm);
     if (!func) {
         return false;
     }
 
-    func(test_input, 76, m_hash, m_ctx, 0);
-    return memcmp(m_hash, referenceValue, sizeof m_hash) == 0;
+    if (N <= kTestHashes) {
+        func(test_input, 76, m_hash, m_ctx, 0);
+        return memcmp(m_hash, referenceValue, sizeof m_hash) == 0;
+    }
+
+    // reference data has only 5 hashes, wider kernels reuse them round-robin
+    for (size_t k = 0; k < N; ++k) {
+        memcpy(m_state.blob + (k * 76), test_input + (k % kTestHashes) * 76, 76);
+    }
+
+    func(m_state.blob, 76, m_hash, m_ctx, 0);
+
+    for (size_t k = 0; k < N; ++k) {
+        if (memcmp(m_hash + k * 32, referenceValue + (k % kTestHashes) * 32, 32) != 0) {
+            return false;
+        }
+    }
+
+    return true;
 }
 
 
 template<size_t N>
-bool MultiWorker<N>::verify2(xlarig::Variant variant, const uint8_t *referenceValue)
+bool MultiWorker<N>::verify2(const xlarig::Algorithm &algorithm, const uint8_t *referenceValue)
 {
-    xlarig::CpuThread::cn_hash_fun func = m_thread->fn(variant);
+    xlarig::CpuThread::cn_hash_fun func = m_thread->fn(algorithm);
     if (!func) {
         return false;
     }
@@ -251,9 +373,9 @@ bool MultiWorker<N>::verify2(xlarig::Variant variant, const uint8_t *referenceVa
 
 
 template<>
-bool MultiWorker<1>::verify2(xlarig::Variant variant, const uint8_t *referenceValue)
+bool MultiWorker<1>::verify2(const xlarig::Algorithm &algorithm, const uint8_t *referenceValue)
 {
-    xlarig::CpuThread::cn_hash_fun func = m_thread->fn(variant);
+    xlarig::CpuThread::cn_hash_fun func = m_thread->fn(algorithm);
     if (!func) {
         return false;
     }
@@ -273,13 +395,20 @@ bool MultiWorker<1>::verify2(xlarig::Variant variant, const uint8_t *referenceVa
 template<size_t N>
 void MultiWorker<N>::consumeJob()
 {
+    // generation first, a job replaced in between only makes the next share look stale, never the other way around
+    m_generation    = Workers::generation();
     xlarig::Job job = Workers::job();
-    m_sequence = Workers::sequence();
+    m_sequence      = Workers::sequence();
+
+    updateThread();
+
     if (m_state.job == job) {
         return;
     }
 
     save(job);
+    updateLayout();
+    prepare(job.algorithm());
 
     if (resume(job)) {
         return;
@@ -307,6 +436,62 @@ void MultiWorker<N>::consumeJob()
 }
 
 
+template<size_t N>
+void MultiWorker<N>::updateMemory(const xlarig::Algorithm &algorithm)
+{
+    if (Mem::carve(m_ctx, m_memory, Mem::scratchpad(algorithm), N)) {
+        return;
+    }
+
+    // the arena was sized before this algorithm was in use, grow it once and keep the bigger one
+#   ifdef XMRIG_ALGO_RANDOMX
+    if (m_rx_vm) {
+        defyx_destroy_vm(m_rx_vm);
+        m_rx_vm = nullptr;
+    }
+#   endif
+
+    Mem::release(m_ctx, N, m_memory);
+    m_memory = Mem::create(m_ctx, algorithm.algo(), N);
+    Mem::carve(m_ctx, m_memory, Mem::scratchpad(algorithm), N);
+}
+
+
+template<size_t N>
+void MultiWorker<N>::prepare(const xlarig::Algorithm &algorithm)
+{
+    m_fn = nullptr;
+
+    if (!algorithm.isValid() || algorithm.variant() == xlarig::VARIANT_AUTO) {
+        return;
+    }
+
+    updateMemory(algorithm);
+
+#   ifdef XMRIG_ALGO_RANDOMX
+    if (algorithm.algo() == xlarig::RANDOM_X) {
+        return;
+    }
+#   endif
+
+    xlarig::CpuThread::cn_hash_fun fn = m_thread->fn(algorithm);
+    if (!fn) {
+        const uint32_t bit = 1U << algorithm.variant();
+        if ((m_failed[algorithm.algo()] & bit) == 0) {
+            m_failed[algorithm.algo()] |= bit;
+
+            LOG_WARN("thread %zu has no %zu-way implementation of %s, its jobs are skipped.", id(), N, algorithm.shortName());
+        }
+
+        return;
+    }
+
+    if (isVerified(algorithm)) {
+        m_fn = fn;
+    }
+}
+
+
 template<size_t N>
 void MultiWorker<N>::save(const xlarig::Job &job)
 {
@@ -321,3 +506,6 @@ template class MultiWorker<2>;
 template class MultiWorker<3>;
 template class MultiWorker<4>;
 template class MultiWorker<5>;
+template class MultiWorker<6>;
+template class MultiWorker<7>;
+template class MultiWorker<8>;
@@ -35,6 +35,7 @@
 #include "base/net/stratum/Job.h"
 #include "Mem.h"
 #include "net/JobResult.h"
+#include "workers/CpuThread.h"
 #include "workers/Worker.h"
 
 
@@ -54,14 +55,21 @@ protected:
 
 private:
 #   ifdef XMRIG_ALGO_RANDOMX
+    static int isCancelled(void *arg);
+
     void allocateRandomX_VM();
 #   endif
 
+    bool isReady() const;
+    bool isVerified(const xlarig::Algorithm &algorithm);
     bool resume(const xlarig::Job &job);
-    bool verify(xlarig::Variant variant, const uint8_t *referenceValue);
-    bool verify2(xlarig::Variant variant, const uint8_t *referenceValue);
+    bool verify(const xlarig::Algorithm &algorithm);
+    bool verify(const xlarig::Algorithm &algorithm, const uint8_t *referenceValue);
+    bool verify2(const xlarig::Algorithm &algorithm, const uint8_t *referenceValue);
     void consumeJob();
+    void prepare(const xlarig::Algorithm &algorithm);
     void save(const xlarig::Job &job);
+    void updateMemory(const xlarig::Algorithm &algorithm);
 
     inline uint32_t *nonce(size_t index)
     {
@@ -78,7 +86,10 @@ private:
     cryptonight_ctx *m_ctx[N];
     State m_pausedState;
     State m_state;
+    uint32_t m_failed[xlarig::ALGO_MAX]   = {};
+    uint32_t m_verified[xlarig::ALGO_MAX] = {};
     uint8_t m_hash[N * 32];
+    xlarig::CpuThread::cn_hash_fun m_fn = nullptr;
 
 #   ifdef XMRIG_ALGO_RANDOMX
     defyx_vm *m_rx_vm = nullptr;
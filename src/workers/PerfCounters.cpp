@@ -0,0 +1,296 @@
+/* XMRig and XLArig
+ * Copyright 2010      Jeff Garzik <jgarzik@pobox.com>
+ * Copyright 2012-2014 pooler      <pooler@litecoinpool.org>
+ * Copyright 2014      Lucas Jones <https://github.com/lucasjones>
+ * Copyright 2014-2016 Wolf9466    <https://github.com/OhGodAPet>
+ * Copyright 2016      Jay D Dee   <jayddee246@gmail.com>
+ * Copyright 2017-2018 XMR-Stak    <https://github.com/fireice-uk>, <https://github.com/psychocrypt>
+ * Copyright 2018-2019 SChernykh   <https://github.com/SChernykh>
+ * Copyright 2016-2019 XMRig       <https://github.com/xmrig>, <support@xmrig.com>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef __linux__
+#   include <linux/perf_event.h>
+#   include <sys/ioctl.h>
+#   include <sys/syscall.h>
+#   include <unistd.h>
+#endif
+
+
+#include "base/io/log/Log.h"
+#include "common/cpu/Cpu.h"
+#include "workers/PerfCounters.h"
+
+
+namespace xlarig {
+
+
+static const uint64_t kInterval = 10000;
+
+
+#ifdef __linux__
+static int openEvent(uint32_t type, uint64_t config, int group)
+{
+    perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+
+    attr.size           = sizeof(attr);
+    attr.type           = type;
+    attr.config         = config;
+    attr.disabled       = group == -1 ? 1 : 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv     = 1;
+    attr.read_format    = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, group, PERF_FLAG_FD_CLOEXEC));
+}
+
+
+static inline uint64_t cacheMiss(uint64_t cache)
+{
+    return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+}
+
+
+/**
+ * There is no generic L2 event, use the vendor raw event where it is known.
+ */
+static bool l2Event(uint64_t &config)
+{
+    const char *brand = Cpu::info()->brand();
+
+    if (strstr(brand, "Intel")) {
+        config = 0x3f24; // L2_RQSTS.MISS
+        return true;
+    }
+
+    if (strstr(brand, "AMD") && (strstr(brand, "Ryzen") || strstr(brand, "EPYC") || strstr(brand, "Threadripper"))) {
+        config = 0x0864; // L2CacheReqStat.LsRdBlkC, data cache reads missed in L2
+        return true;
+    }
+
+    return false;
+}
+#endif
+
+
+} /* namespace xlarig */
+
+
+bool xlarig::PerfCounters::m_enabled = false;
+
+
+xlarig::PerfCounters::PerfCounters() :
+    m_baseHashes(0),
+    m_baseTimestamp(0)
+{
+    uv_mutex_init(&m_mutex);
+
+    for (size_t i = 0; i < MAX_COUNTER; ++i) {
+        m_fd[i]   = -1;
+        m_slot[i] = -1;
+        m_base[i] = 0;
+    }
+
+    if (!m_enabled) {
+        return;
+    }
+
+#   ifdef __linux__
+    m_fd[CYCLES] = openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, -1);
+    if (m_fd[CYCLES] < 0) {
+        return;
+    }
+
+    const int group = m_fd[CYCLES];
+
+    m_fd[INSTRUCTIONS] = openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, group);
+    m_fd[LLC_MISSES]   = openEvent(PERF_TYPE_HW_CACHE, cacheMiss(PERF_COUNT_HW_CACHE_LL), group);
+    m_fd[DTLB_MISSES]  = openEvent(PERF_TYPE_HW_CACHE, cacheMiss(PERF_COUNT_HW_CACHE_DTLB), group);
+
+    uint64_t l2 = 0;
+    if (l2Event(l2)) {
+        m_fd[L2_MISSES] = openEvent(PERF_TYPE_RAW, l2, group);
+    }
+
+    int slot = 0;
+    for (size_t i = 0; i < MAX_COUNTER; ++i) {
+        if (m_fd[i] >= 0) {
+            m_slot[i] = slot++;
+        }
+    }
+
+    ioctl(group, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(group, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#   endif
+}
+
+
+xlarig::PerfCounters::~PerfCounters()
+{
+#   ifdef __linux__
+    for (size_t i = MAX_COUNTER; i > 0; --i) {
+        if (m_fd[i - 1] >= 0) {
+            close(m_fd[i - 1]);
+        }
+    }
+#   endif
+
+    uv_mutex_destroy(&m_mutex);
+}
+
+
+xlarig::PerfCounters::Sample xlarig::PerfCounters::sample() const
+{
+    uv_mutex_lock(&m_mutex);
+    const Sample sample = m_sample;
+    uv_mutex_unlock(&m_mutex);
+
+    return sample;
+}
+
+
+/**
+ * Called by the worker at its stats cadence, the counters are read only when the current window is over.
+ */
+void xlarig::PerfCounters::update(uint64_t hashes, uint64_t timestamp)
+{
+    if (!isValid()) {
+        return;
+    }
+
+    if (m_baseTimestamp != 0 && timestamp - m_baseTimestamp < kInterval) {
+        return;
+    }
+
+    uint64_t values[MAX_COUNTER] = { 0 };
+    if (!read(values)) {
+        return;
+    }
+
+    if (m_baseTimestamp != 0 && hashes > m_baseHashes) {
+        const double count = static_cast<double>(hashes - m_baseHashes);
+        Sample sample;
+
+        const uint64_t cycles = values[CYCLES] - m_base[CYCLES];
+        if (m_slot[INSTRUCTIONS] >= 0 && cycles > 0) {
+            sample.ipc = static_cast<double>(values[INSTRUCTIONS] - m_base[INSTRUCTIONS]) / cycles;
+        }
+
+        if (m_slot[LLC_MISSES] >= 0) {
+            sample.llc = (values[LLC_MISSES] - m_base[LLC_MISSES]) / count;
+        }
+
+        if (m_slot[DTLB_MISSES] >= 0) {
+            sample.dtlb = (values[DTLB_MISSES] - m_base[DTLB_MISSES]) / count;
+        }
+
+        if (m_slot[L2_MISSES] >= 0) {
+            sample.l2 = (values[L2_MISSES] - m_base[L2_MISSES]) / count;
+        }
+
+        uv_mutex_lock(&m_mutex);
+        m_sample = sample;
+        uv_mutex_unlock(&m_mutex);
+    }
+
+    memcpy(m_base, values, sizeof(m_base));
+    m_baseHashes    = hashes;
+    m_baseTimestamp = timestamp;
+}
+
+
+/**
+ * Probe once on the main thread, so missing perf support (containers, perf_event_paranoid, virtual
+ * machines without PMU) is reported once and workers do not even try.
+ */
+bool xlarig::PerfCounters::init(bool enabled)
+{
+    m_enabled = false;
+    if (!enabled) {
+        return false;
+    }
+
+#   ifdef __linux__
+    const int fd = openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, -1);
+    if (fd < 0) {
+        const int error = errno;
+        LOG_WARN("perf counters unavailable: \"%s\"%s", strerror(error), (error == EACCES || error == EPERM) ? ", check kernel.perf_event_paranoid" : "");
+
+        return false;
+    }
+
+    close(fd);
+    m_enabled = true;
+#   else
+    LOG_WARN("perf counters are supported only on Linux");
+#   endif
+
+    return m_enabled;
+}
+
+
+const char *xlarig::PerfCounters::format(double value, char *buf, size_t size)
+{
+    if (value < 0.0) {
+        return "n/a";
+    }
+
+    if (value < 10.0) {
+        snprintf(buf, size, "%.2f", value);
+    }
+    else if (value < 10000.0) {
+        snprintf(buf, size, "%.0f", value);
+    }
+    else {
+        snprintf(buf, size, "%.0fk", value / 1000.0);
+    }
+
+    return buf;
+}
+
+
+/**
+ * Group read, values are scaled by enabled/running time when the kernel had to multiplex the group.
+ */
+bool xlarig::PerfCounters::read(uint64_t *values) const
+{
+#   ifdef __linux__
+    uint64_t data[3 + MAX_COUNTER] = { 0 };
+
+    const ssize_t size = ::read(m_fd[CYCLES], data, sizeof(data));
+    if (size < static_cast<ssize_t>(3 * sizeof(uint64_t)) || data[2] == 0) {
+        return false;
+    }
+
+    const uint64_t count = data[0];
+    const double scale   = data[2] < data[1] ? static_cast<double>(data[1]) / data[2] : 1.0;
+
+    for (size_t i = 0; i < MAX_COUNTER; ++i) {
+        if (m_slot[i] >= 0 && static_cast<uint64_t>(m_slot[i]) < count) {
+            values[i] = static_cast<uint64_t>(data[3 + m_slot[i]] * scale);
+        }
+    }
+
+    return true;
+#   else
+    return false;
+#   endif
+}
@@ -0,0 +1,99 @@
+/* XMRig and XLArig
+ * Copyright 2010      Jeff Garzik <jgarzik@pobox.com>
+ * Copyright 2012-2014 pooler      <pooler@litecoinpool.org>
+ * Copyright 2014      Lucas Jones <https://github.com/lucasjones>
+ * Copyright 2014-2016 Wolf9466    <https://github.com/OhGodAPet>
+ * Copyright 2016      Jay D Dee   <jayddee246@gmail.com>
+ * Copyright 2017-2018 XMR-Stak    <https://github.com/fireice-uk>, <https://github.com/psychocrypt>
+ * Copyright 2018-2019 SChernykh   <https://github.com/SChernykh>
+ * Copyright 2016-2019 XMRig       <https://github.com/xmrig>, <support@xmrig.com>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef XMRIG_PERFCOUNTERS_H
+#define XMRIG_PERFCOUNTERS_H
+
+
+#include <stddef.h>
+#include <stdint.h>
+#include <uv.h>
+
+
+namespace xlarig {
+
+
+/**
+ * @brief Hardware performance counters of the calling thread (Linux perf_event_open).
+ *
+ * Must be created on the worker thread it measures. The counters are read at the worker stats
+ * cadence and turned into IPC and misses per hash over ~10 second windows, every metric the
+ * kernel or the CPU cannot provide is reported as unavailable (negative value).
+ */
+class PerfCounters
+{
+public:
+    enum Counter {
+        CYCLES,
+        INSTRUCTIONS,
+        LLC_MISSES,
+        DTLB_MISSES,
+        L2_MISSES,
+        MAX_COUNTER
+    };
+
+    struct Sample
+    {
+        inline Sample() : ipc(-1.0), llc(-1.0), dtlb(-1.0), l2(-1.0) {}
+
+        inline bool isValid() const { return ipc >= 0.0; }
+
+        double ipc;
+        double llc;
+        double dtlb;
+        double l2;
+    };
+
+    PerfCounters();
+    ~PerfCounters();
+
+    Sample sample() const;
+    void update(uint64_t hashes, uint64_t timestamp);
+
+    inline bool isValid() const { return m_fd[CYCLES] >= 0; }
+
+    static bool init(bool enabled);
+    static const char *format(double value, char *buf, size_t size);
+
+    static inline bool isEnabled() { return m_enabled; }
+
+private:
+    bool read(uint64_t *values) const;
+
+    int m_fd[MAX_COUNTER];
+    int m_slot[MAX_COUNTER];
+    mutable uv_mutex_t m_mutex;
+    Sample m_sample;
+    uint64_t m_base[MAX_COUNTER];
+    uint64_t m_baseHashes;
+    uint64_t m_baseTimestamp;
+
+    static bool m_enabled;
+};
+
+
+} /* namespace xlarig */
+
+
+#endif /* XMRIG_PERFCOUNTERS_H */
@@ -28,8 +28,11 @@
 
 ThreadHandle::ThreadHandle(xlarig::IThread *config, uint32_t offset, size_t totalWays) :
     m_worker(nullptr),
-    m_totalWays(totalWays),
-    m_offset(offset),
+    m_failed(false),
+    m_ready(false),
+    m_stopping(false),
+    m_layout((static_cast<uint64_t>(totalWays) << 32) | offset),
+    m_active(config),
     m_config(config)
 {
 }
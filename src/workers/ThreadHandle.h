@@ -27,10 +27,12 @@
 
 
 #include <assert.h>
+#include <atomic>
 #include <stdint.h>
 #include <uv.h>
 
 
+#include "base/net/stratum/Job.h"
 #include "interfaces/IThread.h"
 
 
@@ -40,23 +42,56 @@ class IWorker;
 class ThreadHandle
 {
 public:
+    struct Layout
+    {
+        uint32_t offset;
+        uint32_t totalWays;
+    };
+
+
     ThreadHandle(xlarig::IThread *config, uint32_t offset, size_t totalWays);
     void join();
     void start(void (*callback) (void *));
 
-    inline IWorker *worker() const         { return m_worker; }
-    inline size_t threadId() const         { return m_config->index(); }
-    inline size_t totalWays() const        { return m_totalWays; }
-    inline uint32_t offset() const         { return m_offset; }
-    inline void setWorker(IWorker *worker) { assert(worker != nullptr); m_worker = worker; }
-    inline xlarig::IThread *config() const  { return m_config; }
+    inline bool isFailed() const                       { return m_failed.load(); }
+    inline bool isReady() const                        { return m_ready.load(); }
+    inline bool isStopping() const                     { return m_stopping.load(std::memory_order_relaxed); }
+    inline const xlarig::Job &deferred() const         { return m_deferred; }
+    inline IWorker *worker() const                     { return m_worker; }
+    inline size_t threadId() const                     { return config()->index(); }
+    inline void setActive(xlarig::IThread *config)     { m_active.store(config); }
+    inline void setConfig(xlarig::IThread *config)     { m_config.store(config); }
+    inline void setDeferred(const xlarig::Job &job)    { m_deferred = job; }
+    inline void setFailed()                            { m_failed.store(true); }
+    inline void setReady()                             { m_ready.store(true); }
+    inline void setWorker(IWorker *worker)             { assert(worker != nullptr); m_worker = worker; }
+    inline void stop()                                 { m_stopping.store(true); }
+    inline xlarig::IThread *active() const             { return m_active.load(); }
+    inline xlarig::IThread *config() const             { return m_config.load(); }
+
+    // offset and total ways share one atomic word, a worker never sees one without the other
+    inline Layout layout() const
+    {
+        const uint64_t value = m_layout.load(std::memory_order_acquire);
+
+        return { static_cast<uint32_t>(value), static_cast<uint32_t>(value >> 32) };
+    }
+
+    inline void setLayout(uint32_t offset, size_t totalWays)
+    {
+        m_layout.store((static_cast<uint64_t>(totalWays) << 32) | offset, std::memory_order_release);
+    }
 
 private:
     IWorker *m_worker;
-    size_t m_totalWays;
-    uint32_t m_offset;
+    std::atomic<bool> m_failed;
+    std::atomic<bool> m_ready;
+    std::atomic<bool> m_stopping;
+    std::atomic<uint64_t> m_layout;
+    std::atomic<xlarig::IThread *> m_active;
+    std::atomic<xlarig::IThread *> m_config;
     uv_thread_t m_thread;
-    xlarig::IThread *m_config;
+    xlarig::Job m_deferred;
 };
 
 
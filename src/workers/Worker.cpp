@@ -27,25 +27,75 @@
 #include "common/cpu/Cpu.h"
 #include "common/Platform.h"
 #include "workers/CpuThread.h"
+#include "workers/PerfCounters.h"
 #include "workers/ThreadHandle.h"
 #include "workers/Worker.h"
+#include "workers/Workers.h"
 
 
 Worker::Worker(ThreadHandle *handle) :
     m_id(handle->threadId()),
-    m_totalWays(handle->totalWays()),
-    m_offset(handle->offset()),
+    m_totalWays(0),
+    m_offset(0),
     m_hashCount(0),
     m_timestamp(0),
     m_count(0),
+    m_generation(0),
     m_sequence(0),
-    m_thread(static_cast<xlarig::CpuThread *>(handle->config()))
+    m_handle(handle),
+    m_thread(static_cast<xlarig::CpuThread *>(handle->config())),
+    m_deferred(handle->deferred()),
+    m_perf(nullptr)
 {
+    m_handle->setActive(m_thread);
+    updateLayout();
+
     if (xlarig::Cpu::info()->threads() > 1 && m_thread->affinity() != -1L) {
         Platform::setThreadAffinity(m_thread->affinity());
     }
 
     Platform::setThreadPriority(m_thread->priority());
+
+    if (xlarig::PerfCounters::isEnabled()) {
+        m_perf = new xlarig::PerfCounters();
+    }
+}
+
+
+Worker::~Worker()
+{
+    delete m_perf;
+}
+
+
+/**
+ * Threads spawned by a reconfiguration stay idle until the job they were created on is replaced,
+ * running threads still hash their old nonce ranges for that job.
+ */
+bool Worker::isDeferred()
+{
+    if (!m_deferred.isValid()) {
+        return false;
+    }
+
+    if (Workers::job() == m_deferred) {
+        return true;
+    }
+
+    m_deferred = xlarig::Job();
+    return false;
+}
+
+
+bool Worker::isStopped() const
+{
+    return Workers::sequence() == 0 || m_handle->isStopping();
+}
+
+
+bool Worker::isWaiting()
+{
+    return !isStopped() && (Workers::isPaused() || isDeferred());
 }
 
 
@@ -56,4 +106,54 @@ void Worker::storeStats()
     const uint64_t timestamp = time_point_cast<milliseconds>(high_resolution_clock::now()).time_since_epoch().count();
     m_hashCount.store(m_count, std::memory_order_relaxed);
     m_timestamp.store(timestamp, std::memory_order_relaxed);
+
+    if (m_perf) {
+        m_perf->update(m_count, timestamp);
+    }
+}
+
+
+void Worker::updateLayout()
+{
+    const ThreadHandle::Layout layout = m_handle->layout();
+
+    m_offset    = layout.offset;
+    m_totalWays = layout.totalWays;
+}
+
+
+void Worker::updateThread()
+{
+    xlarig::CpuThread *thread = static_cast<xlarig::CpuThread *>(m_handle->config());
+    if (thread == m_thread) {
+        return;
+    }
+
+    if (thread->affinity() != m_thread->affinity() && xlarig::Cpu::info()->threads() > 1 && thread->affinity() != -1L) {
+        Platform::setThreadAffinity(thread->affinity());
+    }
+
+    if (thread->priority() != m_thread->priority()) {
+        Platform::setThreadPriority(thread->priority());
+    }
+
+    m_thread = thread;
+    m_handle->setActive(thread);
+}
+
+
+/**
+ * Park the thread while it has nothing to hash, everything that can end the wait (new job, resume,
+ * stop or reconfiguration) bumps the workers sequence and wakes it up.
+ */
+void Worker::wait()
+{
+    for (;;) {
+        const uint64_t sequence = Workers::sequence();
+        if (!isWaiting()) {
+            return;
+        }
+
+        Workers::park(sequence);
+    }
 }
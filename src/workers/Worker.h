@@ -29,6 +29,7 @@
 #include <stdint.h>
 
 
+#include "base/net/stratum/Job.h"
 #include "interfaces/IWorker.h"
 #include "Mem.h"
 
@@ -38,6 +39,7 @@ class ThreadHandle;
 
 namespace xlarig {
     class CpuThread;
+    class PerfCounters;
 }
 
 
@@ -45,24 +47,37 @@ class Worker : public IWorker
 {
 public:
     Worker(ThreadHandle *handle);
+    ~Worker() override;
 
-    inline const MemInfo &memory() const       { return m_memory; }
-    inline size_t id() const override          { return m_id; }
-    inline uint64_t hashCount() const override { return m_hashCount.load(std::memory_order_relaxed); }
-    inline uint64_t timestamp() const override { return m_timestamp.load(std::memory_order_relaxed); }
+    inline const MemInfo &memory() const            { return m_memory; }
+    inline ThreadHandle *handle() const             { return m_handle; }
+    inline const xlarig::PerfCounters *perf() const { return m_perf; }
+    inline size_t id() const override               { return m_id; }
+    inline uint64_t hashCount() const override      { return m_hashCount.load(std::memory_order_relaxed); }
+    inline uint64_t timestamp() const override      { return m_timestamp.load(std::memory_order_relaxed); }
 
 protected:
+    bool isDeferred();
+    bool isStopped() const;
+    bool isWaiting();
     void storeStats();
+    void updateLayout();
+    void updateThread();
+    void wait();
 
     const size_t m_id;
-    const size_t m_totalWays;
-    const uint32_t m_offset;
+    size_t m_totalWays;
+    uint32_t m_offset;
     MemInfo m_memory;
     std::atomic<uint64_t> m_hashCount;
     std::atomic<uint64_t> m_timestamp;
     uint64_t m_count;
+    uint64_t m_generation;
     uint64_t m_sequence;
+    ThreadHandle *m_handle;
     xlarig::CpuThread *m_thread;
+    xlarig::Job m_deferred;
+    xlarig::PerfCounters *m_perf;
 };
 
 
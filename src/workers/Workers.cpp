@@ -22,8 +22,10 @@
  *   along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
 #include <cmath>
 #include <inttypes.h>
+#include <string.h>
 #include <thread>
 
 
@@ -32,11 +34,16 @@
 #include "base/tools/Handle.h"
 #include "core/config/Config.h"
 #include "core/Controller.h"
+#include "crypto/cn/CnHash.h"
 #include "crypto/cn/CryptoNight_constants.h"
+#include "crypto/cn/r/CnrCodeCache.h"
 #include "interfaces/IJobResultListener.h"
 #include "interfaces/IThread.h"
 #include "Mem.h"
 #include "rapidjson/document.h"
+#include "workers/AsmBench.h"
+#include "workers/Autotune.h"
+#include "workers/CpuThread.h"
 #include "workers/Hashrate.h"
 #include "workers/MultiWorker.h"
 #include "workers/ThreadHandle.h"
@@ -44,18 +51,28 @@
 
 
 bool Workers::m_active = false;
+bool Workers::m_asmBench = false;
+bool Workers::m_reconfigure = false;
+xlarig::Autotune *Workers::m_autotune = nullptr;
 bool Workers::m_enabled = true;
 Hashrate *Workers::m_hashrate = nullptr;
 xlarig::IJobResultListener *Workers::m_listener = nullptr;
 xlarig::Job Workers::m_job;
 Workers::LaunchStatus Workers::m_status;
 std::atomic<int> Workers::m_paused;
+std::atomic<uint64_t> Workers::m_cancelled;
+std::atomic<uint64_t> Workers::m_generation;
 std::atomic<uint64_t> Workers::m_sequence;
+std::atomic<uint64_t> Workers::m_stale;
 std::list<xlarig::JobResult> Workers::m_queue;
 std::vector<ThreadHandle*> Workers::m_workers;
+std::vector<xlarig::IThread *> Workers::m_layout;
+std::vector<xlarig::IThread *> Workers::m_retired;
 uint64_t Workers::m_ticks = 0;
 uv_async_t *Workers::m_async = nullptr;
+uv_cond_t Workers::m_parkCond;
 uv_mutex_t Workers::m_mutex;
+uv_mutex_t Workers::m_parkMutex;
 uv_rwlock_t Workers::m_rwlock;
 uv_timer_t *Workers::m_timer = nullptr;
 xlarig::Controller *Workers::m_controller = nullptr;
@@ -65,7 +82,11 @@ uv_rwlock_t Workers::m_rx_dataset_lock;
 defyx_cache *Workers::m_rx_cache = nullptr;
 defyx_dataset *Workers::m_rx_dataset = nullptr;
 uint8_t Workers::m_rx_seed_hash[32] = {};
+std::atomic<bool> Workers::m_rx_dataset_started = {};
 std::atomic<uint32_t> Workers::m_rx_dataset_init_thread_counter = {};
+std::atomic<uint32_t> Workers::m_rx_dataset_slice = {};
+uint32_t Workers::m_rx_dataset_parts = 0;
+std::atomic<uint32_t> Workers::m_rx_dataset_threads = {};
 #endif
 
 
@@ -99,6 +120,47 @@ size_t Workers::threads()
 }
 
 
+std::vector<xlarig::IThread *> Workers::threadsList()
+{
+    std::vector<xlarig::IThread *> list;
+    list.reserve(m_workers.size());
+
+    for (const ThreadHandle *handle : m_workers) {
+        list.push_back(handle->config());
+    }
+
+    return list;
+}
+
+
+/**
+ * Block the calling worker until the sequence moves away from the given value, the caller
+ * re-checks its own wait condition afterwards.
+ */
+void Workers::park(uint64_t sequence)
+{
+    uv_mutex_lock(&m_parkMutex);
+
+    while (m_sequence.load() == sequence) {
+        uv_cond_wait(&m_parkCond, &m_parkMutex);
+    }
+
+    uv_mutex_unlock(&m_parkMutex);
+}
+
+
+xlarig::PerfCounters::Sample Workers::perf(size_t threadId)
+{
+    if (threadId >= m_workers.size() || !m_workers[threadId]->worker()) {
+        return xlarig::PerfCounters::Sample();
+    }
+
+    const xlarig::PerfCounters *counters = static_cast<const Worker *>(m_workers[threadId]->worker())->perf();
+
+    return counters ? counters->sample() : xlarig::PerfCounters::Sample();
+}
+
+
 void Workers::printHashrate(bool detail)
 {
     assert(m_controller != nullptr);
@@ -111,19 +173,42 @@ void Workers::printHashrate(bool detail)
         char num2[8] = { 0 };
         char num3[8] = { 0 };
 
-        xlarig::Log::print(WHITE_BOLD_S "| THREAD | AFFINITY | 10s H/s | 60s H/s | 15m H/s |");
+        const bool counters = xlarig::PerfCounters::isEnabled();
+
+        if (counters) {
+            xlarig::Log::print(WHITE_BOLD_S "| THREAD | AFFINITY | 10s H/s | 60s H/s | 15m H/s |  IPC | LLC/H | TLB/H |  L2/H |");
+        }
+        else {
+            xlarig::Log::print(WHITE_BOLD_S "| THREAD | AFFINITY | 10s H/s | 60s H/s | 15m H/s |");
+        }
+
+        for (const ThreadHandle *handle : m_workers) {
+             const xlarig::IThread *thread = handle->config();
 
-        size_t i = 0;
-        for (const xlarig::IThread *thread : m_controller->config()->threads()) {
-             xlarig::Log::print("| %6zu | %8" PRId64 " | %7s | %7s | %7s |",
+             const char *h10s = Hashrate::format(m_hashrate->calc(thread->index(), Hashrate::ShortInterval),  num1, sizeof num1);
+             const char *h60s = Hashrate::format(m_hashrate->calc(thread->index(), Hashrate::MediumInterval), num2, sizeof num2);
+             const char *h15m = Hashrate::format(m_hashrate->calc(thread->index(), Hashrate::LargeInterval),  num3, sizeof num3);
+
+             if (!counters) {
+                 xlarig::Log::print("| %6zu | %8" PRId64 " | %7s | %7s | %7s |", thread->index(), thread->affinity(), h10s, h60s, h15m);
+                 continue;
+             }
+
+             const xlarig::PerfCounters::Sample sample = perf(thread->index());
+             char ipc[8]  = { 0 };
+             char llc[8]  = { 0 };
+             char dtlb[8] = { 0 };
+             char l2[8]   = { 0 };
+
+             xlarig::Log::print("| %6zu | %8" PRId64 " | %7s | %7s | %7s | %4s | %5s | %5s | %5s |",
                             thread->index(),
                             thread->affinity(),
-                            Hashrate::format(m_hashrate->calc(thread->index(), Hashrate::ShortInterval),  num1, sizeof num1),
-                            Hashrate::format(m_hashrate->calc(thread->index(), Hashrate::MediumInterval), num2, sizeof num2),
-                            Hashrate::format(m_hashrate->calc(thread->index(), Hashrate::LargeInterval),  num3, sizeof num3)
+                            h10s, h60s, h15m,
+                            xlarig::PerfCounters::format(sample.ipc,  ipc,  sizeof ipc),
+                            xlarig::PerfCounters::format(sample.llc,  llc,  sizeof llc),
+                            xlarig::PerfCounters::format(sample.dtlb, dtlb, sizeof dtlb),
+                            xlarig::PerfCounters::format(sample.l2,   l2,   sizeof l2)
                             );
-
-             i++;
         }
     }
 
@@ -131,6 +216,74 @@ void Workers::printHashrate(bool detail)
 }
 
 
+/**
+ * Apply a new thread list from a reloaded config without a full restart, threads with the same
+ * algorithm, multiway and AES mode keep running (and keep their scratchpads and VMs), only their
+ * affinity and priority are updated. Entries of the replaced config are deleted once no worker uses them.
+ */
+void Workers::reconfigure(const std::vector<xlarig::IThread *> &threads, std::vector<xlarig::IThread *> &&retired)
+{
+    m_retired.insert(m_retired.end(), retired.begin(), retired.end());
+
+    if (m_autotune && !m_autotune->isDone()) {
+        LOG_WARN("threads change ignored, autotune is running");
+        return;
+    }
+
+    m_layout      = threads;
+    m_reconfigure = !applyLayout();
+}
+
+
+/**
+ * Replace all running threads, called from the main loop only. Workers are stopped through the
+ * same zero sequence used by stop() and the previous job and pause state are restored afterwards.
+ */
+void Workers::restart(const std::vector<xlarig::IThread *> &threads)
+{
+    const int paused        = m_paused.load();
+    const uint64_t sequence = m_sequence.load();
+
+    m_paused   = 0;
+    m_sequence = 0;
+    notify();
+
+    for (ThreadHandle *handle : m_workers) {
+        handle->join();
+
+        delete handle->worker();
+        delete handle;
+    }
+
+    m_workers.clear();
+    releaseRetired();
+
+#   ifdef XMRIG_ALGO_RANDOMX
+    if (m_rx_dataset_init_thread_counter.load() != 0) {
+        // dataset initialization was interrupted, force it to run again with the new threads
+        memset(m_rx_seed_hash, 0, sizeof(m_rx_seed_hash));
+        m_rx_dataset_init_thread_counter = 0;
+        m_rx_dataset_started             = false;
+        m_rx_dataset_slice               = 0;
+    }
+#   endif
+
+    delete m_hashrate;
+
+    uv_mutex_lock(&m_mutex);
+    m_status.hugePages = 0;
+    m_status.pages     = 0;
+    m_status.started   = 0;
+    uv_mutex_unlock(&m_mutex);
+
+    m_sequence    = sequence + 1;
+    m_paused      = paused;
+    m_reconfigure = false;
+
+    spawn(threads);
+}
+
+
 void Workers::setEnabled(bool enabled)
 {
     if (m_enabled == enabled) {
@@ -138,32 +291,61 @@ void Workers::setEnabled(bool enabled)
     }
 
     m_enabled = enabled;
-    if (!m_active) {
+    if (!m_active || m_asmBench) {
         return;
     }
 
     m_paused = enabled ? 0 : 1;
     m_sequence++;
+    notify();
+}
+
+
+/**
+ * Shares stay valid across vardiff and template refreshes, the pool only rejects them once the chain moved.
+ */
+static bool isSameChain(const xlarig::Job &a, const xlarig::Job &b)
+{
+    return a.poolId() == b.poolId() && a.height() == b.height() && memcmp(a.seedHash(), b.seedHash(), 32) == 0;
 }
 
 
 void Workers::setJob(const xlarig::Job &job, bool donate)
 {
+    xlarig::Job next = job;
+    if (donate) {
+        next.setPoolId(-1);
+    }
+
     uv_rwlock_wrlock(&m_rwlock);
-    m_job = job;
+    const bool moved = !isSameChain(m_job, next);
+    const bool purge = moved && m_job.poolId() == next.poolId();
 
-    if (donate) {
-        m_job.setPoolId(-1);
+    m_job = next;
+
+    // unlike the sequence, only bumped when the chain moves, pause, reconfigure and new templates keep shares valid
+    if (moved) {
+        m_generation.fetch_add(1, std::memory_order_release);
+    }
+
+    // still under the job lock, no worker can queue a share for the new job yet
+    if (purge) {
+        dropStale(next.poolId());
     }
     uv_rwlock_wrunlock(&m_rwlock);
 
+#   ifndef XMRIG_NO_ASM
+    xlarig::CnrCodeCache::prefetch(job.algorithm().variant(), job.height());
+#   endif
+
     m_active = true;
-    if (!m_enabled) {
+    if (!m_enabled || m_asmBench) {
         return;
     }
 
-    m_sequence++;
     m_paused = 0;
+    m_sequence++;
+    notify();
 }
 
 
@@ -178,23 +360,25 @@ void Workers::start(xlarig::Controller *controller)
 #   endif
 
 #   ifndef XMRIG_NO_ASM
-    xlarig::CpuThread::patchAsmVariants();
+    xlarig::CnHash::patchAsmVariants();
+    m_asmBench = xlarig::AsmBench::start(controller, Workers::onAsmBench);
 #   endif
 
     m_controller = controller;
 
-    const std::vector<xlarig::IThread *> &threads = controller->config()->threads();
-    m_status.algo    = controller->config()->algorithm().algo();
-    m_status.variant = controller->config()->algorithm().variant();
-    m_status.threads = threads.size();
-
-    for (const xlarig::IThread *thread : threads) {
-       m_status.ways += thread->multiway();
+    // thread arenas are sized for the biggest scratchpad any configured pool may ask for
+    Mem::reserve(controller->config()->algorithm());
+    for (const xlarig::Pool &pool : controller->config()->pools().data()) {
+        Mem::reserve(pool.algorithm());
     }
 
-    m_hashrate = new Hashrate(threads.size(), controller);
+    if (controller->config()->isAutotune()) {
+        m_autotune = new xlarig::Autotune(controller);
+    }
 
     uv_mutex_init(&m_mutex);
+    uv_mutex_init(&m_parkMutex);
+    uv_cond_init(&m_parkCond);
     uv_rwlock_init(&m_rwlock);
 
 #   ifdef XMRIG_ALGO_RANDOMX
@@ -211,15 +395,9 @@ void Workers::start(xlarig::Controller *controller)
     uv_timer_init(uv_default_loop(), m_timer);
     uv_timer_start(m_timer, Workers::onTick, 500, 500);
 
-    uint32_t offset = 0;
-
-    for (xlarig::IThread *thread : threads) {
-        ThreadHandle *handle = new ThreadHandle(thread, offset, m_status.ways);
-        offset += thread->multiway();
+    xlarig::PerfCounters::init(controller->config()->isPerfCounters());
 
-        m_workers.push_back(handle);
-        handle->start(Workers::onReady);
-    }
+    spawn(controller->config()->threads());
 }
 
 
@@ -231,10 +409,16 @@ void Workers::stop()
 
     m_paused   = 0;
     m_sequence = 0;
+    notify();
 
     for (size_t i = 0; i < m_workers.size(); ++i) {
         m_workers[i]->join();
     }
+
+    releaseRetired();
+
+    delete m_autotune;
+    m_autotune = nullptr;
 }
 
 
@@ -268,42 +452,215 @@ void Workers::threadsSummary(rapidjson::Document &doc)
 #endif
 
 
-void Workers::onReady(void *arg)
+static bool isCompatible(const xlarig::IThread *running, const xlarig::IThread *thread)
 {
-    auto handle = static_cast<ThreadHandle*>(arg);
+    const auto a = static_cast<const xlarig::CpuThread *>(running);
+    const auto b = static_cast<const xlarig::CpuThread *>(thread);
+
+    // an unpinned thread can be pinned in place, but not the other way around
+    return a->algorithm() == b->algorithm() &&
+           a->multiway()  == b->multiway()  &&
+           a->isSoftAES() == b->isSoftAES() &&
+           (b->affinity() != -1L || a->affinity() == -1L);
+}
+
+
+bool Workers::applyLayout()
+{
+    const std::vector<xlarig::IThread *> &threads = m_layout;
+    const xlarig::Job job = Workers::job();
 
-    IWorker *worker = nullptr;
+    size_t ways = 0;
+    for (const xlarig::IThread *thread : threads) {
+        ways += thread->multiway();
+    }
 
-    switch (handle->config()->multiway()) {
-    case 1:
-        worker = new MultiWorker<1>(handle);
-        break;
+#   ifdef XMRIG_ALGO_RANDOMX
+    uv_rwlock_wrlock(&m_rx_dataset_lock);
+    if (m_rx_dataset_init_thread_counter.load() != 0) {
+        // dataset is being rebuilt, try again on next tick
+        uv_rwlock_wrunlock(&m_rx_dataset_lock);
+        return false;
+    }
+#   endif
+
+    std::vector<ThreadHandle *> stopped;
+    uint32_t failed = 0;
+    size_t repinned = 0;
 
-    case 2:
-        worker = new MultiWorker<2>(handle);
-        break;
+    for (size_t i = 0; i < m_workers.size(); ++i) {
+        ThreadHandle *handle = m_workers[i];
 
-    case 3:
-        worker = new MultiWorker<3>(handle);
-        break;
+        if (i < threads.size() && isCompatible(handle->config(), threads[i])) {
+            if (handle->config()->affinity() != threads[i]->affinity()) {
+                repinned++;
+            }
 
-    case 4:
-        worker = new MultiWorker<4>(handle);
-        break;
+            handle->setConfig(threads[i]);
+            failed += handle->isFailed() ? 1 : 0;
 
-    case 5:
-        worker = new MultiWorker<5>(handle);
-        break;
+            continue;
+        }
+
+        handle->stop();
+        stopped.push_back(handle);
+    }
+
+#   ifdef XMRIG_ALGO_RANDOMX
+    m_rx_dataset_threads = static_cast<uint32_t>(threads.size()) - failed;
+    uv_rwlock_wrunlock(&m_rx_dataset_lock);
+#   endif
+
+    // wake up every worker, kept ones pick up the new config, stopped ones exit
+    if (m_sequence.load() > 0) {
+        m_sequence++;
+    }
 
-    default:
-        break;
+    notify();
+
+    for (ThreadHandle *handle : stopped) {
+        handle->join();
+    }
+
+    uv_mutex_lock(&m_mutex);
+    for (ThreadHandle *handle : stopped) {
+        if (handle->isReady()) {
+            const Worker *worker = static_cast<const Worker *>(handle->worker());
+
+            m_status.pages     -= worker->memory().pages;
+            m_status.hugePages -= worker->memory().hugePages;
+            m_status.started--;
+        }
+
+        delete handle->worker();
+        delete handle;
+    }
+
+    m_status.threads = threads.size();
+    m_status.ways    = ways;
+    uv_mutex_unlock(&m_mutex);
+
+    if (m_hashrate->threads() != threads.size()) {
+        delete m_hashrate;
+        m_hashrate = new Hashrate(threads.size(), m_controller);
+    }
+
+    std::vector<ThreadHandle *> workers(threads.size(), nullptr);
+    for (ThreadHandle *handle : m_workers) {
+        if (!handle->isStopping()) {
+            workers[handle->threadId()] = handle;
+        }
     }
 
+    m_workers = std::move(workers);
+
+    uint32_t offset = 0;
+    size_t spawned  = 0;
+
+    for (size_t i = 0; i < m_workers.size(); ++i) {
+        if (m_workers[i]) {
+            // running threads switch to the new nonce range on the next job
+            m_workers[i]->setLayout(offset, ways);
+        }
+        else {
+            m_workers[i] = new ThreadHandle(threads[i], offset, ways);
+            m_workers[i]->setDeferred(job);
+            m_workers[i]->start(Workers::onReady);
+
+            spawned++;
+        }
+
+        offset += threads[i]->multiway();
+    }
+
+    if (spawned || repinned || !stopped.empty()) {
+        LOG_INFO(WHITE_BOLD("threads") " reconfigured, started " CYAN_BOLD("%zu") " stopped " CYAN_BOLD("%zu") " re-pinned " CYAN_BOLD("%zu") " running " CYAN_BOLD("%zu(%zu)"),
+                 spawned, stopped.size(), repinned, threads.size(), ways);
+    }
+
+    return true;
+}
+
+
+/**
+ * Wake up parked workers, must be called after m_sequence is changed. Taking the mutex here closes
+ * the window between a worker reading the sequence and going to sleep.
+ */
+void Workers::notify()
+{
+    uv_mutex_lock(&m_parkMutex);
+    uv_cond_broadcast(&m_parkCond);
+    uv_mutex_unlock(&m_parkMutex);
+}
+
+
+/**
+ * A retired entry stays in use until its handle is joined or its worker has switched to the new one.
+ */
+bool Workers::isRetiredInUse()
+{
+    for (const ThreadHandle *handle : m_workers) {
+        if (std::find(m_retired.begin(), m_retired.end(), handle->config()) != m_retired.end() ||
+            std::find(m_retired.begin(), m_retired.end(), handle->active()) != m_retired.end()) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+/**
+ * Must be called only when no worker is running or isRetiredInUse() is false.
+ */
+void Workers::releaseRetired()
+{
+    for (xlarig::IThread *thread : m_retired) {
+        delete thread;
+    }
+
+    m_retired.clear();
+}
+
+
+template<size_t N>
+static IWorker *createWorker(ThreadHandle *handle, size_t ways)
+{
+    return ways == N ? new MultiWorker<N>(handle) : createWorker<N - 1>(handle, ways);
+}
+
+
+template<>
+IWorker *createWorker<0>(ThreadHandle *, size_t)
+{
+    return nullptr;
+}
+
+
+void Workers::onReady(void *arg)
+{
+    auto handle = static_cast<ThreadHandle*>(arg);
+
+    IWorker *worker = createWorker<xlarig::IThread::MaxWay>(handle, handle->config()->multiway());
+
     handle->setWorker(worker);
 
     if (!worker->selfTest()) {
         LOG_ERR("thread %zu error: \"hash self-test failed\".", handle->worker()->id());
 
+#       ifdef XMRIG_ALGO_RANDOMX
+        // the thread never hashes, the dataset barrier must not wait for it
+        uv_rwlock_wrlock(&m_rx_dataset_lock);
+        handle->setFailed();
+
+        if (!handle->isStopping()) {
+            m_rx_dataset_threads--;
+        }
+        uv_rwlock_wrunlock(&m_rx_dataset_lock);
+#       else
+        handle->setFailed();
+#       endif
+
         return;
     }
 
@@ -311,6 +668,43 @@ void Workers::onReady(void *arg)
 }
 
 
+/**
+ * Workers stay paused while the asm benchmark runs so they pick its choice with their first job
+ * and do not disturb the measurement.
+ */
+void Workers::onAsmBench()
+{
+    m_asmBench = false;
+
+    if (!m_active || !m_enabled || m_sequence.load() == 0) {
+        return;
+    }
+
+    m_paused = 0;
+    m_sequence++;
+    notify();
+}
+
+
+/**
+ * Results of the pool queued before its chain moved, they would only be rejected as stale.
+ */
+void Workers::dropStale(int poolId)
+{
+    uv_mutex_lock(&m_mutex);
+    for (auto it = m_queue.begin(); it != m_queue.end();) {
+        if (it->poolId != poolId) {
+            ++it;
+            continue;
+        }
+
+        addStale();
+        it = m_queue.erase(it);
+    }
+    uv_mutex_unlock(&m_mutex);
+}
+
+
 void Workers::onResult(uv_async_t *)
 {
     std::list<xlarig::JobResult> results;
@@ -332,6 +726,14 @@ void Workers::onResult(uv_async_t *)
 
 void Workers::onTick(uv_timer_t *)
 {
+    if (m_reconfigure) {
+        m_reconfigure = !applyLayout();
+    }
+
+    if (!m_retired.empty() && !isRetiredInUse()) {
+        releaseRetired();
+    }
+
     for (ThreadHandle *handle : m_workers) {
         if (!handle->worker()) {
             return;
@@ -343,12 +745,48 @@ void Workers::onTick(uv_timer_t *)
     if ((m_ticks++ & 0xF) == 0)  {
         m_hashrate->updateHighest();
     }
+
+    if (m_autotune) {
+        m_autotune->tick();
+    }
+}
+
+
+void Workers::spawn(const std::vector<xlarig::IThread *> &threads)
+{
+    uv_mutex_lock(&m_mutex);
+    m_status.algo    = m_controller->config()->algorithm().algo();
+    m_status.variant = m_controller->config()->algorithm().variant();
+    m_status.threads = threads.size();
+    m_status.ways    = 0;
+
+    for (const xlarig::IThread *thread : threads) {
+       m_status.ways += thread->multiway();
+    }
+    uv_mutex_unlock(&m_mutex);
+
+#   ifdef XMRIG_ALGO_RANDOMX
+    m_rx_dataset_threads = static_cast<uint32_t>(threads.size());
+#   endif
+
+    m_hashrate = new Hashrate(threads.size(), m_controller);
+
+    uint32_t offset = 0;
+
+    for (xlarig::IThread *thread : threads) {
+        ThreadHandle *handle = new ThreadHandle(thread, offset, m_status.ways);
+        offset += thread->multiway();
+
+        m_workers.push_back(handle);
+        handle->start(Workers::onReady);
+    }
 }
 
 
 void Workers::start(IWorker *worker)
 {
     const Worker *w = static_cast<const Worker *>(worker);
+    w->handle()->setReady();
 
     uv_mutex_lock(&m_mutex);
     m_status.started++;
@@ -380,23 +818,65 @@ void Workers::start(IWorker *worker)
 
 
 #ifdef XMRIG_ALGO_RANDOMX
-void Workers::updateDataset(const uint8_t* seed_hash, const uint32_t num_threads)
+/**
+ * Every thread that can reach this point registers, the dataset is split once all of them are here.
+ * Until then a thread may leave again when its job is replaced, afterwards it must take its slice.
+ */
+bool Workers::updateDataset(const uint8_t* seed_hash, const ThreadHandle *handle, uint64_t sequence)
 {
     // Check if we need to update cache and dataset
     if (memcmp(m_rx_seed_hash, seed_hash, sizeof(m_rx_seed_hash)) == 0)
-        return;
+        return true;
 
-    const uint32_t thread_id = m_rx_dataset_init_thread_counter++;
-    LOG_DEBUG("Thread %u started updating RandomX dataset", thread_id);
+    // Threads removed by reconfigure() must not join, the barrier below counts the new layout
+    uv_rwlock_wrlock(&m_rx_dataset_lock);
+    if (handle->isStopping()) {
+        uv_rwlock_wrunlock(&m_rx_dataset_lock);
+        return false;
+    }
 
-    // Wait for all threads to get here
-    do {
-        if (m_sequence.load(std::memory_order_relaxed) == 0) {
-            // Exit immediately if workers were stopped
-            return;
+    // too late to take a slice, wait for the running update and check the seed again
+    if (m_rx_dataset_started.load()) {
+        uv_rwlock_wrunlock(&m_rx_dataset_lock);
+
+        while (m_rx_dataset_init_thread_counter.load() != 0 && m_sequence.load(std::memory_order_relaxed) != 0 && !isOutdated(sequence)) {
+            std::this_thread::yield();
         }
+
+        return false;
+    }
+
+    m_rx_dataset_init_thread_counter++;
+    uv_rwlock_wrunlock(&m_rx_dataset_lock);
+
+    // Wait for all threads to get here, threads that failed their self-test are not counted
+    while (!m_rx_dataset_started.load()) {
+        const bool outdated = m_sequence.load(std::memory_order_relaxed) == 0 || isOutdated(sequence);
+
+        if (outdated || m_rx_dataset_init_thread_counter.load() >= m_rx_dataset_threads.load()) {
+            uv_rwlock_wrlock(&m_rx_dataset_lock);
+            if (!m_rx_dataset_started.load()) {
+                if (outdated) {
+                    m_rx_dataset_init_thread_counter--;
+                    uv_rwlock_wrunlock(&m_rx_dataset_lock);
+                    return false;
+                }
+
+                m_rx_dataset_parts   = m_rx_dataset_init_thread_counter.load();
+                m_rx_dataset_started = true;
+            }
+            uv_rwlock_wrunlock(&m_rx_dataset_lock);
+            break;
+        }
+
         std::this_thread::yield();
-    } while (m_rx_dataset_init_thread_counter.load() != num_threads);
+    }
+
+    // slices are numbered once the barrier is passed, threads that left in between leave no gaps
+    const uint32_t thread_id   = m_rx_dataset_slice++;
+    const uint32_t num_threads = m_rx_dataset_parts;
+
+    LOG_DEBUG("Thread %u started updating RandomX dataset", thread_id);
 
     // One of the threads updates cache
     uv_rwlock_wrlock(&m_rx_dataset_lock);
@@ -413,15 +893,23 @@ void Workers::updateDataset(const uint8_t* seed_hash, const uint32_t num_threads
 
     LOG_DEBUG("Thread %u finished updating RandomX dataset", thread_id);
 
-    // Wait for all threads to complete
-    --m_rx_dataset_init_thread_counter;
+    // Wait for all threads to complete, every registered thread finishes its slice so this can't hang
+    uv_rwlock_wrlock(&m_rx_dataset_lock);
+    if (--m_rx_dataset_init_thread_counter == 0) {
+        m_rx_dataset_started = false;
+        m_rx_dataset_slice   = 0;
+    }
+    uv_rwlock_wrunlock(&m_rx_dataset_lock);
+
     do {
         if (m_sequence.load(std::memory_order_relaxed) == 0) {
             // Exit immediately if workers were stopped
-            return;
+            return false;
         }
         std::this_thread::yield();
     } while (m_rx_dataset_init_thread_counter.load() != 0);
+
+    return true;
 }
 
 defyx_dataset* Workers::getDataset()
@@ -37,6 +37,7 @@
 
 #include "base/net/stratum/Job.h"
 #include "net/JobResult.h"
+#include "workers/PerfCounters.h"
 #include "rapidjson/fwd.h"
 
 
@@ -46,8 +47,10 @@ class ThreadHandle;
 
 
 namespace xlarig {
+    class Autotune;
     class Controller;
     class IJobResultListener;
+    class IThread;
 }
 
 
@@ -57,7 +60,12 @@ public:
     static xlarig::Job job();
     static size_t hugePages();
     static size_t threads();
+    static std::vector<xlarig::IThread *> threadsList();
+    static void park(uint64_t sequence);
+    static xlarig::PerfCounters::Sample perf(size_t threadId);
     static void printHashrate(bool detail);
+    static void reconfigure(const std::vector<xlarig::IThread *> &threads, std::vector<xlarig::IThread *> &&retired);
+    static void restart(const std::vector<xlarig::IThread *> &threads);
     static void setEnabled(bool enabled);
     static void setJob(const xlarig::Job &job, bool donate);
     static void start(xlarig::Controller *controller);
@@ -65,9 +73,15 @@ public:
     static void submit(const xlarig::JobResult &result);
 
     static inline bool isEnabled()                                      { return m_enabled; }
+    static inline uint64_t cancelled()                                  { return m_cancelled.load(std::memory_order_relaxed); }
+    static inline uint64_t stale()                                      { return m_stale.load(std::memory_order_relaxed); }
+    static inline void addCancelled()                                   { m_cancelled.fetch_add(1, std::memory_order_relaxed); }
+    static inline void addStale()                                       { m_stale.fetch_add(1, std::memory_order_relaxed); }
+    static inline bool isJobOutdated(uint64_t generation)               { return m_generation.load(std::memory_order_relaxed) != generation; }
     static inline bool isOutdated(uint64_t sequence)                    { return m_sequence.load(std::memory_order_relaxed) != sequence; }
     static inline bool isPaused()                                       { return m_paused.load(std::memory_order_relaxed) == 1; }
     static inline Hashrate *hashrate()                                  { return m_hashrate; }
+    static inline uint64_t generation()                                 { return m_generation.load(std::memory_order_acquire); }
     static inline uint64_t sequence()                                   { return m_sequence.load(std::memory_order_relaxed); }
     static inline void pause()                                          { m_active = false; m_paused = 1; m_sequence++; }
     static inline void setListener(xlarig::IJobResultListener *listener) { m_listener = listener; }
@@ -77,14 +91,21 @@ public:
 #   endif
 
 #   ifdef XMRIG_ALGO_RANDOMX
-    static void updateDataset(const uint8_t* seed_hash, uint32_t num_threads);
+    static bool updateDataset(const uint8_t* seed_hash, const ThreadHandle *handle, uint64_t sequence);
     static defyx_dataset* getDataset();
 #   endif
 
 private:
+    static bool applyLayout();
+    static bool isRetiredInUse();
+    static void dropStale(int poolId);
+    static void onAsmBench();
     static void onReady(void *arg);
     static void onResult(uv_async_t *handle);
     static void onTick(uv_timer_t *handle);
+    static void notify();
+    static void releaseRetired();
+    static void spawn(const std::vector<xlarig::IThread *> &threads);
     static void start(IWorker *worker);
 
     class LaunchStatus
@@ -110,18 +131,28 @@ private:
     };
 
     static bool m_active;
+    static bool m_asmBench;
+    static bool m_reconfigure;
+    static xlarig::Autotune *m_autotune;
     static bool m_enabled;
     static Hashrate *m_hashrate;
     static xlarig::IJobResultListener *m_listener;
     static xlarig::Job m_job;
     static LaunchStatus m_status;
     static std::atomic<int> m_paused;
+    static std::atomic<uint64_t> m_cancelled;
+    static std::atomic<uint64_t> m_generation;
     static std::atomic<uint64_t> m_sequence;
+    static std::atomic<uint64_t> m_stale;
     static std::list<xlarig::JobResult> m_queue;
     static std::vector<ThreadHandle*> m_workers;
+    static std::vector<xlarig::IThread *> m_layout;
+    static std::vector<xlarig::IThread *> m_retired;
     static uint64_t m_ticks;
     static uv_async_t *m_async;
+    static uv_cond_t m_parkCond;
     static uv_mutex_t m_mutex;
+    static uv_mutex_t m_parkMutex;
     static uv_rwlock_t m_rwlock;
     static uv_timer_t *m_timer;
     static xlarig::Controller *m_controller;
@@ -131,7 +162,11 @@ private:
     static defyx_cache *m_rx_cache;
     static defyx_dataset *m_rx_dataset;
     static uint8_t m_rx_seed_hash[32];
+    static std::atomic<bool> m_rx_dataset_started;
     static std::atomic<uint32_t> m_rx_dataset_init_thread_counter;
+    static std::atomic<uint32_t> m_rx_dataset_slice;
+    static std::atomic<uint32_t> m_rx_dataset_threads;
+    static uint32_t m_rx_dataset_parts;
 #   endif
 };
 